@@ -0,0 +1,45 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_BENCHMARK_SRC_BENCHMARKS_H_
+#define NCSTREAMER_REMOTE_BENCHMARK_SRC_BENCHMARKS_H_
+
+
+#include <cstdint>
+
+
+namespace ncstreamer_remote_benchmark {
+/// Many clients against one stand-in server,
+/// on one shared executor and then on a thread each.
+void RunScalingBenchmark(uint32_t clients, uint32_t requests_per_client);
+
+/// The cost of the log per line on the writing thread,
+/// off and written synchronously and asynchronously,
+/// and per round trip of a client against a stand-in server.
+void RunLogBenchmark(uint32_t lines, uint32_t requests);
+
+/// Round trips over the loopback TCP to a stand-in server,
+/// of a status and of comments responses of growing sizes.
+void RunLoopbackBenchmark(uint32_t requests);
+
+/// Comments pushed by a stand-in server to a subscribed client,
+/// one at a time for the wake latency and all at once for the rate.
+void RunPushBenchmark(uint32_t comments);
+
+/// Status round trips to a stand-in server while comments dumps go on,
+/// on the first connection and then on the bulk connection.
+void RunBulkLoadBenchmark(uint32_t requests);
+
+/// The comment filter scanning comments against growing rule sets,
+/// and a search per rule for comparison.
+void RunFilterBenchmark(uint32_t comments);
+
+/// Responses of `comments` comments each, handed over as a string
+/// for the caller to parse, and decoded into records by the library.
+void RunDecodeBenchmark(uint32_t comments);
+}  // namespace ncstreamer_remote_benchmark
+
+
+#endif  // NCSTREAMER_REMOTE_BENCHMARK_SRC_BENCHMARKS_H_
@@ -0,0 +1,176 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <future>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "ncstreamer_remote_benchmark/src/benchmarks.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/error/error_types.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/ncstreamer_remote.h"
+#include "ncstreamer_remote_test/src/stand_in_server.h"
+#include "ncstreamer_remote_test/src/test_memory_resource.h"
+
+
+namespace {
+using ncstreamer_remote::CommentRecords;
+using ncstreamer_remote::Error;
+using ncstreamer_remote::ErrorCategory;
+using ncstreamer_remote::NcStreamerRemote;
+using ncstreamer_remote_test::StandInComment;
+using ncstreamer_remote_test::StandInServer;
+using ncstreamer_remote_test::TestMemoryResource;
+
+
+const uint16_t kStandInPort{9109};
+const uint32_t kLoadComments{5000};
+
+
+uint64_t GetSteadyMicroseconds() {
+  const auto &now = Chrono::duration_cast<Chrono::microseconds>(
+      Chrono::steady_clock::now().time_since_epoch());
+  return static_cast<uint64_t>(now.count());
+}
+
+
+uint32_t ToPercentile(const std::vector<uint32_t> &sorted, double p) {
+  if (sorted.empty() == true) {
+    return 0;
+  }
+  const std::size_t i = static_cast<std::size_t>(p * (sorted.size() - 1));
+  return sorted[i];
+}
+
+
+/// @return 0 on success, or else the error code.
+int RequestStatus(NcStreamerRemote *remote) {
+  auto responded = std::make_shared<std::promise<int>>();
+  remote->RequestStatus([responded](
+      ErrorCategory /*err_category*/,
+      int err_code,
+      const std::wstring &/*err_msg*/) {
+    responded->set_value(err_code == 0 ? -1 : err_code);
+  }, [responded](
+      const std::wstring &/*status*/,
+      const std::wstring &/*source_title*/,
+      const std::wstring &/*user_name*/,
+      const std::wstring &/*quality*/) {
+    responded->set_value(0);
+  });
+  return responded->get_future().get();
+}
+
+
+/// Every comment of the stand-in server, one dump after another.
+void LoadComments(NcStreamerRemote *remote, const std::atomic_bool *done) {
+  while (*done == false) {
+    auto responded = std::make_shared<std::promise<void>>();
+    remote->RequestCommentRecords(L"", [responded](
+        ErrorCategory /*err_category*/,
+        int /*err_code*/,
+        const std::wstring &/*err_msg*/) {
+      responded->set_value();
+    }, [responded](const CommentRecords &/*comments*/) {
+      responded->set_value();
+    });
+    responded->get_future().get();
+  }
+}
+
+
+void AddComments(StandInServer *server, uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    char created_time[32];
+    std::snprintf(created_time, sizeof(created_time),
+        "2017-06-01T%02u:%02u:%02u+0000",
+        (i / 3600) % 24, (i / 60) % 60, i % 60);
+    server->AddComment(StandInComment{
+        std::to_string(i),
+        "viewer" + std::to_string(i % 50),
+        "a comment of some ordinary length, number " + std::to_string(i),
+        created_time});
+  }
+}
+
+
+/// Status round trips, while comments dumps go on unless `loaded` is false.
+void RunStatusRoundTrips(
+    const char *name,
+    uint32_t requests,
+    bool loaded,
+    bool bulk_connection) {
+  TestMemoryResource memory_resource;
+  NcStreamerRemote *remote = NcStreamerRemote::Create(
+      kStandInPort, &memory_resource, nullptr, "");
+  remote->SetBulkConnection(bulk_connection);
+  RequestStatus(remote);  // connects.
+
+  std::atomic_bool done{false};
+  std::thread load;
+  if (loaded == true) {
+    load = std::thread{[remote, &done]() {
+      LoadComments(remote, &done);
+    }};
+    // for the bulk connection to open, and the dumps to get going.
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+  }
+
+  std::vector<uint32_t> latencies;
+  latencies.reserve(requests);
+  uint32_t busy{0};
+  uint32_t errors{0};
+  for (uint32_t i = 0; i < requests; ++i) {
+    const uint64_t requested_us = GetSteadyMicroseconds();
+    const int err_code = RequestStatus(remote);
+    if (err_code == static_cast<int>(Error::Connection::kBusy)) {
+      ++busy;
+      continue;
+    }
+    if (err_code != 0) {
+      ++errors;
+      continue;
+    }
+    latencies.emplace_back(
+        static_cast<uint32_t>(GetSteadyMicroseconds() - requested_us));
+  }
+  done = true;
+  if (load.joinable() == true) {
+    load.join();
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  std::cout << "  " << name << ": p50 "
+            << ToPercentile(latencies, 0.5) << " us, p99 "
+            << ToPercentile(latencies, 0.99) << " us, busy "
+            << busy << ", errors " << errors << std::endl;
+
+  NcStreamerRemote::Destroy(remote);
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_benchmark {
+void RunBulkLoadBenchmark(uint32_t requests) {
+  StandInServer server{kStandInPort};
+  if (server.is_listening() == false) {
+    std::cerr << "port " << kStandInPort << " taken." << std::endl;
+    return;
+  }
+  AddComments(&server, kLoadComments);
+
+  std::cout << "status round trips against dumps of " << kLoadComments
+            << " comments, " << requests << " requests:" << std::endl;
+  RunStatusRoundTrips("unloaded", requests, false, false);
+  RunStatusRoundTrips("loaded, one connection", requests, true, false);
+  RunStatusRoundTrips("loaded, bulk connection", requests, true, true);
+}
+}  // namespace ncstreamer_remote_benchmark
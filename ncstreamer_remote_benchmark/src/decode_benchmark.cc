@@ -0,0 +1,192 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <algorithm>
+#include <codecvt>
+#include <cstdio>
+#include <cwchar>
+#include <functional>
+#include <iostream>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "boost/property_tree/json_parser.hpp"
+#include "boost/property_tree/ptree.hpp"
+
+#include "ncstreamer_remote_benchmark/src/benchmarks.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/chat_analytics.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_records.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_store.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/memory/memory_resource.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/ncstreamer_remote.h"
+#include "ncstreamer_remote_dll/src/comment/comment_decoder.h"
+#include "ncstreamer_remote_test/src/test_memory_resource.h"
+
+
+namespace {
+using ncstreamer_remote::ChatAnalytics;
+using ncstreamer_remote::CommentDecoder;
+using ncstreamer_remote::CommentRecord;
+using ncstreamer_remote::CommentRecords;
+using ncstreamer_remote::CommentStore;
+using ncstreamer_remote::MonotonicBufferResource;
+using ncstreamer_remote::ScopedMemoryResource;
+using ncstreamer_remote_test::TestMemoryResource;
+
+
+/// Responses decoded each way, of comments new in each,
+/// as polling brings them.
+const uint32_t kResponses{50};
+/// As the client keeps them.
+const std::size_t kStoreCapacity{1000};
+
+
+uint64_t GetSteadyNanoseconds() {
+  const auto &now = Chrono::duration_cast<Chrono::nanoseconds>(
+      Chrono::steady_clock::now().time_since_epoch());
+  return static_cast<uint64_t>(now.count());
+}
+
+
+/// The comments of a response as NCStreamer passes them through,
+/// of UTF-8 with a Hangul word in each.
+std::string NewComments(uint32_t count, uint32_t first) {
+  std::string comments{"{\"data\":["};
+  for (uint32_t i = first; i < first + count; ++i) {
+    char created_time[32];
+    std::snprintf(created_time, sizeof(created_time),
+        "2017-06-01T%02u:%02u:%02u+0000",
+        (i / 3600) % 24, (i / 60) % 60, i % 60);
+    if (i != first) {
+      comments += ",";
+    }
+    comments += "{\"id\":\"" + std::to_string(i) + "\","
+        "\"created_time\":\"" + created_time + "\","
+        "\"message\":\"\xEC\x95\x88\xEB\x85\x95 a comment of some "
+        "ordinary length, number " + std::to_string(i) + "\","
+        "\"from\":{\"name\":\"viewer" + std::to_string(i % 50) + "\"}}";
+  }
+  comments += "]}";
+  return comments;
+}
+
+
+/// As of today's hand-off: the library widens the whole list
+/// for the handler, which parses it again to get at the fields.
+/// @return The characters of the fields, for the work not to be elided.
+std::size_t HandOff(const std::string &comments) {
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  const std::wstring &msg = converter.from_bytes(comments);
+
+  boost::property_tree::wptree tree;
+  std::wistringstream ss{msg};
+  boost::property_tree::read_json(ss, tree);
+  std::size_t chars{0};
+  for (const auto &comment : tree.get_child(L"data")) {
+    chars += comment.second.get<std::wstring>(L"id").size();
+    chars += comment.second.get<std::wstring>(L"from.name").size();
+    chars += comment.second.get<std::wstring>(L"message").size();
+    chars += comment.second.get<std::wstring>(L"created_time").size();
+  }
+  return chars;
+}
+
+
+/// As the library decodes into the arena of the inbound message,
+/// storing the comments as well if `store` isn't null.
+std::size_t DecodeRecords(
+    const std::string &comments,
+    MonotonicBufferResource *arena,
+    CommentStore *store,
+    ChatAnalytics *analytics) {
+  std::size_t chars{0};
+  {
+    ScopedMemoryResource arena_scope{arena};
+    CommentRecords records;
+    CommentDecoder::Decode(
+        comments.data(), comments.size(), nullptr, &records);
+    if (store) {
+      store->Add(records, [analytics](const CommentRecord &record) {
+        analytics->Add(0, record);
+      });
+    }
+    for (const CommentRecord &record : records) {
+      chars += std::wcslen(record.id);
+      chars += std::wcslen(record.author);
+      chars += std::wcslen(record.text);
+      chars += std::wcslen(record.created_time);
+    }
+  }
+  arena->Release();
+  return chars;
+}
+
+
+/// Decodes every response but the first, which only warms up,
+/// and prints the median and fastest of them.
+/// @return The characters of the fields of all the responses.
+std::size_t Run(
+    const char *name,
+    const std::vector<std::string> &responses,
+    uint32_t comments,
+    const std::function<std::size_t(const std::string &comments)> &decode) {
+  decode(responses[0]);
+
+  std::size_t chars{0};
+  std::vector<uint64_t> elapsed_ns;
+  for (std::size_t i = 1; i < responses.size(); ++i) {
+    const uint64_t begun_ns = GetSteadyNanoseconds();
+    chars += decode(responses[i]);
+    elapsed_ns.emplace_back(GetSteadyNanoseconds() - begun_ns);
+  }
+  std::sort(elapsed_ns.begin(), elapsed_ns.end());
+
+  const uint64_t median_ns = elapsed_ns[elapsed_ns.size() / 2];
+  std::cout << "  " << name << ": "
+            << median_ns / 1000 << " us/response (fastest "
+            << elapsed_ns.front() / 1000 << " us), "
+            << median_ns / comments << " ns/comment" << std::endl;
+  return chars;
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_benchmark {
+void RunDecodeBenchmark(uint32_t comments) {
+  std::vector<std::string> responses;
+  for (uint32_t i = 0; i <= kResponses; ++i) {
+    responses.emplace_back(NewComments(comments, i * comments));
+  }
+  TestMemoryResource memory_resource;
+  MonotonicBufferResource arena{&memory_resource};
+  CommentStore store{kStoreCapacity};
+  ChatAnalytics analytics;
+
+  std::cout << "comments decoding, " << comments << " comments a response, "
+            << responses[0].size() << " bytes:" << std::endl;
+  const std::size_t handed = Run(
+      "string hand-off and caller parsing", responses, comments,
+      [](const std::string &response) {
+    return HandOff(response);
+  });
+  const std::size_t decoded = Run(
+      "records decoded by the library", responses, comments,
+      [&arena](const std::string &response) {
+    return DecodeRecords(response, &arena, nullptr, nullptr);
+  });
+  // as the library does with every response of records.
+  const std::size_t stored = Run(
+      "records decoded, stored and counted", responses, comments,
+      [&arena, &store, &analytics](const std::string &response) {
+    return DecodeRecords(response, &arena, &store, &analytics);
+  });
+  if (decoded != handed || stored != handed) {
+    std::cout << "  decoded differently: " << handed << ", " << decoded
+              << " and " << stored << " characters" << std::endl;
+  }
+}
+}  // namespace ncstreamer_remote_benchmark
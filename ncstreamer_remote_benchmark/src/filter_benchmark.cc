@@ -0,0 +1,147 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <codecvt>
+#include <iostream>
+#include <locale>
+#include <string>
+#include <vector>
+
+#include "ncstreamer_remote_benchmark/src/benchmarks.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_filter.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/ncstreamer_remote.h"
+
+
+namespace {
+using ncstreamer_remote::CommentFilter;
+using ncstreamer_remote::CommentFilterRule;
+
+
+const std::size_t kRuleCounts[] = {10, 100, 1000};
+
+
+uint64_t GetSteadyNanoseconds() {
+  const auto &now = Chrono::duration_cast<Chrono::nanoseconds>(
+      Chrono::steady_clock::now().time_since_epoch());
+  return static_cast<uint64_t>(now.count());
+}
+
+
+/// Words of a few letters, of which some comments contain one.
+std::vector<CommentFilterRule> NewRules(std::size_t count) {
+  std::vector<CommentFilterRule> rules;
+  rules.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    rules.emplace_back(CommentFilterRule{
+        L"w" + std::to_wstring(i * 7919) + L"x",
+        (i % 10) == 0,
+        static_cast<uint32_t>(1 << (i % 32))});
+  }
+  return rules;
+}
+
+
+/// UTF-8 comments of an ordinary length, a Hangul word in each.
+std::vector<std::string> NewComments(uint32_t count, std::size_t rules) {
+  std::vector<std::string> comments;
+  comments.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    std::string comment{
+        "\xEC\x95\x88\xEB\x85\x95 a comment of some ordinary length, "
+        "number " + std::to_string(i)};
+    if (i % 20 == 0) {
+      comment += " w" + std::to_string((i % rules) * 7919) + "x";
+    }
+    comments.emplace_back(std::move(comment));
+  }
+  return comments;
+}
+
+
+/// @return The bytes of `comments`.
+uint64_t CountBytes(const std::vector<std::string> &comments) {
+  uint64_t bytes{0};
+  for (const auto &comment : comments) {
+    bytes += comment.size();
+  }
+  return bytes;
+}
+
+
+/// As a caller would filter without the automaton: a search per rule.
+uint32_t SearchEachRule(
+    const std::vector<std::string> &patterns,
+    const std::vector<std::string> &comments) {
+  uint32_t matched{0};
+  for (const auto &comment : comments) {
+    for (const auto &pattern : patterns) {
+      if (comment.find(pattern) != std::string::npos) {
+        ++matched;
+        break;
+      }
+    }
+  }
+  return matched;
+}
+
+
+uint32_t ScanAll(
+    const CommentFilter &filter,
+    const std::vector<std::string> &comments) {
+  uint32_t matched{0};
+  for (const auto &comment : comments) {
+    const CommentFilter::Match &match =
+        filter.Scan(comment.c_str(), comment.size());
+    if (match.drop == true || match.tags != 0) {
+      ++matched;
+    }
+  }
+  return matched;
+}
+
+
+void RunRules(std::size_t rule_count, uint32_t comment_count) {
+  const std::vector<CommentFilterRule> &rules = NewRules(rule_count);
+  const std::vector<std::string> &comments =
+      NewComments(comment_count, rule_count);
+  const uint64_t bytes = CountBytes(comments);
+
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  std::vector<std::string> patterns;
+  for (const auto &rule : rules) {
+    patterns.emplace_back(converter.to_bytes(rule.pattern));
+  }
+
+  const uint64_t search_begun_ns = GetSteadyNanoseconds();
+  const uint32_t searched = SearchEachRule(patterns, comments);
+  const uint64_t search_ns = GetSteadyNanoseconds() - search_begun_ns;
+
+  const uint64_t build_begun_ns = GetSteadyNanoseconds();
+  const CommentFilter filter{rules, true};
+  const uint64_t build_ns = GetSteadyNanoseconds() - build_begun_ns;
+
+  const uint64_t scan_begun_ns = GetSteadyNanoseconds();
+  const uint32_t scanned = ScanAll(filter, comments);
+  const uint64_t scan_ns = GetSteadyNanoseconds() - scan_begun_ns;
+
+  std::cout << "  " << rule_count << " rules: automaton "
+            << scan_ns / comment_count << " ns/comment, "
+            << bytes * 1000 / (scan_ns + 1) << " MB/s (built in "
+            << build_ns / 1000 << " us); a search per rule "
+            << search_ns / comment_count << " ns/comment, "
+            << bytes * 1000 / (search_ns + 1) << " MB/s; matched "
+            << scanned << " and " << searched << std::endl;
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_benchmark {
+void RunFilterBenchmark(uint32_t comments) {
+  std::cout << "comment filter, " << comments << " comments:" << std::endl;
+  for (const std::size_t rule_count : kRuleCounts) {
+    RunRules(rule_count, comments);
+  }
+}
+}  // namespace ncstreamer_remote_benchmark
@@ -0,0 +1,170 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <cstdio>
+#include <fstream>
+#include <future>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "ncstreamer_remote_benchmark/src/benchmarks.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/log/async_log.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/ncstreamer_remote.h"
+#include "ncstreamer_remote_test/src/stand_in_server.h"
+#include "ncstreamer_remote_test/src/test_memory_resource.h"
+
+
+namespace {
+using ncstreamer_remote::AsyncLog;
+using ncstreamer_remote::AsyncLogPolicy;
+using ncstreamer_remote::ErrorCategory;
+using ncstreamer_remote::NcStreamerRemote;
+using ncstreamer_remote_test::StandInServer;
+using ncstreamer_remote_test::TestMemoryResource;
+
+
+const uint16_t kStandInPort{9106};
+const char *const kLogPath{"ncstreamer_remote_benchmark.log"};
+const AsyncLogPolicy kLogPolicy{64 * 1024, 10 * 1024 * 1024, 3};
+
+
+uint64_t GetSteadyNanoseconds() {
+  const auto &now = Chrono::duration_cast<Chrono::nanoseconds>(
+      Chrono::steady_clock::now().time_since_epoch());
+  return static_cast<uint64_t>(now.count());
+}
+
+
+/// As websocketpp's basic logger writes a line, flushing it.
+/// @return The mean nanoseconds per line on the calling thread.
+uint64_t WriteLines(std::ostream *out, uint32_t lines) {
+  const std::string payload(120, 'x');
+  const uint64_t begun_ns = GetSteadyNanoseconds();
+  for (uint32_t i = 0; i < lines; ++i) {
+    if (out == nullptr) {
+      continue;  // channel off, as the logger tests it first.
+    }
+    *out << "[2017-06-01 12:00:00] [frame_payload] Payload: "
+         << payload << " " << i << "\n";
+    out->flush();
+  }
+  return (GetSteadyNanoseconds() - begun_ns) / lines;
+}
+
+
+void RemoveLogs() {
+  std::remove(kLogPath);
+  for (uint32_t i = 1; i <= kLogPolicy.max_rotated_files; ++i) {
+    std::remove((std::string{kLogPath} + "." + std::to_string(i)).c_str());
+  }
+}
+
+
+void RunWriterCost(uint32_t lines) {
+  std::cout << "per line on the writing thread, " << lines << " lines:"
+            << std::endl;
+  std::cout << "  off:   " << WriteLines(nullptr, lines) << " ns" << std::endl;
+
+  RemoveLogs();
+  {
+    std::ofstream file{kLogPath};
+    std::cout << "  sync:  " << WriteLines(&file, lines) << " ns"
+              << std::endl;
+  }
+
+  RemoveLogs();
+  {
+    AsyncLog log{kLogPath, kLogPolicy};
+    std::cout << "  async: " << WriteLines(log.access_stream(), lines)
+              << " ns";
+    const auto &stats = log.GetStats();
+    std::cout << " (dropped " << stats.dropped_bytes << " bytes)"
+              << std::endl;
+  }
+  RemoveLogs();
+}
+
+
+/// @return The mean nanoseconds per status round trip.
+uint64_t RunRoundTrips(NcStreamerRemote *remote, uint32_t requests) {
+  uint64_t begun_ns{0};
+  for (uint32_t i = 0; i <= requests; ++i) {
+    if (i == 1) {
+      begun_ns = GetSteadyNanoseconds();  // after connected.
+    }
+    auto responded = std::make_shared<std::promise<void>>();
+    remote->RequestStatus([responded](
+        ErrorCategory /*err_category*/,
+        int /*err_code*/,
+        const std::wstring &/*err_msg*/) {
+      responded->set_value();
+    }, [responded](
+        const std::wstring &/*status*/,
+        const std::wstring &/*source_title*/,
+        const std::wstring &/*user_name*/,
+        const std::wstring &/*quality*/) {
+      responded->set_value();
+    });
+    responded->get_future().wait();
+  }
+  return (GetSteadyNanoseconds() - begun_ns) / requests;
+}
+
+
+void RunRoundTripCost(uint32_t requests) {
+  StandInServer server{kStandInPort};
+  if (server.is_listening() == false) {
+    std::cerr << "port " << kStandInPort << " taken." << std::endl;
+    return;
+  }
+  TestMemoryResource memory_resource;
+
+  std::cout << "per status round trip, " << requests << " requests:"
+            << std::endl;
+  {
+    NcStreamerRemote *remote = NcStreamerRemote::Create(
+        kStandInPort, &memory_resource, nullptr, "");
+    std::cout << "  no log:      " << RunRoundTrips(remote, requests)
+              << " ns" << std::endl;
+    NcStreamerRemote::Destroy(remote);
+  }
+
+  RemoveLogs();
+  {
+    NcStreamerRemote *remote = NcStreamerRemote::Create(
+        kStandInPort, &memory_resource, nullptr, kLogPath);
+    std::cout << "  default log: " << RunRoundTrips(remote, requests)
+              << " ns" << std::endl;
+    NcStreamerRemote::Destroy(remote);
+  }
+
+  RemoveLogs();
+  {
+    NcStreamerRemote *remote = NcStreamerRemote::Create(
+        kStandInPort, &memory_resource, nullptr, kLogPath);
+    remote->SetLogChannels(
+        websocketpp::log::alevel::all, websocketpp::log::elevel::all);
+    remote->SetFrameLogSampling(1);
+    std::cout << "  every frame: " << RunRoundTrips(remote, requests)
+              << " ns";
+    const auto &stats = remote->GetLogStats();
+    std::cout << " (written " << stats.written_bytes
+              << " bytes, dropped " << stats.dropped_bytes << " bytes)"
+              << std::endl;
+    NcStreamerRemote::Destroy(remote);
+  }
+  RemoveLogs();
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_benchmark {
+void RunLogBenchmark(uint32_t lines, uint32_t requests) {
+  RunWriterCost(lines);
+  RunRoundTripCost(requests);
+}
+}  // namespace ncstreamer_remote_benchmark
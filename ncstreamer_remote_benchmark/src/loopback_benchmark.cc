@@ -0,0 +1,162 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <algorithm>
+#include <cstdio>
+#include <future>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ncstreamer_remote_benchmark/src/benchmarks.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/ncstreamer_remote.h"
+#include "ncstreamer_remote_test/src/stand_in_server.h"
+#include "ncstreamer_remote_test/src/test_memory_resource.h"
+
+
+namespace {
+using ncstreamer_remote::CommentRecords;
+using ncstreamer_remote::ErrorCategory;
+using ncstreamer_remote::NcStreamerRemote;
+using ncstreamer_remote_test::StandInComment;
+using ncstreamer_remote_test::StandInServer;
+using ncstreamer_remote_test::TestMemoryResource;
+
+
+const uint16_t kStandInPort{9107};
+
+
+uint64_t GetSteadyMicroseconds() {
+  const auto &now = Chrono::duration_cast<Chrono::microseconds>(
+      Chrono::steady_clock::now().time_since_epoch());
+  return static_cast<uint64_t>(now.count());
+}
+
+
+uint32_t ToPercentile(const std::vector<uint32_t> &sorted, double p) {
+  if (sorted.empty() == true) {
+    return 0;
+  }
+  const std::size_t i = static_cast<std::size_t>(p * (sorted.size() - 1));
+  return sorted[i];
+}
+
+
+/// @return Whether it succeeded.
+bool RequestStatus(NcStreamerRemote *remote) {
+  auto responded = std::make_shared<std::promise<bool>>();
+  remote->RequestStatus([responded](
+      ErrorCategory /*err_category*/,
+      int /*err_code*/,
+      const std::wstring &/*err_msg*/) {
+    responded->set_value(false);
+  }, [responded](
+      const std::wstring &/*status*/,
+      const std::wstring &/*source_title*/,
+      const std::wstring &/*user_name*/,
+      const std::wstring &/*quality*/) {
+    responded->set_value(true);
+  });
+  return responded->get_future().get();
+}
+
+
+/// Every comment of the stand-in server.
+bool RequestComments(NcStreamerRemote *remote) {
+  auto responded = std::make_shared<std::promise<bool>>();
+  remote->RequestCommentRecords(L"", [responded](
+      ErrorCategory /*err_category*/,
+      int /*err_code*/,
+      const std::wstring &/*err_msg*/) {
+    responded->set_value(false);
+  }, [responded](const CommentRecords &/*comments*/) {
+    responded->set_value(true);
+  });
+  return responded->get_future().get();
+}
+
+
+/// One request after another, on the connection open already.
+template <typename RequestFn>
+void RunRoundTrips(
+    const char *name,
+    uint32_t requests,
+    const StandInServer &server,
+    RequestFn request) {
+  std::vector<uint32_t> latencies;
+  latencies.reserve(requests);
+  uint32_t errors{0};
+  const uint64_t bytes_begun = server.bytes_sent();
+  const uint64_t begun_us = GetSteadyMicroseconds();
+  for (uint32_t i = 0; i < requests; ++i) {
+    const uint64_t requested_us = GetSteadyMicroseconds();
+    if (request() == false) {
+      ++errors;
+      continue;
+    }
+    latencies.emplace_back(
+        static_cast<uint32_t>(GetSteadyMicroseconds() - requested_us));
+  }
+  const uint64_t elapsed_us = GetSteadyMicroseconds() - begun_us;
+  const uint64_t bytes = server.bytes_sent() - bytes_begun;
+  std::sort(latencies.begin(), latencies.end());
+
+  std::cout << "  " << name << ": "
+            << (requests == 0 ? 0 : bytes / requests) << " bytes each"
+            << ", p50 " << ToPercentile(latencies, 0.5) << " us"
+            << ", p99 " << ToPercentile(latencies, 0.99) << " us"
+            << ", " << (elapsed_us == 0 ? 0 : bytes / elapsed_us)
+            << " MB/s"
+            << ", errors " << errors << std::endl;
+}
+
+
+void AddComments(StandInServer *server, uint32_t from, uint32_t to) {
+  for (uint32_t i = from; i < to; ++i) {
+    char created_time[32];
+    std::snprintf(created_time, sizeof(created_time),
+        "2017-06-01T12:%02u:%02u+0000", (i / 60) % 60, i % 60);
+    server->AddComment(StandInComment{
+        std::to_string(i),
+        "viewer" + std::to_string(i % 50),
+        "a comment of some ordinary length, number " + std::to_string(i),
+        created_time});
+  }
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_benchmark {
+void RunLoopbackBenchmark(uint32_t requests) {
+  StandInServer server{kStandInPort};
+  if (server.is_listening() == false) {
+    std::cerr << "port " << kStandInPort << " taken." << std::endl;
+    return;
+  }
+  TestMemoryResource memory_resource;
+  NcStreamerRemote *remote = NcStreamerRemote::Create(
+      kStandInPort, &memory_resource, nullptr, "");
+  RequestStatus(remote);  // connects.
+
+  // the baseline a transport other than the loopback TCP would be held to.
+  std::cout << "loopback TCP round trips, " << requests << " requests:"
+            << std::endl;
+  RunRoundTrips("status", requests, server, [remote]() {
+    return RequestStatus(remote);
+  });
+  uint32_t comments{0};
+  for (uint32_t count : {10u, 100u, 1000u}) {
+    AddComments(&server, comments, count);
+    comments = count;
+    const std::string &name = std::to_string(count) + " comments";
+    RunRoundTrips(name.c_str(), requests, server, [remote]() {
+      return RequestComments(remote);
+    });
+  }
+
+  NcStreamerRemote::Destroy(remote);
+}
+}  // namespace ncstreamer_remote_benchmark
@@ -0,0 +1,62 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "ncstreamer_remote_benchmark/src/benchmarks.h"
+
+
+namespace {
+uint32_t ToCount(int argc, char *argv[], int i, uint32_t default_count) {
+  if (i >= argc) {
+    return default_count;
+  }
+  return static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10));
+}
+}  // unnamed namespace
+
+
+/// ncstreamer_remote_benchmark [scaling [clients [requests per client]]]
+/// ncstreamer_remote_benchmark [log [lines [requests]]]
+/// ncstreamer_remote_benchmark [loopback [requests]]
+/// ncstreamer_remote_benchmark [push [comments]]
+/// ncstreamer_remote_benchmark [bulk [requests]]
+/// ncstreamer_remote_benchmark [filter [comments]]
+/// ncstreamer_remote_benchmark [decode [comments]]
+int main(int argc, char *argv[]) {
+  const std::string &name = (argc > 1) ? argv[1] : "";
+
+  if (name.empty() == true || name == "scaling") {
+    ncstreamer_remote_benchmark::RunScalingBenchmark(
+        ToCount(argc, argv, 2, 200), ToCount(argc, argv, 3, 50));
+  }
+  if (name.empty() == true || name == "log") {
+    ncstreamer_remote_benchmark::RunLogBenchmark(
+        ToCount(argc, argv, 2, 100000), ToCount(argc, argv, 3, 1000));
+  }
+  if (name.empty() == true || name == "loopback") {
+    ncstreamer_remote_benchmark::RunLoopbackBenchmark(
+        ToCount(argc, argv, 2, 1000));
+  }
+  if (name.empty() == true || name == "push") {
+    ncstreamer_remote_benchmark::RunPushBenchmark(
+        ToCount(argc, argv, 2, 1000));
+  }
+  if (name.empty() == true || name == "bulk") {
+    ncstreamer_remote_benchmark::RunBulkLoadBenchmark(
+        ToCount(argc, argv, 2, 1000));
+  }
+  if (name.empty() == true || name == "filter") {
+    ncstreamer_remote_benchmark::RunFilterBenchmark(
+        ToCount(argc, argv, 2, 100000));
+  }
+  if (name.empty() == true || name == "decode") {
+    ncstreamer_remote_benchmark::RunDecodeBenchmark(
+        ToCount(argc, argv, 2, 1000));
+  }
+  return 0;
+}
@@ -0,0 +1,168 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdio>
+#include <future>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "ncstreamer_remote_benchmark/src/benchmarks.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/ncstreamer_remote.h"
+#include "ncstreamer_remote_test/src/stand_in_server.h"
+#include "ncstreamer_remote_test/src/test_memory_resource.h"
+
+
+namespace {
+using ncstreamer_remote::CommentRecords;
+using ncstreamer_remote::ErrorCategory;
+using ncstreamer_remote::NcStreamerRemote;
+using ncstreamer_remote_test::StandInComment;
+using ncstreamer_remote_test::StandInServer;
+using ncstreamer_remote_test::TestMemoryResource;
+
+
+const uint16_t kStandInPort{9108};
+const std::chrono::seconds kTimeout{5};
+
+
+uint64_t GetSteadyMicroseconds() {
+  const auto &now = Chrono::duration_cast<Chrono::microseconds>(
+      Chrono::steady_clock::now().time_since_epoch());
+  return static_cast<uint64_t>(now.count());
+}
+
+
+/// The comments pushed to the client so far, waited on from the main thread.
+class PushedCount {
+ public:
+  PushedCount()
+      : mutex_{},
+        arrived_{},
+        count_{0},
+        arrived_us_{0} {}
+
+  void Add(std::size_t count) {
+    const uint64_t now_us = GetSteadyMicroseconds();
+    std::lock_guard<std::mutex> lock{mutex_};
+    count_ += count;
+    arrived_us_ = now_us;
+    arrived_.notify_all();
+  }
+
+  /// @return The time the `count`th comment arrived, or zero on a timeout.
+  uint64_t WaitFor(std::size_t count) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    const bool arrived = arrived_.wait_for(lock, kTimeout, [this, count]() {
+      return count_ >= count;
+    });
+    return (arrived == true) ? arrived_us_ : 0;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable arrived_;
+  std::size_t count_;
+  uint64_t arrived_us_;
+};
+
+
+StandInComment NewComment(uint32_t i) {
+  char created_time[32];
+  std::snprintf(created_time, sizeof(created_time),
+      "2017-06-01T%02u:%02u:%02u+0000",
+      (i / 3600) % 24, (i / 60) % 60, i % 60);
+  return StandInComment{
+      std::to_string(i),
+      "viewer" + std::to_string(i % 50),
+      "a comment of some ordinary length, number " + std::to_string(i),
+      created_time};
+}
+
+
+bool Subscribe(NcStreamerRemote *remote) {
+  auto responded = std::make_shared<std::promise<bool>>();
+  remote->RequestCommentsSubscribe(L"", [responded](
+      ErrorCategory /*err_category*/,
+      int /*err_code*/,
+      const std::wstring &/*err_msg*/) {
+    responded->set_value(false);
+  }, [responded](bool success) {
+    responded->set_value(success);
+  });
+  return responded->get_future().get();
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_benchmark {
+void RunPushBenchmark(uint32_t comments) {
+  StandInServer server{kStandInPort};
+  if (server.is_listening() == false) {
+    std::cerr << "port " << kStandInPort << " taken." << std::endl;
+    return;
+  }
+  TestMemoryResource memory_resource;
+  NcStreamerRemote *remote = NcStreamerRemote::Create(
+      kStandInPort, &memory_resource, nullptr, "");
+  PushedCount pushed;
+  remote->RegisterCommentRecordsEventHandler(
+      [&pushed](const CommentRecords &records) {
+    pushed.Add(records.size());
+  });
+  if (Subscribe(remote) == false) {
+    std::cerr << "subscribe failed." << std::endl;
+    NcStreamerRemote::Destroy(remote);
+    return;
+  }
+
+  // the baseline a shared-memory transport would be held to:
+  // one comment at a time, from being added to reaching the handler.
+  std::vector<uint32_t> latencies;
+  latencies.reserve(comments);
+  uint32_t i{0};
+  for (; i < comments; ++i) {
+    const uint64_t added_us = GetSteadyMicroseconds();
+    server.AddComment(NewComment(i));
+    const uint64_t arrived_us = pushed.WaitFor(i + 1);
+    if (arrived_us == 0) {
+      break;
+    }
+    latencies.emplace_back(static_cast<uint32_t>(arrived_us - added_us));
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  // and all at once.
+  const uint64_t begun_us = GetSteadyMicroseconds();
+  for (uint32_t j = 0; j < comments; ++j) {
+    server.AddComment(NewComment(i + j));
+  }
+  const uint64_t arrived_us = pushed.WaitFor(i + comments);
+  const uint64_t elapsed_us =
+      (arrived_us == 0) ? 0 : arrived_us - begun_us;
+
+  std::cout << "WebSocket push, " << comments << " comments:" << std::endl;
+  if (latencies.empty() == false) {
+    std::cout << "  wake latency: p50 "
+              << latencies[latencies.size() / 2] << " us, p99 "
+              << latencies[(latencies.size() - 1) * 99 / 100] << " us"
+              << std::endl;
+  }
+  if (elapsed_us != 0) {
+    std::cout << "  burst: "
+              << static_cast<uint64_t>(comments) * 1000000 / elapsed_us
+              << " messages/sec" << std::endl;
+  } else {
+    std::cout << "  burst: timed out" << std::endl;
+  }
+
+  NcStreamerRemote::Destroy(remote);
+}
+}  // namespace ncstreamer_remote_benchmark
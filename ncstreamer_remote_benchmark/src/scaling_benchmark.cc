@@ -0,0 +1,185 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <future>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ncstreamer_remote_benchmark/src/benchmarks.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/executor/remote_executor.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/ncstreamer_remote.h"
+#include "ncstreamer_remote_test/src/stand_in_server.h"
+#include "ncstreamer_remote_test/src/test_memory_resource.h"
+
+
+namespace {
+using ncstreamer_remote::ErrorCategory;
+using ncstreamer_remote::NcStreamerRemote;
+using ncstreamer_remote::RemoteExecutor;
+using ncstreamer_remote_test::StandInServer;
+using ncstreamer_remote_test::TestMemoryResource;
+
+
+const uint16_t kStandInPort{9105};
+
+
+uint64_t GetSteadyMicroseconds() {
+  const auto &now = Chrono::duration_cast<Chrono::microseconds>(
+      Chrono::steady_clock::now().time_since_epoch());
+  return static_cast<uint64_t>(now.count());
+}
+
+
+/// Status requests of every client, one after another per client.
+/// The handlers of a client run on its io thread only.
+class StatusRun {
+ public:
+  StatusRun(
+      const std::vector<NcStreamerRemote *> &remotes,
+      uint32_t requests_per_client)
+      : remotes_{remotes},
+        requests_per_client_{requests_per_client},
+        latencies_us_(remotes.size()),
+        responded_(remotes.size(), 0),
+        errors_{0},
+        clients_left_{static_cast<uint32_t>(remotes.size())},
+        done_{} {}
+
+  /// @return The microseconds until every client is done.
+  uint64_t Run() {
+    const uint64_t begun_us = GetSteadyMicroseconds();
+    for (std::size_t i = 0; i < remotes_.size(); ++i) {
+      latencies_us_[i].reserve(requests_per_client_);
+      Request(i);
+    }
+    done_.get_future().wait();
+    return GetSteadyMicroseconds() - begun_us;
+  }
+
+  /// Of all the requests, sorted.
+  std::vector<uint32_t> GetLatencies() const {
+    std::vector<uint32_t> all;
+    for (const auto &latencies : latencies_us_) {
+      all.insert(all.end(), latencies.begin(), latencies.end());
+    }
+    std::sort(all.begin(), all.end());
+    return all;
+  }
+
+  uint32_t errors() const { return errors_; }
+
+ private:
+  void Request(std::size_t client) {
+    const uint64_t begun_us = GetSteadyMicroseconds();
+    remotes_[client]->RequestStatus([this, client](
+        ErrorCategory /*err_category*/,
+        int /*err_code*/,
+        const std::wstring &/*err_msg*/) {
+      ++errors_;
+      OnResponse(client, false);
+    }, [this, client, begun_us](
+        const std::wstring &/*status*/,
+        const std::wstring &/*source_title*/,
+        const std::wstring &/*user_name*/,
+        const std::wstring &/*quality*/) {
+      latencies_us_[client].emplace_back(
+          static_cast<uint32_t>(GetSteadyMicroseconds() - begun_us));
+      OnResponse(client, true);
+    });
+  }
+
+  void OnResponse(std::size_t client, bool succeeded) {
+    // an error ends the run of its client, as it is likely to repeat.
+    if (succeeded == true &&
+        ++responded_[client] < requests_per_client_) {
+      Request(client);
+      return;
+    }
+    if (--clients_left_ == 0) {
+      done_.set_value();
+    }
+  }
+
+  const std::vector<NcStreamerRemote *> &remotes_;
+  const uint32_t requests_per_client_;
+  /// Each client writes its own elements only.
+  std::vector<std::vector<uint32_t>> latencies_us_;
+  std::vector<uint32_t> responded_;
+  std::atomic_uint errors_;
+  std::atomic_uint clients_left_;
+  std::promise<void> done_;
+};
+
+
+uint32_t ToPercentile(const std::vector<uint32_t> &sorted, double p) {
+  if (sorted.empty() == true) {
+    return 0;
+  }
+  const std::size_t i = static_cast<std::size_t>(p * (sorted.size() - 1));
+  return sorted[i];
+}
+
+
+void RunClients(
+    const char *mode,
+    uint32_t clients,
+    uint32_t requests_per_client,
+    RemoteExecutor *executor) {
+  TestMemoryResource memory_resource;
+  std::vector<NcStreamerRemote *> remotes;
+  for (uint32_t i = 0; i < clients; ++i) {
+    remotes.emplace_back(NcStreamerRemote::Create(
+        kStandInPort, &memory_resource, executor, ""));
+  }
+
+  // the first request of each client connects it.
+  StatusRun connect_run{remotes, 1};
+  const uint64_t connect_us = connect_run.Run();
+
+  StatusRun status_run{remotes, requests_per_client};
+  const uint64_t elapsed_us = status_run.Run();
+  const std::vector<uint32_t> &latencies = status_run.GetLatencies();
+
+  std::cout << mode << ": " << clients << " clients"
+            << ", connected in " << connect_us / 1000 << " ms"
+            << ", " << latencies.size() << " requests in "
+            << elapsed_us / 1000 << " ms"
+            << " (" << (elapsed_us == 0 ? 0 :
+                latencies.size() * 1000000 / elapsed_us) << "/s)"
+            << ", p50 " << ToPercentile(latencies, 0.5) << " us"
+            << ", p99 " << ToPercentile(latencies, 0.99) << " us"
+            << ", errors " << connect_run.errors() + status_run.errors()
+            << std::endl;
+
+  const uint64_t destroy_begun_us = GetSteadyMicroseconds();
+  for (NcStreamerRemote *remote : remotes) {
+    NcStreamerRemote::Destroy(remote);
+  }
+  std::cout << mode << ": destroyed in "
+            << (GetSteadyMicroseconds() - destroy_begun_us) / 1000 << " ms"
+            << std::endl;
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_benchmark {
+void RunScalingBenchmark(uint32_t clients, uint32_t requests_per_client) {
+  StandInServer server{kStandInPort};
+  if (server.is_listening() == false) {
+    std::cerr << "port " << kStandInPort << " taken." << std::endl;
+    return;
+  }
+
+  {
+    RemoteExecutor executor;
+    RunClients("shared executor", clients, requests_per_client, &executor);
+  }
+  RunClients("thread each", clients, requests_per_client, nullptr);
+}
+}  // namespace ncstreamer_remote_benchmark
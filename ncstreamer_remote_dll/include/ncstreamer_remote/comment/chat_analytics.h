@@ -0,0 +1,80 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_CHAT_ANALYTICS_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_CHAT_ANALYTICS_H_
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_records.h"
+
+
+namespace ncstreamer_remote {
+struct ChatStats {
+  uint32_t comments_last_10_seconds;
+  uint32_t comments_last_minute;
+  uint32_t comments_last_5_minutes;
+  uint64_t comments_total;
+
+  /// Estimated within a few percent.
+  uint64_t unique_authors;
+
+  /// Whether the last 10 seconds run well above the usual rate.
+  bool bursting;
+  uint64_t bursts;
+};
+
+
+/// Incremental chat aggregates over the comments as they arrive:
+/// per-second counters with running sums for each sliding window,
+/// a HyperLogLog of the authors, and burst detection against
+/// a moving average of the rate.
+/// Every update is O(1) and the memory is fixed.
+/// Add(), Advance() and Reset() are for a single thread,
+/// and GetStats() is for any thread, without locks.
+class ChatAnalytics {
+ public:
+  ChatAnalytics();
+  virtual ~ChatAnalytics();
+
+  /// @param now_ms Any monotonic clock in milliseconds.
+  void Add(uint64_t now_ms, const CommentRecord &record);
+
+  /// Lets the windows slide while no comments arrive.
+  void Advance(uint64_t now_ms);
+  void Reset();
+
+  ChatStats GetStats() const;
+
+ private:
+  static const std::size_t kSeconds = 300;
+  static const std::size_t kWindowCount = 3;
+  static const std::size_t kRegisterBits = 10;
+  static const std::size_t kRegisterCount = 1 << kRegisterBits;
+
+  ChatAnalytics(const ChatAnalytics &) = delete;
+  ChatAnalytics &operator=(const ChatAnalytics &) = delete;
+
+  void UpdateBurst();
+
+  bool started_;
+  uint64_t current_second_;
+  uint64_t seconds_seen_;
+  double usual_rate_;
+
+  std::atomic<uint32_t> counts_[kSeconds];
+  std::atomic<uint32_t> window_counts_[kWindowCount];
+  std::atomic<uint64_t> total_;
+  std::atomic<uint8_t> registers_[kRegisterCount];
+  std::atomic_bool bursting_;
+  std::atomic<uint64_t> bursts_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_CHAT_ANALYTICS_H_
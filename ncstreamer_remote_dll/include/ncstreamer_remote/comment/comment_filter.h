@@ -0,0 +1,60 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_COMMENT_FILTER_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_COMMENT_FILTER_H_
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace ncstreamer_remote {
+struct CommentFilterRule {
+  std::wstring pattern;
+
+  /// Whether to drop the comments whose text contains `pattern`.
+  bool drop;
+
+  /// Otherwise, the bits added to the tags of those comments.
+  uint32_t tags;
+};
+
+
+/// Aho-Corasick automaton matching all the rules at once
+/// over the UTF-8 bytes of a comment, in one pass.
+/// Bytes are mapped to the classes appearing in the patterns,
+/// and the transitions are resolved up front,
+/// so a scan costs one table lookup per byte.
+/// Case folding, if asked, applies to ASCII letters.
+class CommentFilter {
+ public:
+  struct Match {
+    bool drop;
+    uint32_t tags;
+  };
+
+  CommentFilter(
+      const std::vector<CommentFilterRule> &rules,
+      bool ignore_case);
+  virtual ~CommentFilter();
+
+  Match Scan(const char *text, std::size_t size) const;
+
+ private:
+  CommentFilter(const CommentFilter &) = delete;
+  CommentFilter &operator=(const CommentFilter &) = delete;
+
+  std::vector<uint16_t> byte_classes_;
+  std::size_t class_count_;
+  std::vector<uint32_t> transitions_;
+  std::vector<Match> outputs_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_COMMENT_FILTER_H_
@@ -0,0 +1,71 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_COMMENT_RECORDS_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_COMMENT_RECORDS_H_
+
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/memory/memory_resource.h"
+
+
+namespace ncstreamer_remote {
+/// One decoded comment.
+/// Every field is a null-terminated string in the text arena
+/// of the CommentRecords it belongs to.
+struct CommentRecord {
+  const wchar_t *id;
+  const wchar_t *author;
+  const wchar_t *text;
+  const wchar_t *created_time;
+
+  /// Bits of the comment filter rules the text matched.
+  uint32_t tags;
+};
+
+
+/// Comments of one message, decoded once by the library.
+/// The records are contiguous, and all their strings share one arena,
+/// both drawn from the memory resource current at construction.
+/// While a handler is called that is the arena of the inbound message,
+/// so copy out whatever should outlive the call.
+class CommentRecords {
+ public:
+  using const_iterator = const CommentRecord *;
+
+  CommentRecords()
+      : records_{},
+        text_{} {}
+
+  CommentRecords(CommentRecords &&other)
+      : records_{std::move(other.records_)},
+        text_{std::move(other.text_)} {}
+
+  std::size_t size() const { return records_.size(); }
+  bool empty() const { return records_.empty(); }
+
+  const_iterator begin() const { return records_.data(); }
+  const_iterator end() const { return records_.data() + records_.size(); }
+
+  const CommentRecord &operator[](std::size_t i) const { return records_[i]; }
+  const CommentRecord &back() const { return records_.back(); }
+
+ private:
+  friend class CommentDecoder;
+
+  CommentRecords(const CommentRecords &) = delete;
+  CommentRecords &operator=(const CommentRecords &) = delete;
+
+  std::vector<CommentRecord, ResourceAllocator<CommentRecord>> records_;
+  std::vector<wchar_t, ResourceAllocator<wchar_t>> text_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_COMMENT_RECORDS_H_
@@ -0,0 +1,74 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_COMMENT_STORE_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_COMMENT_STORE_H_
+
+
+#include <cstddef>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_records.h"
+
+
+namespace ncstreamer_remote {
+/// A comment kept beyond the handler call, owning its strings.
+struct Comment {
+  std::wstring id;
+  std::wstring author;
+  std::wstring text;
+  std::wstring created_time;
+};
+
+
+/// Bounded ring of the latest comments, de-duplicated by id.
+/// It assumes comments arrive in the order of their created_time,
+/// as NCStreamer sends them.
+class CommentStore {
+ public:
+  explicit CommentStore(std::size_t capacity);
+  virtual ~CommentStore();
+
+  /// @return The number of comments newly stored,
+  ///         without the ones already stored.
+  std::size_t Add(const CommentRecords &records);
+  /// Same as above, calling `on_added` with each comment newly stored.
+  std::size_t Add(
+      const CommentRecords &records,
+      const std::function<void(const CommentRecord &record)> &on_added);
+  void Clear();
+
+  /// @return Up to `count` latest comments, the newest last.
+  std::vector<Comment> GetLast(std::size_t count) const;
+
+  /// @return The comments created after `created_time`, the newest last.
+  std::vector<Comment> GetSince(const std::wstring &created_time) const;
+
+  /// @return The created_time of the newest comment ever stored,
+  ///         to request the next comments with.
+  std::wstring GetCursor() const;
+
+ private:
+  CommentStore(const CommentStore &) = delete;
+  CommentStore &operator=(const CommentStore &) = delete;
+
+  /// @param i 0 for the oldest.
+  const Comment &At(std::size_t i) const;
+
+  mutable std::mutex mutex_;
+  std::size_t capacity_;
+  std::vector<Comment> ring_;
+  std::size_t oldest_;
+  std::unordered_set<std::wstring> ids_;
+  std::wstring cursor_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_COMMENT_STORE_H_
@@ -0,0 +1,48 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_COMMENTS_QUERY_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_COMMENTS_QUERY_H_
+
+
+#include <cstdint>
+#include <string>
+
+
+namespace ncstreamer_remote {
+/// Narrows a comments request on the side of NCStreamer,
+/// before the comments are serialized.
+struct CommentsQuery {
+  enum Field : uint32_t {
+    kId = 1 << 0,
+    kAuthor = 1 << 1,
+    kText = 1 << 2,
+    kCreatedTime = 1 << 3,
+    kAllFields = kId | kAuthor | kText | kCreatedTime,
+  };
+
+  CommentsQuery()
+      : max_count{0},
+        fields{kAllFields},
+        author{},
+        keyword{} {}
+
+  /// 0 for no limit. The oldest ones after `created_time` are kept,
+  /// so that polling moves on without skipping any.
+  uint32_t max_count;
+
+  /// Bits of `Field` to send back; the others decode as empty.
+  uint32_t fields;
+
+  /// If not empty, only the comments by this author.
+  std::wstring author;
+
+  /// If not empty, only the comments containing this.
+  std::wstring keyword;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_COMMENT_COMMENTS_QUERY_H_
@@ -0,0 +1,96 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_CONNECT_HEARTBEAT_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_CONNECT_HEARTBEAT_H_
+
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/metric/latency_histogram.h"
+
+
+namespace ncstreamer_remote {
+struct HeartbeatPolicy {
+  /// Between pings. 0 for no heartbeat.
+  uint32_t interval_ms;
+
+  /// A ping not answered within this is missed.
+  uint32_t pong_timeout_ms;
+
+  /// The connection is given up after this many missed pongs in a row.
+  uint32_t max_missed_pongs;
+};
+
+
+enum class ConnectionState {
+  kDisconnected,
+  kConnecting,
+  kConnected,
+};
+
+
+struct ConnectionInfo {
+  ConnectionState state;
+  uint64_t time_in_state_ms;
+
+  /// 0 until a pong is received on the connection.
+  uint64_t last_rtt_us;
+  uint32_t missed_pongs;
+
+  /// Connections opened after the first one.
+  uint64_t reconnects;
+
+  /// Whether the bulk messages have a connection of their own.
+  bool bulk_connected;
+};
+
+
+/// WebSocket ping/pong bookkeeping of a connection:
+/// which ping is in flight, the round trip times of the pongs,
+/// and the missed pongs telling a hung peer.
+/// It is driven on the io thread, and read from any thread.
+class Heartbeat {
+ public:
+  Heartbeat();
+  virtual ~Heartbeat();
+
+  /// On a new connection.
+  void Reset();
+
+  /// @return Whether a ping may be sent, none being in flight.
+  bool ShouldPing() const { return awaiting_pong_ == false; }
+
+  /// @return The payload of the ping, to tell its pong by.
+  std::string OnPing(uint64_t now_us);
+
+  /// @return Whether it was the pong of the ping in flight.
+  bool OnPong(const std::string &payload, uint64_t now_us);
+
+  /// @return The missed pongs in a row, including this.
+  uint32_t OnPongTimeout(const std::string &payload);
+
+  uint64_t last_rtt_us() const { return last_rtt_us_; }
+  uint32_t missed_pongs() const { return missed_pongs_; }
+  const LatencyHistogram &rtt_histogram() const { return rtt_histogram_; }
+
+ private:
+  Heartbeat(const Heartbeat &) = delete;
+  Heartbeat &operator=(const Heartbeat &) = delete;
+
+  uint64_t sequence_;
+  uint64_t ping_sent_us_;
+  bool awaiting_pong_;
+
+  std::atomic<uint64_t> last_rtt_us_;
+  std::atomic<uint32_t> missed_pongs_;
+  LatencyHistogram rtt_histogram_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_CONNECT_HEARTBEAT_H_
@@ -0,0 +1,76 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_CONNECT_PORT_DISCOVERY_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_CONNECT_PORT_DISCOVERY_H_
+
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+
+namespace ncstreamer_remote {
+struct PortDiscoveryPolicy {
+  /// Probed all at once when connecting to the current port fails.
+  /// Empty for no discovery.
+  std::vector<uint16_t> ports;
+
+  /// Each probe is given up after this, so is the discovery.
+  uint32_t probe_timeout_ms;
+
+  /// The port found is saved to this file for the next launch.
+  /// Empty for none.
+  std::string cache_path;
+};
+
+
+/// The port NCStreamer was found on last, kept in a file.
+class PortCache {
+ public:
+  explicit PortCache(const std::string &path);
+  virtual ~PortCache();
+
+  /// @return 0 if none.
+  uint16_t Load() const;
+  void Save(uint16_t port) const;
+
+ private:
+  std::string path_;
+};
+
+
+/// Saves ports into their caches on one thread of its own,
+/// started on saving first, so that the caller never waits on the disk.
+/// Of the ports saved meanwhile, only the last one is written.
+class PortCacheWriter {
+ public:
+  PortCacheWriter();
+  /// Writes the port pending, if any.
+  virtual ~PortCacheWriter();
+
+  void Save(const std::string &path, uint16_t port);
+
+ private:
+  PortCacheWriter(const PortCacheWriter &) = delete;
+  PortCacheWriter &operator=(const PortCacheWriter &) = delete;
+
+  void Run();
+
+  std::mutex mutex_;
+  std::condition_variable pending_changed_;
+  std::string pending_path_;
+  uint16_t pending_port_;
+  bool pending_;
+  bool stopping_;
+  std::thread thread_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_CONNECT_PORT_DISCOVERY_H_
@@ -0,0 +1,61 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_CONNECT_RECONNECT_BACKOFF_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_CONNECT_RECONNECT_BACKOFF_H_
+
+
+#include <cstdint>
+#include <random>
+
+
+namespace ncstreamer_remote {
+struct ReconnectPolicy {
+  /// The delay before the first retry.
+  uint32_t initial_delay_ms;
+
+  /// The delay is multiplied by this on every failed retry.
+  double multiplier;
+
+  /// The delay never grows beyond this.
+  uint32_t max_delay_ms;
+
+  /// Up to this fraction of each delay is taken off at random,
+  /// so that many clients don't retry in step. 0 to 1.
+  double jitter;
+};
+
+
+/// Delays between reconnection attempts, growing exponentially
+/// up to a cap, with jitter. It is driven on the io thread.
+class ReconnectBackoff {
+ public:
+  /// @param seed Of the jitter, so that a sequence can be reproduced.
+  ReconnectBackoff(const ReconnectPolicy &policy, uint32_t seed);
+  virtual ~ReconnectBackoff();
+
+  void SetPolicy(const ReconnectPolicy &policy);
+
+  /// @return The delay before the next attempt, counting it.
+  uint32_t NextDelayMs();
+
+  /// Back to the initial delay, on connected or on a sign of NCStreamer.
+  void Reset();
+
+  uint32_t attempts() const { return attempts_; }
+
+ private:
+  ReconnectBackoff(const ReconnectBackoff &) = delete;
+  ReconnectBackoff &operator=(const ReconnectBackoff &) = delete;
+
+  ReconnectPolicy policy_;
+  std::minstd_rand random_;
+  double delay_ms_;
+  uint32_t attempts_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_CONNECT_RECONNECT_BACKOFF_H_
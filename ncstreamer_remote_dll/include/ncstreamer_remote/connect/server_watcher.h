@@ -0,0 +1,44 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_CONNECT_SERVER_WATCHER_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_CONNECT_SERVER_WATCHER_H_
+
+
+#include <functional>
+#include <string>
+
+
+namespace ncstreamer_remote {
+/// Signals as soon as a window of the given title shows up,
+/// which is when NCStreamer has just started,
+/// so that reconnection need not wait out its backoff.
+/// Window events are hooked system-wide, without polling,
+/// on one thread shared by all the watchers in the process.
+class ServerWatcher {
+ public:
+  using AppearHandler = std::function<void()>;
+
+  /// @param appear_handler Called on the hook thread
+  ///        until this is destroyed.
+  ServerWatcher(
+      const std::wstring &window_title,
+      const AppearHandler &appear_handler);
+  virtual ~ServerWatcher();
+
+  /// Called by the hook thread.
+  void OnWindowShown(const std::wstring &window_title);
+
+ private:
+  ServerWatcher(const ServerWatcher &) = delete;
+  ServerWatcher &operator=(const ServerWatcher &) = delete;
+
+  std::wstring window_title_;
+  AppearHandler appear_handler_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_CONNECT_SERVER_WATCHER_H_
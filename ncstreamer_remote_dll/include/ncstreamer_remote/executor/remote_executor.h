@@ -0,0 +1,56 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_EXECUTOR_REMOTE_EXECUTOR_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_EXECUTOR_REMOTE_EXECUTOR_H_
+
+
+#include <memory>
+#include <thread>  // NOLINT
+
+#include "boost/asio/io_service.hpp"
+
+
+namespace ncstreamer_remote {
+/// The io thread of NcStreamerRemote clients.
+/// Any number of clients may share one, each handled on this thread only.
+/// It must outlive the clients sharing it.
+class RemoteExecutor {
+ public:
+  RemoteExecutor()
+      : io_service_{},
+        io_service_work_{new boost::asio::io_service::work{io_service_}},
+        thread_{} {
+    thread_ = std::thread{[this]() {
+      io_service_.run();
+    }};
+  }
+
+  virtual ~RemoteExecutor() {
+    io_service_work_.reset();
+    io_service_.stop();
+    if (thread_.joinable() == true) {
+      thread_.join();
+    }
+  }
+
+  boost::asio::io_service &io_service() { return io_service_; }
+
+  bool RunsInThisThread() const {
+    return std::this_thread::get_id() == thread_.get_id();
+  }
+
+ private:
+  RemoteExecutor(const RemoteExecutor &) = delete;
+  RemoteExecutor &operator=(const RemoteExecutor &) = delete;
+
+  boost::asio::io_service io_service_;
+  std::unique_ptr<boost::asio::io_service::work> io_service_work_;
+  std::thread thread_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_EXECUTOR_REMOTE_EXECUTOR_H_
@@ -0,0 +1,84 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_HANDLER_HANDLER_MEMORY_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_HANDLER_HANDLER_MEMORY_H_
+
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/memory/memory_resource.h"
+
+
+namespace ncstreamer_remote {
+/// Memory for the one handler of an owner pending at a time,
+/// which asio takes through the allocation hooks of HandlerWithMemory,
+/// so that posting the handler doesn't allocate.
+/// Another handler posted while the first is pending,
+/// or one too large, takes the memory from `upstream`.
+class HandlerMemory {
+ public:
+  static const std::size_t kSize = 128;
+
+  explicit HandlerMemory(MemoryResource *upstream);
+  virtual ~HandlerMemory();
+
+  void *Allocate(std::size_t size);
+  void Deallocate(void *p, std::size_t size);
+
+ private:
+  HandlerMemory(const HandlerMemory &) = delete;
+  HandlerMemory &operator=(const HandlerMemory &) = delete;
+
+  MemoryResource *upstream_;
+  std::aligned_storage<kSize>::type storage_;
+  std::atomic_bool in_use_;
+};
+
+
+/// A handler allocated by asio in a HandlerMemory.
+template <typename Handler>
+class HandlerWithMemory {
+ public:
+  HandlerWithMemory(HandlerMemory *memory, Handler handler)
+      : memory_{memory},
+        handler_(std::move(handler)) {}
+
+  void operator()() {
+    handler_();
+  }
+
+  friend void *asio_handler_allocate(
+      std::size_t size,
+      HandlerWithMemory *self) {
+    return self->memory_->Allocate(size);
+  }
+
+  friend void asio_handler_deallocate(
+      void *p,
+      std::size_t size,
+      HandlerWithMemory *self) {
+    self->memory_->Deallocate(p, size);
+  }
+
+ private:
+  HandlerMemory *memory_;
+  Handler handler_;
+};
+
+
+template <typename Handler>
+HandlerWithMemory<Handler> BindHandlerMemory(
+    HandlerMemory *memory,
+    Handler handler) {
+  return HandlerWithMemory<Handler>{memory, std::move(handler)};
+}
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_HANDLER_HANDLER_MEMORY_H_
@@ -0,0 +1,202 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_HANDLER_INPLACE_FUNCTION_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_HANDLER_INPLACE_FUNCTION_H_
+
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace ncstreamer_remote {
+/// Big enough for a lambda capturing a few strings,
+/// and for a whole std::function on every supported toolset.
+static const std::size_t kInplaceFunctionCapacity =
+    sizeof(std::function<void()>) < 64 ? 64 : sizeof(std::function<void()>);
+
+
+/// Move-only callable holding its target in a fixed-size inline buffer.
+/// Unlike std::function it never allocates;
+/// a target that doesn't fit is rejected at compile time.
+template <typename Signature,
+          std::size_t Capacity = kInplaceFunctionCapacity>
+class InplaceFunction;
+
+
+template <typename R, typename... Args, std::size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+ private:
+  template <typename F>
+  struct IsTarget {
+    using Functor = typename std::decay<F>::type;
+    static const bool value =
+        !std::is_same<Functor, InplaceFunction>::value &&
+        !std::is_same<Functor, std::nullptr_t>::value;
+  };
+
+ public:
+  InplaceFunction()
+      : storage_{},
+        ops_{nullptr} {}
+
+  InplaceFunction(std::nullptr_t)  // NOLINT
+      : storage_{},
+        ops_{nullptr} {}
+
+  template <typename F,
+            typename = typename std::enable_if<IsTarget<F>::value>::type>
+  InplaceFunction(F &&f)  // NOLINT
+      : storage_{},
+        ops_{nullptr} {
+    Assign(std::forward<F>(f));
+  }
+
+  InplaceFunction(InplaceFunction &&other)
+      : storage_{},
+        ops_{nullptr} {
+    MoveFrom(&other);
+  }
+
+  ~InplaceFunction() {
+    Reset();
+  }
+
+  InplaceFunction &operator=(InplaceFunction &&other) {
+    if (this != &other) {
+      Reset();
+      MoveFrom(&other);
+    }
+    return *this;
+  }
+
+  InplaceFunction &operator=(std::nullptr_t) {
+    Reset();
+    return *this;
+  }
+
+  template <typename F,
+            typename = typename std::enable_if<IsTarget<F>::value>::type>
+  InplaceFunction &operator=(F &&f) {
+    Reset();
+    Assign(std::forward<F>(f));
+    return *this;
+  }
+
+  explicit operator bool() const {
+    return ops_ != nullptr;
+  }
+
+  R operator()(Args... args) const {
+    if (!ops_) {
+      throw std::bad_function_call{};
+    }
+    return ops_->invoke(
+        const_cast<Storage *>(&storage_), std::forward<Args>(args)...);
+  }
+
+  void Reset() {
+    if (ops_) {
+      ops_->destroy(&storage_);
+      ops_ = nullptr;
+    }
+  }
+
+ private:
+  using Storage = typename std::aligned_storage<Capacity>::type;
+
+  struct Ops {
+    R (*invoke)(void *target, Args &&... args);
+    void (*move)(void *to, void *from);
+    void (*destroy)(void *target);
+  };
+
+  template <typename Functor>
+  struct Target {
+    static R Invoke(void *target, Args &&... args) {
+      return (*static_cast<Functor *>(target))(std::forward<Args>(args)...);
+    }
+
+    static void Move(void *to, void *from) {
+      Functor *source = static_cast<Functor *>(from);
+      new (to) Functor(std::move(*source));
+      source->~Functor();
+    }
+
+    static void Destroy(void *target) {
+      static_cast<Functor *>(target)->~Functor();
+    }
+
+    static const Ops kOps;
+  };
+
+  InplaceFunction(const InplaceFunction &) = delete;
+  InplaceFunction &operator=(const InplaceFunction &) = delete;
+
+  template <typename F>
+  void Assign(F &&f) {
+    using Functor = typename std::decay<F>::type;
+    static_assert(sizeof(Functor) <= Capacity,
+                  "the callable is too large for InplaceFunction");
+    static_assert(std::alignment_of<Functor>::value <=
+                      std::alignment_of<Storage>::value,
+                  "the callable is over-aligned for InplaceFunction");
+
+    if (IsEmpty(f) == true) {
+      return;
+    }
+    new (&storage_) Functor(std::forward<F>(f));
+    ops_ = &Target<Functor>::kOps;
+  }
+
+  void MoveFrom(InplaceFunction *other) {
+    if (!other->ops_) {
+      return;
+    }
+    other->ops_->move(&storage_, &other->storage_);
+    ops_ = other->ops_;
+    other->ops_ = nullptr;
+  }
+
+  template <typename F>
+  static bool IsEmpty(const F &/*f*/) {
+    return false;
+  }
+
+  template <typename S>
+  static bool IsEmpty(const std::function<S> &f) {
+    return !f;
+  }
+
+  Storage storage_;
+  const Ops *ops_;
+};
+
+
+template <typename R, typename... Args, std::size_t Capacity>
+template <typename Functor>
+const typename InplaceFunction<R(Args...), Capacity>::Ops
+    InplaceFunction<R(Args...), Capacity>::Target<Functor>::kOps{
+        &InplaceFunction<R(Args...), Capacity>::Target<Functor>::Invoke,
+        &InplaceFunction<R(Args...), Capacity>::Target<Functor>::Move,
+        &InplaceFunction<R(Args...), Capacity>::Target<Functor>::Destroy};
+
+
+/// Maps a std::function handler type to its InplaceFunction counterpart.
+template <typename Handler>
+struct InplaceOf;
+
+
+template <typename Signature>
+struct InplaceOf<std::function<Signature>> {
+  using type = InplaceFunction<Signature>;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_HANDLER_INPLACE_FUNCTION_H_
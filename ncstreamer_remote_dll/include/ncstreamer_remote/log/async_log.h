@@ -0,0 +1,117 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_LOG_ASYNC_LOG_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_LOG_ASYNC_LOG_H_
+
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>  // NOLINT
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+
+namespace ncstreamer_remote {
+struct AsyncLogPolicy {
+  /// Of each of the access and error logs. Lines not fitting are dropped.
+  std::size_t ring_size;
+
+  /// The file is rotated once it grows beyond this. 0 for never.
+  uint64_t max_file_size;
+
+  /// Rotated files kept, as `path.1` the newest.
+  uint32_t max_rotated_files;
+};
+
+
+struct AsyncLogStats {
+  uint64_t written_bytes;
+  uint64_t dropped_bytes;
+  uint64_t rotations;
+};
+
+
+/// Log file written on a flusher thread of its own.
+/// A line written to either stream is just copied into a lock-free ring,
+/// so a writer never waits on the disk.
+/// Each stream is written by one thread at a time,
+/// as the websocketpp loggers do under their own locks.
+class AsyncLog {
+ public:
+  AsyncLog(const std::string &path, const AsyncLogPolicy &policy);
+  /// Writes out the lines left.
+  virtual ~AsyncLog();
+
+  std::ostream *access_stream() { return &access_stream_; }
+  std::ostream *error_stream() { return &error_stream_; }
+
+  AsyncLogStats GetStats() const;
+
+ private:
+  /// Single-producer/single-consumer ring of bytes behind a stream.
+  /// A line is published on flush, or in pieces if longer than a piece.
+  class Ring : public std::streambuf {
+   public:
+    explicit Ring(std::size_t size);
+    virtual ~Ring();
+
+    /// On the flusher thread.
+    /// @return The bytes written to `out`.
+    std::size_t DrainTo(std::ostream *out);
+
+    uint64_t dropped_bytes() const { return dropped_bytes_; }
+
+   protected:
+    int_type overflow(int_type c) override;
+    int sync() override;
+
+   private:
+    static const std::size_t kPieceSize = 512;
+
+    void Publish();
+
+    std::vector<char> buffer_;
+    std::size_t mask_;
+    std::atomic<std::size_t> head_;
+    std::atomic<std::size_t> tail_;
+    std::atomic<uint64_t> dropped_bytes_;
+    std::vector<char> piece_;
+  };
+
+  AsyncLog(const AsyncLog &) = delete;
+  AsyncLog &operator=(const AsyncLog &) = delete;
+
+  void Flush();
+  void Rotate();
+
+  std::string path_;
+  AsyncLogPolicy policy_;
+
+  Ring access_ring_;
+  Ring error_ring_;
+  std::ostream access_stream_;
+  std::ostream error_stream_;
+
+  std::ofstream file_;
+  uint64_t file_size_;
+  std::atomic<uint64_t> written_bytes_;
+  std::atomic<uint64_t> rotations_;
+
+  std::mutex stop_mutex_;
+  std::condition_variable stop_condition_;
+  bool stopping_;
+  std::thread flusher_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_LOG_ASYNC_LOG_H_
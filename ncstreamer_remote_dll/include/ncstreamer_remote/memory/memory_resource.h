@@ -0,0 +1,180 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_MEMORY_MEMORY_RESOURCE_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_MEMORY_MEMORY_RESOURCE_H_
+
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+
+namespace ncstreamer_remote {
+/// Source of raw memory for the library.
+/// Shaped after std::pmr::memory_resource,
+/// so that a game engine can hand its own allocator to NCStreamer-Remote.
+class MemoryResource {
+ public:
+  static const std::size_t kMaxAlignment =
+      std::alignment_of<std::max_align_t>::value;
+
+  virtual ~MemoryResource() {}
+
+  void *Allocate(std::size_t bytes, std::size_t alignment = kMaxAlignment) {
+    return DoAllocate(bytes, alignment);
+  }
+
+  void Deallocate(
+      void *p, std::size_t bytes, std::size_t alignment = kMaxAlignment) {
+    DoDeallocate(p, bytes, alignment);
+  }
+
+  bool IsEqual(const MemoryResource &other) const {
+    return (this == &other) || DoIsEqual(other);
+  }
+
+ protected:
+  virtual void *DoAllocate(std::size_t bytes, std::size_t alignment) = 0;
+  virtual void DoDeallocate(
+      void *p, std::size_t bytes, std::size_t alignment) = 0;
+  virtual bool DoIsEqual(const MemoryResource &other) const = 0;
+};
+
+
+/// @return The resource forwarding to global operator new/delete.
+MemoryResource *GetNewDeleteResource();
+
+/// @return The resource set by SetDefaultMemoryResource(),
+///         or GetNewDeleteResource() if none is set.
+MemoryResource *GetDefaultMemoryResource();
+
+/// @param resource Null to restore GetNewDeleteResource().
+/// @return The previous default resource.
+MemoryResource *SetDefaultMemoryResource(MemoryResource *resource);
+
+/// @return The resource installed on this thread by ScopedMemoryResource,
+///         or GetDefaultMemoryResource() if none is installed.
+MemoryResource *GetCurrentMemoryResource();
+
+
+/// Installs a resource as the current one of this thread for its lifetime.
+class ScopedMemoryResource {
+ public:
+  explicit ScopedMemoryResource(MemoryResource *resource);
+  ~ScopedMemoryResource();
+
+ private:
+  ScopedMemoryResource(const ScopedMemoryResource &) = delete;
+  ScopedMemoryResource &operator=(const ScopedMemoryResource &) = delete;
+
+  MemoryResource *previous_;
+};
+
+
+/// Bump allocator over chunks from an upstream resource.
+/// Deallocate() is a no-op; Release() rewinds everything at once,
+/// keeping one chunk big enough for the next round.
+class MonotonicBufferResource : public MemoryResource {
+ public:
+  MonotonicBufferResource(
+      MemoryResource *upstream,
+      std::size_t initial_size);
+  explicit MonotonicBufferResource(MemoryResource *upstream);
+  virtual ~MonotonicBufferResource();
+
+  void Release();
+
+  MemoryResource *upstream() const { return upstream_; }
+
+ protected:
+  void *DoAllocate(std::size_t bytes, std::size_t alignment) override;
+  void DoDeallocate(
+      void *p, std::size_t bytes, std::size_t alignment) override;
+  bool DoIsEqual(const MemoryResource &other) const override;
+
+ private:
+  struct Chunk {
+    Chunk *next;
+    std::size_t size;
+  };
+
+  MonotonicBufferResource(const MonotonicBufferResource &) = delete;
+  MonotonicBufferResource &operator=(
+      const MonotonicBufferResource &) = delete;
+
+  void AddChunk(std::size_t min_size);
+  void FreeChunks(Chunk *chunk);
+
+  MemoryResource *upstream_;
+  std::size_t next_chunk_size_;
+  Chunk *first_chunk_;
+  Chunk *current_chunk_;
+  char *cursor_;
+  char *end_;
+};
+
+
+/// STL allocator drawing from a MemoryResource,
+/// like std::pmr::polymorphic_allocator.
+/// Default-constructed ones use GetCurrentMemoryResource().
+template <typename T>
+class ResourceAllocator {
+ public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = ResourceAllocator<U>;
+  };
+
+  ResourceAllocator()
+      : resource_{GetCurrentMemoryResource()} {}
+
+  ResourceAllocator(MemoryResource *resource)  // NOLINT
+      : resource_{resource} {}
+
+  template <typename U>
+  ResourceAllocator(const ResourceAllocator<U> &other)  // NOLINT
+      : resource_{other.resource()} {}
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(resource_->Allocate(
+        n * sizeof(T), std::alignment_of<T>::value));
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    resource_->Deallocate(p, n * sizeof(T), std::alignment_of<T>::value);
+  }
+
+  ResourceAllocator select_on_container_copy_construction() const {
+    return ResourceAllocator{};
+  }
+
+  MemoryResource *resource() const { return resource_; }
+
+ private:
+  MemoryResource *resource_;
+};
+
+
+template <typename T, typename U>
+bool operator==(const ResourceAllocator<T> &a, const ResourceAllocator<U> &b) {
+  return a.resource()->IsEqual(*b.resource());
+}
+
+
+template <typename T, typename U>
+bool operator!=(const ResourceAllocator<T> &a, const ResourceAllocator<U> &b) {
+  return !(a == b);
+}
+
+
+using ResourceString =
+    std::basic_string<char, std::char_traits<char>, ResourceAllocator<char>>;
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_MEMORY_MEMORY_RESOURCE_H_
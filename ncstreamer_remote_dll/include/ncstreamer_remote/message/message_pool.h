@@ -0,0 +1,374 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_MESSAGE_MESSAGE_POOL_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_MESSAGE_MESSAGE_POOL_H_
+
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(disable: 4267)
+#endif
+#include "websocketpp/common/memory.hpp"
+#include "websocketpp/config/asio_no_tls_client.hpp"
+#include "websocketpp/frame.hpp"
+#include "websocketpp/message_buffer/alloc.hpp"
+#include "websocketpp/message_buffer/message.hpp"
+#ifdef _MSC_VER
+#pragma warning(default: 4267)
+#endif
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/memory/memory_resource.h"
+
+
+namespace ncstreamer_remote {
+struct MessagePoolStats {
+  /// Messages handed out from the free list.
+  uint64_t hits;
+
+  /// Messages newly allocated because the free list was empty.
+  uint64_t misses;
+
+  /// Messages returned to the free list.
+  uint64_t recycled;
+
+  /// Messages deleted because the free list was full
+  /// or their payload grew beyond the retained size.
+  uint64_t dropped;
+};
+
+
+/// Cache of equally sized raw blocks.
+/// It backs the shared_ptr control blocks of pooled messages
+/// so that handing a recycled message out doesn't touch the heap.
+/// Each allocator shares the ownership of the cache,
+/// as the last control block is freed after its deleter,
+/// which may hold the last reference to the pool, is gone.
+class BlockCache {
+ public:
+  BlockCache(MemoryResource *upstream, std::size_t capacity)
+      : upstream_{upstream},
+        mutex_{},
+        block_size_{0},
+        capacity_{capacity},
+        free_blocks_{} {
+    free_blocks_.reserve(capacity_);
+  }
+
+  ~BlockCache() {
+    for (void *block : free_blocks_) {
+      upstream_->Deallocate(block, block_size_);
+    }
+  }
+
+  void *Allocate(std::size_t size) {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      if (block_size_ == 0) {
+        block_size_ = size;
+      }
+      if (size == block_size_ && free_blocks_.empty() == false) {
+        void *block = free_blocks_.back();
+        free_blocks_.pop_back();
+        return block;
+      }
+    }
+    return upstream_->Allocate(size);
+  }
+
+  void Deallocate(void *block, std::size_t size) {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      if (size == block_size_ && free_blocks_.size() < capacity_) {
+        free_blocks_.emplace_back(block);
+        return;
+      }
+    }
+    upstream_->Deallocate(block, size);
+  }
+
+ private:
+  BlockCache(const BlockCache &) = delete;
+  BlockCache &operator=(const BlockCache &) = delete;
+
+  MemoryResource *upstream_;
+  std::mutex mutex_;
+  std::size_t block_size_;
+  std::size_t capacity_;
+  std::vector<void *> free_blocks_;
+};
+
+
+template <typename T>
+class BlockAllocator {
+ public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = BlockAllocator<U>;
+  };
+
+  explicit BlockAllocator(
+      const websocketpp::lib::shared_ptr<BlockCache> &cache)
+      : cache_{cache} {}
+
+  template <typename U>
+  BlockAllocator(const BlockAllocator<U> &other)  // NOLINT
+      : cache_{other.cache()} {}
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(cache_->Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    cache_->Deallocate(p, n * sizeof(T));
+  }
+
+  const websocketpp::lib::shared_ptr<BlockCache> &cache() const {
+    return cache_;
+  }
+
+ private:
+  websocketpp::lib::shared_ptr<BlockCache> cache_;
+};
+
+
+template <typename T, typename U>
+bool operator==(const BlockAllocator<T> &a, const BlockAllocator<U> &b) {
+  return a.cache() == b.cache();
+}
+
+
+template <typename T, typename U>
+bool operator!=(const BlockAllocator<T> &a, const BlockAllocator<U> &b) {
+  return a.cache() != b.cache();
+}
+
+
+class MessagePoolBase {
+ public:
+  virtual ~MessagePoolBase() {}
+};
+
+
+/// @return The pool installed on this thread by ScopedMessagePool,
+///         or null if none is installed.
+const websocketpp::lib::shared_ptr<MessagePoolBase> *GetCurrentMessagePool();
+
+
+/// Installs `pool` on this thread while in scope,
+/// for the connections created meanwhile to draw their messages from,
+/// as websocketpp constructs their message managers by itself.
+class ScopedMessagePool {
+ public:
+  explicit ScopedMessagePool(
+      const websocketpp::lib::shared_ptr<MessagePoolBase> &pool);
+  ~ScopedMessagePool();
+
+ private:
+  ScopedMessagePool(const ScopedMessagePool &) = delete;
+  ScopedMessagePool &operator=(const ScopedMessagePool &) = delete;
+
+  websocketpp::lib::shared_ptr<MessagePoolBase> pool_;
+  const websocketpp::lib::shared_ptr<MessagePoolBase> *previous_;
+};
+
+
+/// Free list of websocketpp messages of the connections of a client.
+/// A message comes back here when its last shared_ptr is released,
+/// keeping the capacity of its payload for the next frame.
+/// Messages and their control blocks are drawn from `resource`.
+template <typename Message>
+class MessagePool
+    : public MessagePoolBase,
+      public websocketpp::lib::enable_shared_from_this<MessagePool<Message>> {
+ public:
+  using MessagePtr = typename Message::ptr;
+  using ManagerPtr = typename Message::con_msg_man_ptr;
+
+  explicit MessagePool(MemoryResource *resource)
+      : resource_{resource},
+        mutex_{},
+        free_messages_{},
+        control_blocks_{
+            new BlockCache{resource_, kMaxFreeMessages * 2}},
+        hits_{0},
+        misses_{0},
+        recycled_{0},
+        dropped_{0} {
+    free_messages_.reserve(kMaxFreeMessages);
+  }
+
+  MessagePtr Acquire(
+      const ManagerPtr &manager,
+      websocketpp::frame::opcode::value op,
+      std::size_t size) {
+    Message *msg{nullptr};
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      if (free_messages_.empty() == false) {
+        msg = free_messages_.back();
+        free_messages_.pop_back();
+      }
+    }
+
+    if (msg) {
+      ++hits_;
+      msg->set_opcode(op);
+      msg->get_raw_payload().reserve(size);
+    } else {
+      ++misses_;
+      void *storage = resource_->Allocate(
+          sizeof(Message), std::alignment_of<Message>::value);
+      msg = new (storage) Message{manager, op, size};
+    }
+
+    return MessagePtr{
+        msg,
+        Recycler{this->shared_from_this()},
+        BlockAllocator<Message>{control_blocks_}};
+  }
+
+  MessagePoolStats GetStats() const {
+    MessagePoolStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.recycled = recycled_;
+    stats.dropped = dropped_;
+    return stats;
+  }
+
+  ~MessagePool() {
+    for (Message *msg : free_messages_) {
+      Destroy(msg);
+    }
+  }
+
+ private:
+  class Recycler {
+   public:
+    explicit Recycler(const websocketpp::lib::shared_ptr<MessagePool> &pool)
+        : pool_{pool} {}
+
+    void operator()(Message *msg) const {
+      pool_->Release(msg);
+    }
+
+   private:
+    websocketpp::lib::shared_ptr<MessagePool> pool_;
+  };
+
+  static const std::size_t kMaxFreeMessages = 64;
+  static const std::size_t kMaxRetainedPayload = 256 * 1024;
+
+  MessagePool(const MessagePool &) = delete;
+  MessagePool &operator=(const MessagePool &) = delete;
+
+  void Release(Message *msg) {
+    if (msg->get_raw_payload().capacity() <= kMaxRetainedPayload) {
+      msg->set_prepared(false);
+      msg->set_fin(true);
+      msg->set_terminal(false);
+      msg->set_compressed(false);
+      msg->set_header(std::string{});
+      msg->get_raw_payload().clear();
+
+      std::lock_guard<std::mutex> lock{mutex_};
+      if (free_messages_.size() < kMaxFreeMessages) {
+        free_messages_.emplace_back(msg);
+        ++recycled_;
+        return;
+      }
+    }
+
+    ++dropped_;
+    Destroy(msg);
+  }
+
+  void Destroy(Message *msg) {
+    msg->~Message();
+    resource_->Deallocate(
+        msg, sizeof(Message), std::alignment_of<Message>::value);
+  }
+
+  MemoryResource *resource_;
+  std::mutex mutex_;
+  std::vector<Message *> free_messages_;
+  websocketpp::lib::shared_ptr<BlockCache> control_blocks_;
+
+  std::atomic<uint64_t> hits_;
+  std::atomic<uint64_t> misses_;
+  std::atomic<uint64_t> recycled_;
+  std::atomic<uint64_t> dropped_;
+};
+
+
+/// Connection message manager for websocketpp,
+/// which draws every inbound and outbound message from the `MessagePool`
+/// installed by ScopedMessagePool on constructing it,
+/// or else from a pool of its own on the default MemoryResource.
+template <typename Message>
+class PooledMessageManager
+    : public websocketpp::lib::enable_shared_from_this<
+          PooledMessageManager<Message>> {
+ public:
+  typedef PooledMessageManager<Message> type;
+  typedef websocketpp::lib::shared_ptr<PooledMessageManager> ptr;
+  typedef websocketpp::lib::weak_ptr<PooledMessageManager> weak_ptr;
+  typedef typename Message::ptr message_ptr;
+
+  PooledMessageManager()
+      : pool_{} {
+    const websocketpp::lib::shared_ptr<MessagePoolBase> *current =
+        GetCurrentMessagePool();
+    if (current) {
+      pool_ = websocketpp::lib::static_pointer_cast<MessagePool<Message>>(
+          *current);
+    } else {
+      pool_.reset(new MessagePool<Message>{GetDefaultMemoryResource()});
+    }
+  }
+
+  message_ptr get_message() {
+    return pool_->Acquire(
+        type::shared_from_this(), websocketpp::frame::opcode::text, 0);
+  }
+
+  message_ptr get_message(websocketpp::frame::opcode::value op, size_t size) {
+    return pool_->Acquire(type::shared_from_this(), op, size);
+  }
+
+  /// Messages go back to the pool by their deleter, not by this.
+  bool recycle(Message * /*msg*/) {
+    return false;
+  }
+
+ private:
+  websocketpp::lib::shared_ptr<MessagePool<Message>> pool_;
+};
+
+
+struct PooledAsioClient : public websocketpp::config::asio_client {
+  typedef PooledAsioClient type;
+  typedef websocketpp::config::asio_client base;
+
+  typedef websocketpp::message_buffer::message<PooledMessageManager>
+      message_type;
+  typedef PooledMessageManager<message_type> con_msg_manager_type;
+  typedef websocketpp::message_buffer::alloc::endpoint_msg_manager<
+      con_msg_manager_type> endpoint_msg_manager_type;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_MESSAGE_MESSAGE_POOL_H_
@@ -0,0 +1,63 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_METRIC_LATENCY_HISTOGRAM_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_METRIC_LATENCY_HISTOGRAM_H_
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace ncstreamer_remote {
+struct LatencyStats {
+  uint64_t count;
+  uint64_t min_us;
+  uint64_t max_us;
+  uint64_t mean_us;
+
+  /// Upper bounds of the buckets the percentiles fall in,
+  /// within 25% of the exact ones.
+  uint64_t p50_us;
+  uint64_t p90_us;
+  uint64_t p99_us;
+};
+
+
+/// Histogram of latencies in microseconds with log-linear buckets:
+/// one per microsecond below 16, then 4 per power of 2.
+/// Recording is lock-free from any thread, and the memory is fixed.
+class LatencyHistogram {
+ public:
+  static const std::size_t kBucketCount = 16 + 4 * (64 - 4);
+
+  LatencyHistogram();
+  virtual ~LatencyHistogram();
+
+  void Record(uint64_t latency_us);
+  void Clear();
+
+  LatencyStats GetStats() const;
+
+  /// @return The largest latency counted in the bucket.
+  static uint64_t GetBucketUpperBound(std::size_t bucket);
+  uint64_t GetBucketCount(std::size_t bucket) const;
+
+ private:
+  LatencyHistogram(const LatencyHistogram &) = delete;
+  LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+  static std::size_t ToBucket(uint64_t latency_us);
+
+  std::atomic<uint64_t> buckets_[kBucketCount];
+  std::atomic<uint64_t> sum_us_;
+  std::atomic<uint64_t> min_us_;
+  std::atomic<uint64_t> max_us_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_METRIC_LATENCY_HISTOGRAM_H_
@@ -0,0 +1,106 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_METRIC_REQUEST_METRICS_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_METRIC_REQUEST_METRICS_H_
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/error/error_types.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/metric/latency_histogram.h"
+
+
+namespace ncstreamer_remote {
+struct RequestTypeMetrics {
+  /// ncstreamer::RemoteMessage::MessageType of the request.
+  int message_type;
+
+  /// Requests sent.
+  uint64_t requests;
+  uint64_t errors;
+
+  /// From the request to sending it, as while connecting.
+  LatencyStats queue_wait;
+  /// From sending the request to its response arriving.
+  LatencyStats wire_rtt;
+  /// From the request to its response handled.
+  LatencyStats latency;
+};
+
+
+struct ErrorCount {
+  /// 0 for a request not sent yet, as rejected busy.
+  int message_type;
+  ErrorCategory category;
+  int code;
+  uint64_t count;
+};
+
+
+struct RequestMetricsSnapshot {
+  std::vector<RequestTypeMetrics> requests;
+  std::vector<ErrorCount> errors;
+
+  /// Inbound messages not parsed into a known type.
+  uint64_t parse_failures;
+};
+
+
+/// Counters and latency histograms per request type,
+/// and error counts per request type, category and code.
+/// Recording is lock-free from any thread, and the memory is fixed.
+class RequestMetrics {
+ public:
+  explicit RequestMetrics(const std::vector<int> &message_types);
+  virtual ~RequestMetrics();
+
+  void OnSent(int message_type, uint64_t queue_wait_us);
+  void OnResponded(int message_type, uint64_t wire_rtt_us, uint64_t latency_us);
+  void OnError(int message_type, ErrorCategory category, int code);
+  void OnParseFailure();
+
+  RequestMetricsSnapshot GetSnapshot() const;
+
+  /// In the OpenMetrics text format, ending with `# EOF`.
+  std::string ToOpenMetrics() const;
+
+ private:
+  struct TypeSlot {
+    TypeSlot() : requests{0}, errors{0} {}
+
+    std::atomic<uint64_t> requests;
+    std::atomic<uint64_t> errors;
+    LatencyHistogram queue_wait;
+    LatencyHistogram wire_rtt;
+    LatencyHistogram latency;
+  };
+
+  /// Open addressing, never removed from.
+  static const std::size_t kErrorSlotCount = 256;
+
+  RequestMetrics(const RequestMetrics &) = delete;
+  RequestMetrics &operator=(const RequestMetrics &) = delete;
+
+  TypeSlot *FindSlot(int message_type) const;
+
+  std::vector<int> message_types_;
+  std::vector<std::unique_ptr<TypeSlot>> slots_;
+  /// Indexed by message type, as they are small.
+  std::vector<TypeSlot *> slots_by_type_;
+
+  std::atomic<uint64_t> error_keys_[kErrorSlotCount];
+  std::atomic<uint64_t> error_counts_[kErrorSlotCount];
+  std::atomic<uint64_t> parse_failures_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_METRIC_REQUEST_METRICS_H_
@@ -0,0 +1,107 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_METRIC_TRACE_RECORDER_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_METRIC_TRACE_RECORDER_H_
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+
+
+namespace ncstreamer_remote {
+enum class TracePhase {
+  /// From the request to its response handled.
+  kRequest = 0,
+  /// From the request to sending it, as while connecting.
+  kQueue,
+  kConnect,
+  /// Writing the request into JSON and handing it to the connection.
+  kSerialize,
+  /// From sending the request to its response arriving,
+  /// on the wire and in NCStreamer.
+  kRemote,
+  /// Reading an inbound message from JSON.
+  kParse,
+  /// The message handler, including the handler of the caller.
+  kHandler,
+};
+
+
+struct TraceStats {
+  /// Spans recorded since the recorder was enabled first.
+  uint64_t recorded;
+
+  /// Spans overwritten by newer ones before being written out.
+  uint64_t overwritten;
+};
+
+
+/// Spans of the phases of requests, kept in a ring of fixed size
+/// and written out in the Chrome trace event format,
+/// which chrome://tracing and Perfetto open.
+/// Recording is lock-free from any thread,
+/// and costs a single load while disabled.
+class TraceRecorder {
+ public:
+  explicit TraceRecorder(std::size_t capacity);
+  virtual ~TraceRecorder();
+
+  /// The ring is allocated on enabling first, and kept after that.
+  void SetEnabled(bool enabled);
+  bool enabled() const {
+    return enabled_.load(std::memory_order_acquire);
+  }
+
+  /// @param request_id 0 for a message not of a request, as an event.
+  void Record(
+      TracePhase phase,
+      int message_type,
+      uint64_t request_id,
+      uint64_t begin_us,
+      uint64_t end_us);
+
+  TraceStats GetStats() const;
+
+  /// JSON of the spans in the ring, oldest first.
+  /// Each request is a track of its own, named by the request ID.
+  std::string ToChromeTrace() const;
+
+ private:
+  struct Span {
+    Span()
+        : sequence{0},
+          phase{TracePhase::kRequest},
+          message_type{0},
+          request_id{0},
+          begin_us{0},
+          end_us{0} {}
+
+    /// 1 + the index of the span written in, 0 while being written.
+    std::atomic<uint64_t> sequence;
+    TracePhase phase;
+    int message_type;
+    uint64_t request_id;
+    uint64_t begin_us;
+    uint64_t end_us;
+  };
+
+  TraceRecorder(const TraceRecorder &) = delete;
+  TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+  const std::size_t capacity_;
+  mutable std::mutex allocation_mutex_;
+  std::unique_ptr<Span[]> spans_;
+  std::atomic_bool enabled_;
+  std::atomic<uint64_t> next_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_METRIC_TRACE_RECORDER_H_
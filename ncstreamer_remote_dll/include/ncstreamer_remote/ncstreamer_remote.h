@@ -15,10 +15,14 @@
 
 
 #include <atomic>
-#include <fstream>
+#include <condition_variable>  // NOLINT
 #include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "boost/asio/io_service.hpp"
@@ -42,10 +46,60 @@ namespace Chrono = std::chrono;
 namespace Chrono = boost::chrono;
 #endif  // _MSC_VER >= 1900
 
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_records.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comments_query.h"
 #include "ncstreamer_remote_dll/include/ncstreamer_remote/error/error_types.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/handler/inplace_function.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/memory/memory_resource.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/message/message_pool.h"
 
 
 namespace ncstreamer_remote {
+/// Defined in their own headers,
+/// which a caller includes for those it uses.
+class AsyncLog;
+struct AsyncLogStats;
+struct CachedStatus;
+class ChatAnalytics;
+struct ChatStats;
+struct Comment;
+class CommentFilter;
+struct CommentFilterRule;
+class CommentStore;
+struct ConnectionInfo;
+enum class ConnectionState;
+class Heartbeat;
+struct HeartbeatPolicy;
+class LatencyHistogram;
+struct LatencyStats;
+struct PollMetrics;
+struct PollPolicy;
+class PollRateCeiling;
+class PollSchedule;
+class PortCacheWriter;
+struct PortDiscoveryPolicy;
+class ReconnectBackoff;
+struct ReconnectPolicy;
+class RemoteExecutor;
+class RequestMetrics;
+struct RequestMetricsSnapshot;
+class ServerWatcher;
+struct SessionReplayMetrics;
+struct SessionSnapshot;
+class SessionState;
+class StatusMirror;
+class TraceRecorder;
+struct TraceStats;
+enum class ViewerResolution;
+struct ViewerPoint;
+class ViewerSeries;
+struct ViewerStats;
+enum class WireDirection : uint8_t;
+struct WireFrame;
+class WireRecorder;
+struct WireReplayStats;
+
+
 class NcStreamerRemote {
  public:
   using ConnectHandler = std::function<void()>;
@@ -85,6 +139,12 @@ class NcStreamerRemote {
 
   using CommentsResponseHandler = std::function<void(
       const std::wstring &msg)>;
+  /// @param msg Only the comments newer than the last event.
+  using CommentsEventHandler = std::function<void(
+      const std::wstring &msg)>;
+  /// @param comments Valid only during the call.
+  using CommentRecordsHandler = std::function<void(
+      const CommentRecords &comments)>;
   using ViewersResponseHandler = std::function<void(
       const std::wstring &viewers)>;
 
@@ -96,12 +156,218 @@ class NcStreamerRemote {
       const std::vector<std::wstring> &mic_devices)>;
   using MicResponseHandler = std::function<void()>;
 
+  template <typename Handler>
+  using Inplace = typename InplaceOf<Handler>::type;
+
   static NCSTREAMER_REMOTE_DLL_API void SetUp(uint16_t remote_port);
+
+  /// @param memory_resource The message buffers, the parse trees and
+  ///        comment records of inbound messages, and the handlers posted
+  ///        to the io thread are drawn from this, which must outlive
+  ///        ShutDown(). Once a kind of request has run a few times,
+  ///        it draws nothing more from it.
+  ///        Left to the global heap on each request are the property tree
+  ///        and UTF-8 conversion of the outbound message, the wide strings
+  ///        and vectors handed to the handlers, the copy of a handler
+  ///        passed as a std::function, and a frame payload outgrowing
+  ///        the recycled buffer it lands in.
+  ///        It also becomes the default resource of the library
+  ///        until ShutDown().
+  static NCSTREAMER_REMOTE_DLL_API void SetUp(
+      uint16_t remote_port,
+      MemoryResource *memory_resource);
+  /// On the port NCStreamer was found on last, or else the default one,
+  /// discovering the port among the default candidates.
   static NCSTREAMER_REMOTE_DLL_API void SetUpDefault();
 
   static NCSTREAMER_REMOTE_DLL_API void ShutDown();
   static NCSTREAMER_REMOTE_DLL_API NcStreamerRemote *Get();
 
+  /// Independent clients, any number of them in a process,
+  /// apart from the one of SetUp() and Get().
+  /// @param memory_resource As of SetUp(), but not made the default one.
+  /// @param executor Shared by clients to handle them on its thread,
+  ///        or nullptr for a thread of the client's own.
+  /// @param log_path Empty for no log.
+  static NCSTREAMER_REMOTE_DLL_API NcStreamerRemote *Create(
+      uint16_t remote_port,
+      MemoryResource *memory_resource,
+      RemoteExecutor *executor,
+      const std::string &log_path);
+
+  /// Closes the connection and waits until none of its handlers is left.
+  /// Never on the thread of the executor.
+  static NCSTREAMER_REMOTE_DLL_API void Destroy(NcStreamerRemote *remote);
+
+  /// A client which never connects, to ReplayWireRecording() into.
+  /// Destroyed by Destroy() as well.
+  static NCSTREAMER_REMOTE_DLL_API NcStreamerRemote *CreateOffline(
+      MemoryResource *memory_resource,
+      RemoteExecutor *executor);
+
+  /// Hit/miss counters of the message buffers of the connections.
+  MessagePoolStats NCSTREAMER_REMOTE_DLL_API GetMessagePoolStats() const;
+
+  /// The log is written on a thread of its own, and rotated by size.
+  /// @param access_channels Of websocketpp::log::alevel.
+  ///        Every frame but the sampled ones is left out by default.
+  /// @param error_channels Of websocketpp::log::elevel.
+  void NCSTREAMER_REMOTE_DLL_API SetLogChannels(
+      uint32_t access_channels,
+      uint32_t error_channels);
+  /// Logs one in `one_in` frames in and out. 0 for none.
+  void NCSTREAMER_REMOTE_DLL_API SetFrameLogSampling(uint32_t one_in);
+  /// All zero without a log.
+  AsyncLogStats NCSTREAMER_REMOTE_DLL_API GetLogStats() const;
+
+  /// While NCStreamer is away, reconnection waits grow by `policy`.
+  /// Once its window shows up, reconnection starts over right away.
+  void NCSTREAMER_REMOTE_DLL_API SetReconnectPolicy(
+      const ReconnectPolicy &policy);
+
+  /// Pings NCStreamer while connected, sampling the round trip times.
+  /// A connection missing `max_missed_pongs` pongs in a row is closed
+  /// and reconnected, as NCStreamer may hang with its socket open.
+  void NCSTREAMER_REMOTE_DLL_API SetHeartbeatPolicy(
+      const HeartbeatPolicy &policy);
+  ConnectionInfo NCSTREAMER_REMOTE_DLL_API GetConnectionInfo() const;
+
+  /// Once connecting to the current port fails while NCStreamer is up,
+  /// the other ports of `policy` are probed all at once,
+  /// and the first one answering a status request becomes current.
+  void NCSTREAMER_REMOTE_DLL_API SetPortDiscovery(
+      const PortDiscoveryPolicy &policy);
+  uint16_t NCSTREAMER_REMOTE_DLL_API GetRemotePort() const;
+
+  /// Sends the bulk requests, like of comments and device searches,
+  /// on a second connection, so that their large responses
+  /// don't hold back the pongs and the streaming events on the first one.
+  /// It is opened and closed along with the first connection,
+  /// and the bulk requests go on the first one while it is not open.
+  /// Either way, the bulk requests are one at a time apart from the rest,
+  /// so that a stop is not turned away as busy during a comments dump.
+  void NCSTREAMER_REMOTE_DLL_API SetBulkConnection(bool enabled);
+  LatencyStats NCSTREAMER_REMOTE_DLL_API GetRttStats() const;
+
+  /// From starting to connect to the connection opened.
+  LatencyStats NCSTREAMER_REMOTE_DLL_API GetConnectLatencyStats() const;
+  /// From the window of NCStreamer showing up
+  /// to the first message from NCStreamer after that.
+  LatencyStats NCSTREAMER_REMOTE_DLL_API GetLaunchToResponseStats() const;
+
+  /// Per request type, counted from each request sent to its response
+  /// handled, and the errors handed to the error handlers.
+  RequestMetricsSnapshot NCSTREAMER_REMOTE_DLL_API GetRequestMetrics() const;
+  /// Same as above, in the OpenMetrics text format.
+  std::string NCSTREAMER_REMOTE_DLL_API GetRequestMetricsText() const;
+
+  /// Records the spans of connecting, queueing, serializing,
+  /// NCStreamer, parsing and handling of each request,
+  /// keeping the latest ones in a ring allocated on enabling first.
+  void NCSTREAMER_REMOTE_DLL_API SetTracing(bool enabled);
+  TraceStats NCSTREAMER_REMOTE_DLL_API GetTraceStats() const;
+  /// In the Chrome trace event format, for chrome://tracing or Perfetto.
+  std::string NCSTREAMER_REMOTE_DLL_API GetChromeTrace() const;
+
+  /// Records every message frame in and out into `path`, replacing it,
+  /// until stopped or another recording starts.
+  bool NCSTREAMER_REMOTE_DLL_API StartWireRecording(const std::string &path);
+  void NCSTREAMER_REMOTE_DLL_API StopWireRecording();
+  /// Dispatches the inbound frames of the recording at `path`
+  /// as if they came from NCStreamer, read in place,
+  /// at the recorded pace or as fast as they are handled,
+  /// into a client of CreateOffline() only.
+  /// The events reach the handlers registered on it, and the local stores
+  /// and statistics are fed, while the responses answer no request of it.
+  /// Blocks until done, so dispatches nothing on the thread of the executor.
+  WireReplayStats NCSTREAMER_REMOTE_DLL_API ReplayWireRecording(
+      const std::string &path,
+      bool at_recorded_pace);
+
+  /// The quality, webcam, chroma key and mic settings accepted last
+  /// are sent again in one batch after reconnecting,
+  /// as NCStreamer forgets them on restart.
+  /// Their responses don't reach the handlers of the original requests,
+  /// and the requests other than the bulk ones meanwhile fail as busy.
+  SessionSnapshot NCSTREAMER_REMOTE_DLL_API GetSessionState() const;
+  void NCSTREAMER_REMOTE_DLL_API ClearSessionState();
+  SessionReplayMetrics NCSTREAMER_REMOTE_DLL_API
+      GetSessionReplayMetrics() const;
+
+  /// The status of NCStreamer as mirrored from its events and from
+  /// the successful responses, without a round trip or a lock.
+  /// It goes stale after `max_age_ms` or on a stop event or disconnect.
+  CachedStatus NCSTREAMER_REMOTE_DLL_API GetCachedStatus() const;
+  void NCSTREAMER_REMOTE_DLL_API SetStatusMaxAge(uint32_t max_age_ms);
+  void NCSTREAMER_REMOTE_DLL_API InvalidateCachedStatus();
+
+  /// Polls the comments newer than GetCommentsCursor() while connected,
+  /// feeding the local comment store.
+  /// The interval adapts to new comments within `policy`,
+  /// and polls are held while NCStreamer is known not to be on air.
+  /// A poll is skipped while a bulk request is not responded yet.
+  void NCSTREAMER_REMOTE_DLL_API StartCommentsPolling(
+      const PollPolicy &policy);
+  /// Same as above, at a fixed interval.
+  void NCSTREAMER_REMOTE_DLL_API StartCommentsPolling(uint32_t interval_ms);
+  void NCSTREAMER_REMOTE_DLL_API StopCommentsPolling();
+  PollMetrics NCSTREAMER_REMOTE_DLL_API GetCommentsPollMetrics() const;
+
+  /// The local comment store is fed by the polling above,
+  /// by every comments event and by RequestCommentRecords().
+  /// These are answered without a round trip.
+  std::vector<Comment> NCSTREAMER_REMOTE_DLL_API GetLastComments(
+      std::size_t count) const;
+  std::vector<Comment> NCSTREAMER_REMOTE_DLL_API GetCommentsSince(
+      const std::wstring &created_time) const;
+  std::wstring NCSTREAMER_REMOTE_DLL_API GetCommentsCursor() const;
+
+  /// Chat activity over the comments newly stored above,
+  /// since NCStreamer went on air last.
+  /// It is kept up to date as the comments arrive,
+  /// and answered from any thread without a lock.
+  ChatStats NCSTREAMER_REMOTE_DLL_API GetChatStats() const;
+
+  /// Filters every comment decoded into records, including the store,
+  /// before it reaches a handler: dropped by a matching drop rule,
+  /// or else tagged with the bits of every matching rule.
+  /// The filter is built on the calling thread, and dispatch keeps using
+  /// the previous one until it is swapped in.
+  void NCSTREAMER_REMOTE_DLL_API SetCommentFilter(
+      const std::vector<CommentFilterRule> &rules,
+      bool ignore_case);
+  void NCSTREAMER_REMOTE_DLL_API ClearCommentFilter();
+
+  /// Narrows the comments polling from then on.
+  /// The id and created_time fields are always asked for.
+  void NCSTREAMER_REMOTE_DLL_API SetCommentsPollQuery(
+      const CommentsQuery &query);
+
+  /// Samples the viewers while connected, into the local viewer series.
+  /// The interval adapts to changes of the count within `policy`,
+  /// and samples are held while NCStreamer is known not to be on air.
+  /// A sample is skipped while a request other than the bulk ones
+  /// is not responded yet.
+  void NCSTREAMER_REMOTE_DLL_API StartViewersSampling(
+      const PollPolicy &policy);
+  /// Same as above, at a fixed interval.
+  void NCSTREAMER_REMOTE_DLL_API StartViewersSampling(uint32_t interval_ms);
+  void NCSTREAMER_REMOTE_DLL_API StopViewersSampling();
+  PollMetrics NCSTREAMER_REMOTE_DLL_API GetViewersPollMetrics() const;
+
+  /// Caps the comments polls and viewers samples together.
+  /// @param requests_per_second 0 for no ceiling.
+  void NCSTREAMER_REMOTE_DLL_API SetPollRateCeiling(
+      double requests_per_second);
+
+  /// The local viewer series is fed by the sampling above
+  /// and by every response to RequestViewers().
+  /// These are answered without a round trip.
+  ViewerStats NCSTREAMER_REMOTE_DLL_API GetViewerStats(
+      ViewerResolution resolution) const;
+  std::vector<ViewerPoint> NCSTREAMER_REMOTE_DLL_API GetViewerPoints(
+      ViewerResolution resolution) const;
+
   void NCSTREAMER_REMOTE_DLL_API RegisterConnectHandler(
       const ConnectHandler &connect_handler);
 
@@ -114,10 +380,29 @@ class NcStreamerRemote {
   void NCSTREAMER_REMOTE_DLL_API RegisterStopEventHandler(
       const StopEventHandler &stop_event_handler);
 
+  void NCSTREAMER_REMOTE_DLL_API RegisterCommentsEventHandler(
+      const CommentsEventHandler &comments_event_handler);
+
+  /// Same as RegisterCommentsEventHandler(),
+  /// but the comments are decoded into records by the library.
+  void NCSTREAMER_REMOTE_DLL_API RegisterCommentRecordsEventHandler(
+      const CommentRecordsHandler &comment_records_event_handler);
+
+  /// A request goes one at a time with the others of its kind:
+  /// the bulk ones, of comments, comments subscription, webcam search
+  /// and mic search, and the rest. One made while another of its kind
+  /// is not responded yet is turned away with kBusy, on the calling thread,
+  /// before returning. A poll or sample in flight holds it back instead.
   void NCSTREAMER_REMOTE_DLL_API RequestStatus(
       const ErrorHandler &error_handler,
       const StatusResponseHandler &status_response_handler);
 
+  /// Same as RequestStatus(), but answered right away on the calling
+  /// thread from GetCachedStatus() unless it is stale.
+  void NCSTREAMER_REMOTE_DLL_API RequestCachedStatus(
+      const ErrorHandler &error_handler,
+      const StatusResponseHandler &status_response_handler);
+
   void NCSTREAMER_REMOTE_DLL_API RequestStart(
       const std::wstring &title,
       const ErrorHandler &error_handler,
@@ -141,6 +426,32 @@ class NcStreamerRemote {
       const ErrorHandler &error_handler,
       const CommentsResponseHandler &comments_response_handler);
 
+  /// Same as RequstComments(),
+  /// but the comments are decoded into records by the library.
+  void NCSTREAMER_REMOTE_DLL_API RequestCommentRecords(
+      const std::wstring &created_time,
+      const ErrorHandler &error_handler,
+      const CommentRecordsHandler &comment_records_response_handler);
+
+  /// Same as above, narrowed by `query` on the side of NCStreamer.
+  void NCSTREAMER_REMOTE_DLL_API RequestCommentRecords(
+      const std::wstring &created_time,
+      const CommentsQuery &query,
+      const ErrorHandler &error_handler,
+      const CommentRecordsHandler &comment_records_response_handler);
+
+  /// Asks NCStreamer to push the comments newer than `created_time`
+  /// to the comments event handler, as they arrive.
+  /// NCStreamer keeps the cursor from then on.
+  void NCSTREAMER_REMOTE_DLL_API RequestCommentsSubscribe(
+      const std::wstring &created_time,
+      const ErrorHandler &error_handler,
+      const SuccessHandler &comments_subscribe_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestCommentsUnsubscribe(
+      const ErrorHandler &error_handler,
+      const SuccessHandler &comments_unsubscribe_response_handler);
+
   void NCSTREAMER_REMOTE_DLL_API RequestViewers(
       const ErrorHandler &error_handler,
       const ViewersResponseHandler &viewers_response_handler);
@@ -208,31 +519,631 @@ class NcStreamerRemote {
       const ErrorHandler &error_handler,
       const MicResponseHandler &mic_off_response_handler);
 
+  /// Same as above, but the handlers are moved into inline storage,
+  /// so that they are not copied into a std::function,
+  /// and handed to the io thread without an allocation.
+  void NCSTREAMER_REMOTE_DLL_API RegisterConnectHandler(
+      Inplace<ConnectHandler> &&connect_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RegisterDisconnectHandler(
+      Inplace<DisconnectHandler> &&disconnect_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RegisterStartEventHandler(
+      Inplace<StartEventHandler> &&start_event_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RegisterStopEventHandler(
+      Inplace<StopEventHandler> &&stop_event_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RegisterCommentsEventHandler(
+      Inplace<CommentsEventHandler> &&comments_event_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RegisterCommentRecordsEventHandler(
+      Inplace<CommentRecordsHandler> &&comment_records_event_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestStatus(
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<StatusResponseHandler> &&status_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestCachedStatus(
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<StatusResponseHandler> &&status_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestStart(
+      const std::wstring &title,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<StartResponseHandler> &&start_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestStop(
+      const std::wstring &title,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<StopResponseHandler> &&stop_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestQualityUpdate(
+      const std::wstring &quality,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<SuccessHandler> &&quality_update_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestExit(
+      Inplace<ErrorHandler> &&error_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequstComments(
+      const std::wstring &created_time,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<CommentsResponseHandler> &&comments_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestCommentRecords(
+      const std::wstring &created_time,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<CommentRecordsHandler> &&comment_records_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestCommentRecords(
+      const std::wstring &created_time,
+      const CommentsQuery &query,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<CommentRecordsHandler> &&comment_records_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestCommentsSubscribe(
+      const std::wstring &created_time,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<SuccessHandler> &&comments_subscribe_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestCommentsUnsubscribe(
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<SuccessHandler> &&comments_unsubscribe_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestViewers(
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<ViewersResponseHandler> &&viewers_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestWebcamSearch(
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<WebcamSearchResponseHandler> &&webcam_search_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestWebcamOn(
+      const std::wstring &device_id,
+      const float &normal_width,
+      const float &normal_height,
+      const float &normal_x,
+      const float &normal_y,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<WebcamResponseHandler> &&webcam_on_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestWebcamOff(
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<WebcamResponseHandler> &&webcam_off_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestWebcamSize(
+      const float &normal_width,
+      const float &normal_height,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<WebcamResponseHandler> &&webcam_size_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestWebcamPosition(
+      const float &normal_x,
+      const float &normal_y,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<WebcamResponseHandler> &&webcam_position_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestChromaKeyOn(
+      const uint32_t &color,
+      const int &similarity,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<ChromaKeyResponseHandler> &&chroma_key_on_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestChromaKeyOff(
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<ChromaKeyResponseHandler> &&chroma_key_off_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestChromaKeyColor(
+      const uint32_t &color,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<ChromaKeyResponseHandler> &&chroma_key_color_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestChromaKeySimilarity(
+      const int &similarity,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<ChromaKeyResponseHandler>
+          &&chroma_key_similarity_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestMicSearch(
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<MicSearchResponseHandler> &&mic_search_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestMicOn(
+      const std::wstring &device_id,
+      const float &volume,
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<MicResponseHandler> &&mic_on_response_handler);
+
+  void NCSTREAMER_REMOTE_DLL_API RequestMicOff(
+      Inplace<ErrorHandler> &&error_handler,
+      Inplace<MicResponseHandler> &&mic_off_response_handler);
+
+  /// Same as above, for any callables such as lambdas,
+  /// which are stored in place instead of in a std::function.
+  template <typename ConnectFn>
+  void RegisterConnectHandler(
+      ConnectFn &&connect_handler) {
+    RegisterConnectHandler(
+        Inplace<ConnectHandler>{std::forward<ConnectFn>(connect_handler)});
+  }
+
+  template <typename DisconnectFn>
+  void RegisterDisconnectHandler(
+      DisconnectFn &&disconnect_handler) {
+    RegisterDisconnectHandler(
+        Inplace<DisconnectHandler>{
+            std::forward<DisconnectFn>(disconnect_handler)});
+  }
+
+  template <typename StartEventFn>
+  void RegisterStartEventHandler(
+      StartEventFn &&start_event_handler) {
+    RegisterStartEventHandler(
+        Inplace<StartEventHandler>{
+            std::forward<StartEventFn>(start_event_handler)});
+  }
+
+  template <typename StopEventFn>
+  void RegisterStopEventHandler(
+      StopEventFn &&stop_event_handler) {
+    RegisterStopEventHandler(
+        Inplace<StopEventHandler>{
+            std::forward<StopEventFn>(stop_event_handler)});
+  }
+
+  template <typename CommentsEventFn>
+  void RegisterCommentsEventHandler(
+      CommentsEventFn &&comments_event_handler) {
+    RegisterCommentsEventHandler(
+        Inplace<CommentsEventHandler>{
+            std::forward<CommentsEventFn>(comments_event_handler)});
+  }
+
+  template <typename CommentRecordsFn>
+  void RegisterCommentRecordsEventHandler(
+      CommentRecordsFn &&comment_records_event_handler) {
+    RegisterCommentRecordsEventHandler(
+        Inplace<CommentRecordsHandler>{
+            std::forward<CommentRecordsFn>(comment_records_event_handler)});
+  }
+
+  template <typename ErrorFn, typename StatusResponseFn>
+  void RequestStatus(
+      ErrorFn &&error_handler,
+      StatusResponseFn &&status_response_handler) {
+    RequestStatus(
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<StatusResponseHandler>{
+            std::forward<StatusResponseFn>(status_response_handler)});
+  }
+
+  template <typename ErrorFn, typename StatusResponseFn>
+  void RequestCachedStatus(
+      ErrorFn &&error_handler,
+      StatusResponseFn &&status_response_handler) {
+    RequestCachedStatus(
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<StatusResponseHandler>{
+            std::forward<StatusResponseFn>(status_response_handler)});
+  }
+
+  template <typename ErrorFn, typename StartResponseFn>
+  void RequestStart(
+      const std::wstring &title,
+      ErrorFn &&error_handler,
+      StartResponseFn &&start_response_handler) {
+    RequestStart(
+        title,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<StartResponseHandler>{
+            std::forward<StartResponseFn>(start_response_handler)});
+  }
+
+  template <typename ErrorFn, typename StopResponseFn>
+  void RequestStop(
+      const std::wstring &title,
+      ErrorFn &&error_handler,
+      StopResponseFn &&stop_response_handler) {
+    RequestStop(
+        title,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<StopResponseHandler>{
+            std::forward<StopResponseFn>(stop_response_handler)});
+  }
+
+  template <typename ErrorFn, typename SuccessFn>
+  void RequestQualityUpdate(
+      const std::wstring &quality,
+      ErrorFn &&error_handler,
+      SuccessFn &&quality_update_response_handler) {
+    RequestQualityUpdate(
+        quality,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<SuccessHandler>{
+            std::forward<SuccessFn>(quality_update_response_handler)});
+  }
+
+  template <typename ErrorFn>
+  void RequestExit(
+      ErrorFn &&error_handler) {
+    RequestExit(
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)});
+  }
+
+  template <typename ErrorFn, typename CommentsResponseFn>
+  void RequstComments(
+      const std::wstring &created_time,
+      ErrorFn &&error_handler,
+      CommentsResponseFn &&comments_response_handler) {
+    RequstComments(
+        created_time,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<CommentsResponseHandler>{
+            std::forward<CommentsResponseFn>(comments_response_handler)});
+  }
+
+  template <typename ErrorFn, typename CommentRecordsFn>
+  void RequestCommentRecords(
+      const std::wstring &created_time,
+      ErrorFn &&error_handler,
+      CommentRecordsFn &&comment_records_response_handler) {
+    RequestCommentRecords(
+        created_time,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<CommentRecordsHandler>{std::forward<CommentRecordsFn>(
+            comment_records_response_handler)});
+  }
+
+  template <typename ErrorFn, typename CommentRecordsFn>
+  void RequestCommentRecords(
+      const std::wstring &created_time,
+      const CommentsQuery &query,
+      ErrorFn &&error_handler,
+      CommentRecordsFn &&comment_records_response_handler) {
+    RequestCommentRecords(
+        created_time,
+        query,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<CommentRecordsHandler>{std::forward<CommentRecordsFn>(
+            comment_records_response_handler)});
+  }
+
+  template <typename ErrorFn, typename SuccessFn>
+  void RequestCommentsSubscribe(
+      const std::wstring &created_time,
+      ErrorFn &&error_handler,
+      SuccessFn &&comments_subscribe_response_handler) {
+    RequestCommentsSubscribe(
+        created_time,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<SuccessHandler>{
+            std::forward<SuccessFn>(comments_subscribe_response_handler)});
+  }
+
+  template <typename ErrorFn, typename SuccessFn>
+  void RequestCommentsUnsubscribe(
+      ErrorFn &&error_handler,
+      SuccessFn &&comments_unsubscribe_response_handler) {
+    RequestCommentsUnsubscribe(
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<SuccessHandler>{
+            std::forward<SuccessFn>(comments_unsubscribe_response_handler)});
+  }
+
+  template <typename ErrorFn, typename ViewersResponseFn>
+  void RequestViewers(
+      ErrorFn &&error_handler,
+      ViewersResponseFn &&viewers_response_handler) {
+    RequestViewers(
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<ViewersResponseHandler>{
+            std::forward<ViewersResponseFn>(viewers_response_handler)});
+  }
+
+  template <typename ErrorFn, typename WebcamSearchResponseFn>
+  void RequestWebcamSearch(
+      ErrorFn &&error_handler,
+      WebcamSearchResponseFn &&webcam_search_response_handler) {
+    RequestWebcamSearch(
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<WebcamSearchResponseHandler>{
+            std::forward<WebcamSearchResponseFn>(
+                webcam_search_response_handler)});
+  }
+
+  template <typename ErrorFn, typename WebcamResponseFn>
+  void RequestWebcamOn(
+      const std::wstring &device_id,
+      const float &normal_width,
+      const float &normal_height,
+      const float &normal_x,
+      const float &normal_y,
+      ErrorFn &&error_handler,
+      WebcamResponseFn &&webcam_on_response_handler) {
+    RequestWebcamOn(
+        device_id,
+        normal_width,
+        normal_height,
+        normal_x,
+        normal_y,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<WebcamResponseHandler>{
+            std::forward<WebcamResponseFn>(webcam_on_response_handler)});
+  }
+
+  template <typename ErrorFn, typename WebcamResponseFn>
+  void RequestWebcamOff(
+      ErrorFn &&error_handler,
+      WebcamResponseFn &&webcam_off_response_handler) {
+    RequestWebcamOff(
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<WebcamResponseHandler>{
+            std::forward<WebcamResponseFn>(webcam_off_response_handler)});
+  }
+
+  template <typename ErrorFn, typename WebcamResponseFn>
+  void RequestWebcamSize(
+      const float &normal_width,
+      const float &normal_height,
+      ErrorFn &&error_handler,
+      WebcamResponseFn &&webcam_size_response_handler) {
+    RequestWebcamSize(
+        normal_width,
+        normal_height,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<WebcamResponseHandler>{
+            std::forward<WebcamResponseFn>(webcam_size_response_handler)});
+  }
+
+  template <typename ErrorFn, typename WebcamResponseFn>
+  void RequestWebcamPosition(
+      const float &normal_x,
+      const float &normal_y,
+      ErrorFn &&error_handler,
+      WebcamResponseFn &&webcam_position_response_handler) {
+    RequestWebcamPosition(
+        normal_x,
+        normal_y,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<WebcamResponseHandler>{
+            std::forward<WebcamResponseFn>(webcam_position_response_handler)});
+  }
+
+  template <typename ErrorFn, typename ChromaKeyResponseFn>
+  void RequestChromaKeyOn(
+      const uint32_t &color,
+      const int &similarity,
+      ErrorFn &&error_handler,
+      ChromaKeyResponseFn &&chroma_key_on_response_handler) {
+    RequestChromaKeyOn(
+        color,
+        similarity,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<ChromaKeyResponseHandler>{
+            std::forward<ChromaKeyResponseFn>(chroma_key_on_response_handler)});
+  }
+
+  template <typename ErrorFn, typename ChromaKeyResponseFn>
+  void RequestChromaKeyOff(
+      ErrorFn &&error_handler,
+      ChromaKeyResponseFn &&chroma_key_off_response_handler) {
+    RequestChromaKeyOff(
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<ChromaKeyResponseHandler>{
+            std::forward<ChromaKeyResponseFn>(
+                chroma_key_off_response_handler)});
+  }
+
+  template <typename ErrorFn, typename ChromaKeyResponseFn>
+  void RequestChromaKeyColor(
+      const uint32_t &color,
+      ErrorFn &&error_handler,
+      ChromaKeyResponseFn &&chroma_key_color_response_handler) {
+    RequestChromaKeyColor(
+        color,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<ChromaKeyResponseHandler>{
+            std::forward<ChromaKeyResponseFn>(
+                chroma_key_color_response_handler)});
+  }
+
+  template <typename ErrorFn, typename ChromaKeyResponseFn>
+  void RequestChromaKeySimilarity(
+      const int &similarity,
+      ErrorFn &&error_handler,
+      ChromaKeyResponseFn &&chroma_key_similarity_response_handler) {
+    RequestChromaKeySimilarity(
+        similarity,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<ChromaKeyResponseHandler>{
+            std::forward<ChromaKeyResponseFn>(
+                chroma_key_similarity_response_handler)});
+  }
+
+  template <typename ErrorFn, typename MicSearchResponseFn>
+  void RequestMicSearch(
+      ErrorFn &&error_handler,
+      MicSearchResponseFn &&mic_search_response_handler) {
+    RequestMicSearch(
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<MicSearchResponseHandler>{
+            std::forward<MicSearchResponseFn>(mic_search_response_handler)});
+  }
+
+  template <typename ErrorFn, typename MicResponseFn>
+  void RequestMicOn(
+      const std::wstring &device_id,
+      const float &volume,
+      ErrorFn &&error_handler,
+      MicResponseFn &&mic_on_response_handler) {
+    RequestMicOn(
+        device_id,
+        volume,
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<MicResponseHandler>{
+            std::forward<MicResponseFn>(mic_on_response_handler)});
+  }
+
+  template <typename ErrorFn, typename MicResponseFn>
+  void RequestMicOff(
+      ErrorFn &&error_handler,
+      MicResponseFn &&mic_off_response_handler) {
+    RequestMicOff(
+        Inplace<ErrorHandler>{std::forward<ErrorFn>(error_handler)},
+        Inplace<MicResponseHandler>{
+            std::forward<MicResponseFn>(mic_off_response_handler)});
+  }
+
  private:
   using SteadyTimer = boost::asio::basic_waitable_timer<Chrono::steady_clock>;
-  using AsioClient = websocketpp::config::asio_client;
+  using AsioClient = PooledAsioClient;
   using OpenHandler = std::function<void()>;
 
-  explicit NcStreamerRemote(uint16_t remote_port);
+  /// Parse tree of an inbound message,
+  /// whose strings live in the per-message arena.
+  using InboundString = ResourceString;
+  using InboundTree =
+      boost::property_tree::basic_ptree<InboundString, InboundString>;
+
+  /// As far as the events and status responses tell.
+  enum class OnAirState {
+    kUnknown,
+    kOnAir,
+    kOffAir,
+  };
+
+  using MessageHandler = void (NcStreamerRemote::*)(
+      const InboundTree &response);
+
+  using LaneRequest = InplaceFunction<void()>;
+
+  /// The requests going one at a time, apart from those of another lane.
+  /// The caller taking `busy` owns the request fields until the io thread
+  /// gives it back, so a request is handed over without an allocation.
+  struct RequestLane;
+
+  /// Connection attempts of one Connect(), racing over the loopback
+  /// addresses, of which the first to open wins.
+  struct ConnectRace {
+    explicit ConnectRace(boost::asio::io_service &io_service)  // NOLINT
+        : started_us{0},
+          first_uri{0},
+          pending{0},
+          fallback_started{false},
+          opened{false},
+          fallback_timer{io_service},
+          request_id{0},
+          error_handler{},
+          open_handler{} {}
+
+    uint64_t started_us;
+    std::size_t first_uri;
+    std::size_t pending;
+    bool fallback_started;
+    bool opened;
+    SteadyTimer fallback_timer;
+    /// Of the request connecting, if any.
+    uint64_t request_id;
+    /// Of the Connect(), for the fallback failing too.
+    Inplace<ErrorHandler> error_handler;
+    OpenHandler open_handler;
+  };
+
+  /// Probes of one port discovery.
+  struct PortProbe {
+    explicit PortProbe(boost::asio::io_service &io_service)  // NOLINT
+        : pending{0},
+          found_port{0},
+          connections{},
+          timeout_timer{io_service} {}
+
+    std::size_t pending;
+    uint16_t found_port;
+    std::vector<websocketpp::connection_hdl> connections;
+    SteadyTimer timeout_timer;
+  };
+
+  /// @param offline Never connecting, as to replay a wire recording.
+  NcStreamerRemote(
+      uint16_t remote_port,
+      MemoryResource *memory_resource,
+      RemoteExecutor *executor,
+      const std::string &log_path,
+      bool offline);
   virtual ~NcStreamerRemote();
 
+  /// With `connections_mutex_` held.
+  /// @return True if websocketpp has let go of every connection.
+  bool ForgetReleasedConnections();
+  /// From every close and fail handler of a connection.
+  void OnConnectionEnded();
+
   bool ExistsNcStreamer();
 
   void KeepConnected();
-
+  void ScheduleReconnect();
+  void OnNcStreamerAppeared();
+  void KeepHeartbeat();
+  void SetConnectionState(ConnectionState connection_state);
+  void ReplaySessionIfDue();
+  void OnSessionReplaySent(int request_type, bool sent);
+  void OnSessionReplayResponse(const InboundTree &response);
+  void FinishSessionReplay();
+  void PollComments();
+  /// False if skipped, else the poll is in flight on `lane`.
+  bool BeginPoll(RequestLane *lane, PollSchedule *poll);
+  void StoreComments(const CommentRecords &comments);
+  void SampleViewers();
+  void SetOnAirState(OnAirState on_air_state);
+
+  /// @param request_id Of the request connecting, or 0.
   void Connect(
-    const ErrorHandler &error_handler,
+    uint64_t request_id,
+    Inplace<ErrorHandler> &&error_handler,
     const OpenHandler &open_handler);
 
+  /// For the request in flight on `lane`, failing it if not opened.
   void Connect(
+    RequestLane *lane,
     const OpenHandler &open_handler);
 
+  bool ConnectTo(
+      std::size_t uri_index,
+      const std::shared_ptr<ConnectRace> &race,
+      const Inplace<ErrorHandler> &error_handler);
+  void StartConnectFallback(const std::shared_ptr<ConnectRace> &race);
+  void OnConnectOpen(
+      std::size_t uri_index,
+      const std::shared_ptr<ConnectRace> &race,
+      websocketpp::connection_hdl connection);
+  void OnConnectFail(
+      const std::shared_ptr<ConnectRace> &race,
+      websocketpp::connection_hdl connection);
+  bool IsRemoteConnection(websocketpp::connection_hdl connection) const;
+
+  void OpenBulkConnection();
+  void CloseBulkConnection();
+
+  void SetRemotePort(uint16_t remote_port);
+  void DiscoverPort();
+  void ProbePort(
+      const std::string &host,
+      uint16_t port,
+      const std::shared_ptr<PortProbe> &probe);
+  void OnPortProbeDone(const std::shared_ptr<PortProbe> &probe);
+  void SavePortCache(uint16_t port);
+
   void SendStatusRequest();
   void SendStartRequest(const std::wstring &title);
   void SendStopRequest(const std::wstring &title);
   void SendQualityUpdateRequest(const std::wstring &quality);
   void SendExitRequest();
-  void SendCommentsRequest(const std::wstring &created_time);
+  void SendCommentsRequest(
+      const std::wstring &created_time,
+      const CommentsQuery &query);
+  void SendCommentsSubscribeRequest(const std::wstring &created_time);
+  void SendCommentsUnsubscribeRequest();
   void SendViewersRequest();
   void SendWebcamSearchRequest();
   void SendWebcamOnRequest(
@@ -260,119 +1171,335 @@ class NcStreamerRemote {
       const float &volume);
   void SendMicOffRequest();
 
+  void Send(const boost::property_tree::ptree &tree);
+  void LogFrameSampled(const char *direction, std::size_t size);
+
   void OnRemoteFail(websocketpp::connection_hdl connection);
   void OnRemoteClose(websocketpp::connection_hdl connection);
+  void OnRemotePong(
+      websocketpp::connection_hdl connection,
+      std::string payload);
+  void OnRemotePongTimeout(
+      websocketpp::connection_hdl connection,
+      std::string payload);
   void OnRemoteMessage(
       websocketpp::connection_hdl connection,
       websocketpp::connection<AsioClient>::message_ptr msg);
+  void DispatchInboundPayload(const char *payload, std::size_t size);
+  void DispatchRemoteMessage(const char *payload, std::size_t size);
+  void RecordWireFrame(
+      WireDirection direction,
+      const char *payload,
+      std::size_t size);
+  void ReplayWireFrame(const WireFrame &frame, WireReplayStats *stats);
 
   void OnRemoteStartEvent(
-      const boost::property_tree::ptree &evt);
+      const InboundTree &evt);
   void OnRemoteStopEvent(
-      const boost::property_tree::ptree &evt);
+      const InboundTree &evt);
+  void OnRemoteCommentsEvent(
+      const InboundTree &evt);
 
   void OnRemoteStatusResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteStartResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteStopResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteQualityUpdateResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteCommentsResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
+  void OnRemoteCommentsSubscribeResponse(
+      const InboundTree &response);
+  void OnRemoteCommentsUnsubscribeResponse(
+      const InboundTree &response);
   void OnRemoteViewersResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteWebcamSearchResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteWebcamOnResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteWebcamOffResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteWebcamSizeResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteWebcamPositionResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteChromaKeyOnResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteChromaKeyOffResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteChromaKeyColorResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteChromaKeySimilarityResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteMicSearchResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteMicOnResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
   void OnRemoteMicOffResponse(
-      const boost::property_tree::ptree &response);
+      const InboundTree &response);
+
+  /// The bodies of the requests above, run on the io thread.
+  void DoRequestStatus();
+  void DoRequestStart(
+      const std::wstring &title);
+  void DoRequestStop(
+      const std::wstring &title);
+  void DoRequestQualityUpdate(
+      const std::wstring &quality);
+  void DoRequstComments(
+      const std::wstring &created_time);
+  void DoRequestCommentRecords(
+      const std::wstring &created_time,
+      const CommentsQuery &query);
+  void DoRequestCommentsSubscribe(
+      const std::wstring &created_time);
+  void DoRequestCommentsUnsubscribe();
+  void DoRequestViewers();
+  void DoRequestWebcamSearch();
+  void DoRequestWebcamOn(
+      const std::wstring &device_id,
+      const float &normal_width,
+      const float &normal_height,
+      const float &normal_x,
+      const float &normal_y);
+  void DoRequestWebcamOff();
+  void DoRequestWebcamSize(
+      const float &normal_width,
+      const float &normal_height);
+  void DoRequestWebcamPosition(
+      const float &normal_x,
+      const float &normal_y);
+  void DoRequestChromaKeyOn(
+      const uint32_t &color,
+      const int &similarity);
+  void DoRequestChromaKeyOff();
+  void DoRequestChromaKeyColor(
+      const uint32_t &color);
+  void DoRequestChromaKeySimilarity(
+      const int &similarity);
+  void DoRequestMicSearch();
+  void DoRequestMicOn(
+      const std::wstring &device_id,
+      const float &volume);
+  void DoRequestMicOff();
+  void DoRequestExit();
+
+  /// On the calling thread. Takes `error_handler` into `lane`,
+  /// or else calls it with kBusy while another request is on `lane`.
+  bool BeginRequest(
+      RequestLane *lane,
+      Inplace<ErrorHandler> *error_handler);
+  void PostRequest(RequestLane *lane);
+  /// On the io thread from here on.
+  void RunRequest(RequestLane *lane);
+  void EndRequest(RequestLane *lane);
+  void FailRequest(
+      RequestLane *lane,
+      ErrorCategory err_category,
+      int err_code,
+      const std::wstring &err_msg);
+  RequestLane *GetRequestLane(int request_type);
+
+  /// Ends the request responded, before the handler may begin another.
+  template <typename InplaceResponseHandler>
+  InplaceResponseHandler TakeResponseHandler(
+      InplaceResponseHandler *response_handler) {
+    InplaceResponseHandler taken{std::move(*response_handler)};
+    if (responding_lane_ != nullptr) {
+      EndRequest(responding_lane_);
+    }
+    return taken;
+  }
+
+  /// Fails the request responded.
+  void ReportError(
+      ErrorCategory err_category,
+      int err_code,
+      const std::wstring &err_msg);
 
   void HandleDisconnect(
       Error::Connection err_code);
   void HandleConnectionError(
       Error::Connection err_code,
-      const ErrorHandler &err_handler);
+      const Inplace<ErrorHandler> &err_handler);
 
   void HandleError(
       Error::Connection err_code,
       const websocketpp::lib::error_code &ec,
-      const ErrorHandler &err_handler);
+      const Inplace<ErrorHandler> &err_handler);
   void HandleError(
       Error::Connection err_code,
-      const websocketpp::lib::error_code &ec);
+      const std::string &err_msg,
+      const Inplace<ErrorHandler> &err_handler);
   void HandleError(
       Error::Connection err_code,
-      const std::string &err_msg,
-      const ErrorHandler &err_handler);
+      const Inplace<ErrorHandler> &err_handler);
+
+  /// Fails the request in flight on `lane`.
   void HandleError(
+      RequestLane *lane,
       Error::Connection err_code,
-      const ErrorHandler &err_handler);
+      const websocketpp::lib::error_code &ec);
   void HandleError(
+      RequestLane *lane,
+      Error::Connection err_code,
+      const std::string &err_msg);
+  void HandleError(
+      RequestLane *lane,
       Error::Connection err_code);
 
   void LogWarning(const std::string &warn_msg);
   void LogError(const std::string &err_msg);
 
   static NcStreamerRemote *static_instance;
+  /// The default resource before SetUp(), restored on ShutDown().
+  static MemoryResource *static_previous_resource;
 
-  boost::asio::io_service io_service_;
-  boost::asio::io_service::work io_service_work_;
-  websocketpp::client<AsioClient> remote_;
-  std::vector<std::thread> remote_threads_;
-  std::ofstream remote_log_;
+  /// Keyed by ncstreamer::RemoteMessage::MessageType.
+  static const std::unordered_map<int, MessageHandler> kMessageHandlers;
 
-  websocketpp::uri_ptr remote_uri_;
+  std::unique_ptr<RemoteExecutor> owned_executor_;
+  RemoteExecutor *executor_;
+  boost::asio::io_service &io_service_;
+  websocketpp::client<AsioClient> remote_;
+  std::unique_ptr<AsyncLog> remote_log_;
+  std::atomic<uint32_t> frame_log_sampling_;
+  std::atomic<uint64_t> frames_;
+  std::shared_ptr<WireRecorder> wire_recorder_;
+  std::atomic_bool shutting_down_;
+  bool offline_;
+
+  /// Every connection websocketpp may still call back about.
+  std::mutex connections_mutex_;
+  std::vector<websocketpp::connection_hdl> connections_;
+  /// Notified while shutting down, as the connections end.
+  std::condition_variable connections_released_;
+
+  MemoryResource *memory_resource_;
+  MonotonicBufferResource inbound_arena_;
+
+  websocketpp::lib::shared_ptr<MessagePool<AsioClient::message_type>>
+      message_pool_;
+  std::mutex outbound_mutex_;
+  ResourceString outbound_payload_;
+
+  std::atomic<uint16_t> remote_port_;
+  /// The IPv6 and IPv4 loopback, built once per port,
+  /// and swapped whole for another port.
+  std::shared_ptr<const std::vector<websocketpp::uri_ptr>> remote_uris_;
+  /// Of `remote_uris_`, the one opened last, tried first.
+  std::size_t preferred_uri_;
+  std::unique_ptr<LatencyHistogram> connect_latency_;
+  std::unique_ptr<LatencyHistogram> launch_to_response_;
+  /// Since the window of NCStreamer showed up. 0 once responded.
+  uint64_t appeared_us_;
 
   websocketpp::connection_hdl remote_connection_;
   SteadyTimer timer_to_keep_connected_;
-
-  std::atomic_bool busy_;
-
-  ConnectHandler connect_handler_;
-  DisconnectHandler disconnect_handler_;
-  StartEventHandler start_event_handler_;
-  StopEventHandler stop_event_handler_;
-
-  ErrorHandler current_error_handler_;
-  StatusResponseHandler current_status_response_handler_;
-  StartResponseHandler current_start_response_handler_;
-  StopResponseHandler current_stop_response_handler_;
-  SuccessHandler current_quality_update_response_handler_;
-  CommentsResponseHandler current_comments_response_handler_;
-  ViewersResponseHandler current_viewers_response_handler_;
-  WebcamSearchResponseHandler current_webcam_search_response_handler_;
-  WebcamResponseHandler current_webcam_on_response_handler_;
-  WebcamResponseHandler current_webcam_off_response_handler_;
-  WebcamResponseHandler current_webcam_size_response_handler_;
-  WebcamResponseHandler current_webcam_position_response_handler_;
-  ChromaKeyResponseHandler current_chroma_key_on_response_handler_;
-  ChromaKeyResponseHandler current_chroma_key_off_response_handler_;
-  ChromaKeyResponseHandler current_chroma_key_color_response_handler_;
-  ChromaKeyResponseHandler current_chroma_key_similarity_response_handler_;
-  MicSearchResponseHandler current_mic_search_response_handler_;
-  MicResponseHandler current_mic_on_response_handler_;
-  MicResponseHandler current_mic_off_response_handler_;
+  std::unique_ptr<ReconnectBackoff> reconnect_backoff_;
+  std::unique_ptr<ServerWatcher> server_watcher_;
+  std::unique_ptr<PortDiscoveryPolicy> port_discovery_;
+  bool port_discovery_due_;
+  /// Saving the port found last, off the io thread.
+  std::unique_ptr<PortCacheWriter> port_cache_writer_;
+
+  std::atomic_bool bulk_enabled_;
+  /// Read on the requesting threads.
+  mutable std::mutex bulk_mutex_;
+  websocketpp::connection_hdl bulk_connection_;
+  bool bulk_opening_;
+  /// Set while an OpenBulkConnection() is posted, to post one only.
+  std::atomic_bool bulk_open_posted_;
+  /// Not retried until the first connection opens again.
+  bool bulk_failed_;
+
+  std::atomic<ConnectionState> connection_state_;
+  std::atomic<uint64_t> connection_state_ms_;
+  bool ever_connected_;
+  std::atomic<uint64_t> reconnects_;
+  std::unique_ptr<HeartbeatPolicy> heartbeat_policy_;
+  std::unique_ptr<Heartbeat> heartbeat_;
+  SteadyTimer timer_to_ping_;
+
+  OnAirState on_air_state_;
+  std::unique_ptr<PollRateCeiling> poll_rate_ceiling_;
+
+  std::unique_ptr<CommentStore> comment_store_;
+  std::shared_ptr<const CommentFilter> comment_filter_;
+  std::unique_ptr<ChatAnalytics> chat_analytics_;
+  SteadyTimer timer_to_poll_comments_;
+  std::unique_ptr<PollSchedule> comments_poll_;
+  CommentsQuery comments_poll_query_;
+
+  std::unique_ptr<ViewerSeries> viewer_series_;
+  SteadyTimer timer_to_sample_viewers_;
+  std::unique_ptr<PollSchedule> viewers_poll_;
+  std::wstring last_sampled_viewers_;
+
+  std::unique_ptr<SessionState> session_state_;
+  /// Of the settings request in flight,
+  /// kept in `session_state_` once NCStreamer accepts it.
+  std::unique_ptr<SessionSnapshot> session_requested_;
+  bool session_replay_due_;
+  /// Set while the replay requests are being sent.
+  bool session_replay_sending_;
+  /// Response types of the replay requests sent, until each arrives.
+  std::vector<int> session_replay_pending_;
+  uint32_t session_replay_failed_;
+  uint64_t reconnected_ms_;
+  std::atomic<uint64_t> session_replays_;
+  std::atomic<uint32_t> session_replay_requests_;
+  std::atomic<uint32_t> session_replay_failures_;
+  std::atomic<uint32_t> session_restore_ms_;
+
+  std::unique_ptr<StatusMirror> status_mirror_;
+
+  /// The bulk requests, as in kBulkRequestTypes, and the comments polls
+  /// go on the bulk lane, and the rest, viewers samples included,
+  /// on the control lane.
+  std::unique_ptr<RequestLane> control_lane_;
+  std::unique_ptr<RequestLane> bulk_lane_;
+  /// Set while the handler of a response runs.
+  RequestLane *responding_lane_;
+  /// Of the comments poll in flight.
+  std::wstring comments_polled_cursor_;
+
+  std::unique_ptr<RequestMetrics> request_metrics_;
+  uint64_t request_id_;
+  std::unique_ptr<TraceRecorder> tracer_;
+
+  Inplace<ConnectHandler> connect_handler_;
+  Inplace<DisconnectHandler> disconnect_handler_;
+  Inplace<StartEventHandler> start_event_handler_;
+  Inplace<StopEventHandler> stop_event_handler_;
+  Inplace<CommentsEventHandler> comments_event_handler_;
+  Inplace<CommentRecordsHandler> comment_records_event_handler_;
+
+  Inplace<StatusResponseHandler> current_status_response_handler_;
+  Inplace<StartResponseHandler> current_start_response_handler_;
+  Inplace<StopResponseHandler> current_stop_response_handler_;
+  Inplace<SuccessHandler> current_quality_update_response_handler_;
+  Inplace<CommentsResponseHandler> current_comments_response_handler_;
+  Inplace<CommentRecordsHandler> current_comment_records_response_handler_;
+  Inplace<SuccessHandler> current_comments_subscribe_response_handler_;
+  Inplace<SuccessHandler> current_comments_unsubscribe_response_handler_;
+  Inplace<ViewersResponseHandler> current_viewers_response_handler_;
+  Inplace<WebcamSearchResponseHandler> current_webcam_search_response_handler_;
+  Inplace<WebcamResponseHandler> current_webcam_on_response_handler_;
+  Inplace<WebcamResponseHandler> current_webcam_off_response_handler_;
+  Inplace<WebcamResponseHandler> current_webcam_size_response_handler_;
+  Inplace<WebcamResponseHandler> current_webcam_position_response_handler_;
+  Inplace<ChromaKeyResponseHandler> current_chroma_key_on_response_handler_;
+  Inplace<ChromaKeyResponseHandler> current_chroma_key_off_response_handler_;
+  Inplace<ChromaKeyResponseHandler> current_chroma_key_color_response_handler_;
+  Inplace<ChromaKeyResponseHandler>
+      current_chroma_key_similarity_response_handler_;
+  Inplace<MicSearchResponseHandler> current_mic_search_response_handler_;
+  Inplace<MicResponseHandler> current_mic_on_response_handler_;
+  Inplace<MicResponseHandler> current_mic_off_response_handler_;
 };
 }  // namespace ncstreamer_remote
 
@@ -0,0 +1,102 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_POLL_POLL_SCHEDULE_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_POLL_POLL_SCHEDULE_H_
+
+
+#include <atomic>
+#include <cstdint>
+
+
+namespace ncstreamer_remote {
+struct PollPolicy {
+  /// The interval right after a poll brought something new.
+  uint32_t min_interval_ms;
+
+  /// The interval never grows beyond this while idle.
+  uint32_t max_interval_ms;
+
+  /// The interval is multiplied by this on every poll bringing nothing.
+  double backoff;
+};
+
+
+struct PollMetrics {
+  /// The interval chosen for the next poll, or 0 if not polling.
+  uint32_t interval_ms;
+
+  /// Polls sent to NCStreamer.
+  uint64_t polls;
+
+  /// Polls skipped for another request in flight or for the rate ceiling.
+  uint64_t skips;
+
+  /// Whether polls are held because NCStreamer is not on air.
+  bool paused;
+};
+
+
+/// Interval of a periodic poll, adapting to what the polls bring:
+/// back to the minimum on activity, and backing off exponentially while idle.
+/// It is driven on the io thread, and its metrics are read from any thread.
+class PollSchedule {
+ public:
+  PollSchedule();
+  virtual ~PollSchedule();
+
+  void Start(const PollPolicy &policy);
+  void Stop();
+  bool running() const { return running_; }
+
+  /// @param active Whether the response brought anything new.
+  void OnResponse(bool active);
+  void OnPoll();
+  void OnSkip();
+  void SetPaused(bool paused);
+
+  uint32_t interval_ms() const { return interval_ms_; }
+  PollMetrics GetMetrics() const;
+
+ private:
+  PollSchedule(const PollSchedule &) = delete;
+  PollSchedule &operator=(const PollSchedule &) = delete;
+
+  PollPolicy policy_;
+  std::atomic_bool running_;
+  std::atomic<uint32_t> interval_ms_;
+  std::atomic<uint64_t> polls_;
+  std::atomic<uint64_t> skips_;
+  std::atomic_bool paused_;
+};
+
+
+/// Token bucket shared by all the polls,
+/// so that together they never exceed a request rate.
+class PollRateCeiling {
+ public:
+  PollRateCeiling();
+  virtual ~PollRateCeiling();
+
+  /// @param requests_per_second 0 for no ceiling.
+  void Set(double requests_per_second);
+
+  /// @param now_ms Any monotonic clock in milliseconds.
+  /// @return Whether a request may be sent now, consuming it if so.
+  bool TryAcquire(uint64_t now_ms);
+
+ private:
+  PollRateCeiling(const PollRateCeiling &) = delete;
+  PollRateCeiling &operator=(const PollRateCeiling &) = delete;
+
+  double requests_per_ms_;
+  double burst_;
+  double tokens_;
+  uint64_t last_ms_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_POLL_POLL_SCHEDULE_H_
@@ -0,0 +1,110 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_SESSION_SESSION_STATE_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_SESSION_SESSION_STATE_H_
+
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+
+
+namespace ncstreamer_remote {
+struct WebcamState {
+  bool on;
+  std::wstring device_id;
+  float normal_width;
+  float normal_height;
+  float normal_x;
+  float normal_y;
+};
+
+
+struct ChromaKeyState {
+  bool on;
+  uint32_t color;
+  int similarity;
+};
+
+
+struct MicState {
+  bool on;
+  std::wstring device_id;
+  float volume;
+};
+
+
+/// The settings NCStreamer accepted last.
+/// A part is valid only if its `has_` flag is set.
+struct SessionSnapshot {
+  bool has_quality;
+  std::wstring quality;
+
+  bool has_webcam;
+  WebcamState webcam;
+
+  bool has_chroma_key;
+  ChromaKeyState chroma_key;
+
+  bool has_mic;
+  MicState mic;
+};
+
+
+struct SessionReplayMetrics {
+  /// Replays done after reconnecting.
+  uint64_t replays;
+
+  /// Requests of the last replay, and how many of them failed.
+  uint32_t requests;
+  uint32_t failures;
+
+  /// From reconnected to the last response of the last replay.
+  uint32_t restore_ms;
+};
+
+
+/// Desired state of the settings which NCStreamer forgets on restart,
+/// updated by every settings request NCStreamer accepts, from any thread.
+class SessionState {
+ public:
+  SessionState();
+  virtual ~SessionState();
+
+  void SetQuality(const std::wstring &quality);
+
+  void SetWebcamOn(
+      const std::wstring &device_id,
+      float normal_width,
+      float normal_height,
+      float normal_x,
+      float normal_y);
+  void SetWebcamOff();
+  void SetWebcamSize(float normal_width, float normal_height);
+  void SetWebcamPosition(float normal_x, float normal_y);
+
+  void SetChromaKeyOn(uint32_t color, int similarity);
+  void SetChromaKeyOff();
+  void SetChromaKeyColor(uint32_t color);
+  void SetChromaKeySimilarity(int similarity);
+
+  void SetMicOn(const std::wstring &device_id, float volume);
+  void SetMicOff();
+
+  void Clear();
+  SessionSnapshot Get() const;
+
+ private:
+  SessionState(const SessionState &) = delete;
+  SessionState &operator=(const SessionState &) = delete;
+
+  mutable std::mutex mutex_;
+  SessionSnapshot snapshot_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_SESSION_SESSION_STATE_H_
@@ -0,0 +1,102 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_STATUS_STATUS_MIRROR_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_STATUS_STATUS_MIRROR_H_
+
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/session/session_state.h"
+
+
+namespace ncstreamer_remote {
+/// What is known of NCStreamer, as of one version.
+/// A setting is valid only if its `has_` flag is set.
+struct StatusSnapshot {
+  /// Bumped on every change.
+  uint64_t version;
+
+  bool on_air;
+  std::wstring status;
+  std::wstring source_title;
+  std::wstring user_name;
+  std::wstring quality;
+
+  bool has_webcam;
+  WebcamState webcam;
+
+  bool has_chroma_key;
+  ChromaKeyState chroma_key;
+
+  bool has_mic;
+  MicState mic;
+};
+
+
+struct CachedStatus {
+  /// Null until a status response or a start event.
+  std::shared_ptr<const StatusSnapshot> snapshot;
+
+  /// Since NCStreamer told its status last.
+  uint64_t age_ms;
+
+  /// Older than the max age, or invalidated since.
+  bool stale;
+};
+
+
+/// In-memory mirror of the status of NCStreamer,
+/// updated from events and from successful responses on the io thread.
+/// Each update swaps in a new immutable snapshot,
+/// so a reader on any thread takes no lock and copies no string.
+class StatusMirror {
+ public:
+  explicit StatusMirror(uint32_t max_age_ms);
+  virtual ~StatusMirror();
+
+  void SetMaxAge(uint32_t max_age_ms);
+
+  void OnStatus(
+      const std::wstring &status,
+      const std::wstring &source_title,
+      const std::wstring &user_name,
+      const std::wstring &quality,
+      uint64_t now_ms);
+  void OnStart(const std::wstring &source_title, uint64_t now_ms);
+
+  /// The status string of NCStreamer off air is left to a refresh.
+  void OnStop();
+
+  void OnQuality(const std::wstring &quality);
+  void OnWebcam(const WebcamState &webcam);
+  void OnChromaKey(const ChromaKeyState &chroma_key);
+  void OnMic(const MicState &mic);
+
+  /// Until the next status response or start event.
+  void Invalidate();
+
+  /// @param now_ms The same clock as the updates.
+  CachedStatus Get(uint64_t now_ms) const;
+
+ private:
+  StatusMirror(const StatusMirror &) = delete;
+  StatusMirror &operator=(const StatusMirror &) = delete;
+
+  void Update(const std::function<void(StatusSnapshot *next)> &modify);
+
+  std::shared_ptr<const StatusSnapshot> snapshot_;
+  std::atomic<uint32_t> max_age_ms_;
+  std::atomic<uint64_t> confirmed_ms_;
+  std::atomic_bool invalidated_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_STATUS_STATUS_MIRROR_H_
@@ -0,0 +1,126 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_VIEWER_VIEWER_SERIES_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_VIEWER_VIEWER_SERIES_H_
+
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>  // NOLINT
+#include <vector>
+
+
+namespace ncstreamer_remote {
+enum class ViewerResolution {
+  /// 1 second buckets over the last 5 minutes.
+  kSecond = 0,
+
+  /// 1 minute buckets over the last 3 hours.
+  kMinute,
+
+  /// 10 minute buckets over the last 24 hours.
+  kTenMinutes,
+};
+
+
+struct ViewerStats {
+  /// The number of samples in the window.
+  /// The others are zero if there are none.
+  uint64_t samples;
+  uint32_t min;
+  uint32_t max;
+  double average;
+
+  /// The most viewers ever sampled, regardless of the window.
+  uint32_t peak;
+};
+
+
+struct ViewerPoint {
+  /// Start of the bucket, on the clock given to ViewerSeries::Add().
+  uint64_t time_ms;
+  uint32_t min;
+  uint32_t max;
+  double average;
+};
+
+
+/// Viewer counts downsampled into rings of fixed-size buckets,
+/// one ring per resolution, so memory stays bounded however long it runs.
+/// Each ring keeps its window aggregates up to date on every sample,
+/// so GetStats() doesn't walk the buckets.
+class ViewerSeries {
+ public:
+  ViewerSeries();
+  virtual ~ViewerSeries();
+
+  /// @param time_ms Any monotonic clock in milliseconds.
+  void Add(uint64_t time_ms, uint32_t viewers);
+  void Clear();
+
+  /// @return Aggregates over the window of `resolution`,
+  ///         which ends at the latest sample.
+  ViewerStats GetStats(ViewerResolution resolution) const;
+
+  /// @return Non-empty buckets of the window, the oldest first.
+  std::vector<ViewerPoint> GetPoints(ViewerResolution resolution) const;
+
+ private:
+  class Level {
+   public:
+    Level(uint64_t period_ms, std::size_t size);
+    virtual ~Level();
+
+    void Add(uint64_t time_ms, uint32_t viewers);
+    void Clear();
+
+    ViewerStats GetStats() const;
+    std::vector<ViewerPoint> GetPoints() const;
+
+   private:
+    struct Bucket {
+      uint64_t index;
+      uint64_t count;
+      uint64_t sum;
+      uint32_t min;
+      uint32_t max;
+    };
+
+    struct Extreme {
+      uint64_t index;
+      uint32_t value;
+    };
+
+    void Open(uint64_t index);
+    void Close();
+    void Evict(uint64_t newest_index);
+
+    uint64_t period_ms_;
+    std::size_t size_;
+
+    std::deque<Bucket> closed_;
+    bool opened_;
+    Bucket open_;
+
+    uint64_t window_count_;
+    uint64_t window_sum_;
+    std::deque<Extreme> window_minima_;
+    std::deque<Extreme> window_maxima_;
+  };
+
+  const Level &GetLevel(ViewerResolution resolution) const;
+
+  mutable std::mutex mutex_;
+  Level seconds_;
+  Level minutes_;
+  Level ten_minutes_;
+  uint32_t peak_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_VIEWER_VIEWER_SERIES_H_
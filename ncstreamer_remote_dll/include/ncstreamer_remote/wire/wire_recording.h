@@ -0,0 +1,111 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_WIRE_WIRE_RECORDING_H_
+#define NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_WIRE_WIRE_RECORDING_H_
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>  // NOLINT
+#include <string>
+
+
+namespace ncstreamer_remote {
+enum class WireDirection : uint8_t {
+  kInbound = 0,
+  kOutbound,
+};
+
+
+struct WireFrame {
+  /// From the recording started.
+  uint64_t timestamp_us;
+  WireDirection direction;
+  /// Into the mapped file, valid while the reader is.
+  const char *payload;
+  std::size_t size;
+};
+
+
+struct WireReplayStats {
+  /// Inbound frames dispatched.
+  uint64_t frames;
+  uint64_t bytes;
+  /// Frames whose handling threw, as for a response without a handler.
+  uint64_t failures;
+
+  /// Spent in dispatching only.
+  uint64_t dispatch_us;
+  /// Including the waits at the recorded pace.
+  uint64_t elapsed_us;
+  /// Frames dispatched per second of `dispatch_us`.
+  double frames_per_second;
+};
+
+
+/// Appends the frames in and out to a recording, of
+/// a 16-byte file header of the magic "NCSWIRE1" and 8 reserved bytes,
+/// and then frames, each of a 16-byte frame header of the timestamp (8),
+/// the payload size (4), the direction (1) and 3 reserved bytes,
+/// followed by the payload padded up to 8 bytes.
+/// The headers stay aligned so that a mapped recording is read in place,
+/// and a recording cut short is read up to its last whole frame.
+/// Frames may come from any thread.
+class WireRecorder {
+ public:
+  /// Replaces the file at `path`.
+  explicit WireRecorder(const std::string &path);
+  /// Flushes the frames left.
+  virtual ~WireRecorder();
+
+  bool is_open() const { return opened_; }
+
+  void Append(WireDirection direction, const char *payload, std::size_t size);
+
+  uint64_t frames() const { return frames_; }
+
+ private:
+  WireRecorder(const WireRecorder &) = delete;
+  WireRecorder &operator=(const WireRecorder &) = delete;
+
+  std::mutex mutex_;
+  std::ofstream file_;
+  bool opened_;
+  uint64_t started_us_;
+  std::atomic<uint64_t> frames_;
+};
+
+
+/// Reads the frames of a recording in order, from the file mapped.
+class WireReader {
+ public:
+  explicit WireReader(const std::string &path);
+  virtual ~WireReader();
+
+  /// False for a missing file or a file of another format.
+  bool is_open() const { return view_ != nullptr; }
+
+  /// False at the end.
+  bool Next(WireFrame *frame);
+
+ private:
+  WireReader(const WireReader &) = delete;
+  WireReader &operator=(const WireReader &) = delete;
+
+  void Close();
+
+  void *file_;
+  void *mapping_;
+  const char *view_;
+  std::size_t size_;
+  std::size_t offset_;
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_INCLUDE_NCSTREAMER_REMOTE_WIRE_WIRE_RECORDING_H_
@@ -0,0 +1,196 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/chat_analytics.h"
+
+#include <cmath>
+
+
+namespace {
+const std::size_t kWindowSeconds[] = {10, 60, 300};
+
+/// The moving average follows the last couple of minutes.
+const double kUsualRateWeight{1.0 / 120.0};
+
+/// A burst starts when the last 10 seconds run this many times
+/// above the usual rate, and ends below the lower one.
+const double kBurstStartRatio{3.0};
+const double kBurstEndRatio{1.5};
+const uint32_t kBurstMinComments{10};
+
+/// No burst is told until the usual rate has had a minute to settle.
+const uint64_t kBurstWarmUpSeconds{60};
+
+
+uint64_t HashAuthor(const wchar_t *author) {
+  // FNV-1a, then the finalizer of SplitMix64 to spread the bits.
+  uint64_t hash{14695981039346656037ULL};
+  for (const wchar_t *ch = author; *ch != L'\0'; ++ch) {
+    hash ^= static_cast<uint64_t>(*ch);
+    hash *= 1099511628211ULL;
+  }
+  hash ^= hash >> 30;
+  hash *= 0xBF58476D1CE4E5B9ULL;
+  hash ^= hash >> 27;
+  hash *= 0x94D049BB133111EBULL;
+  hash ^= hash >> 31;
+  return hash;
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote {
+ChatAnalytics::ChatAnalytics()
+    : started_{false},
+      current_second_{0},
+      seconds_seen_{0},
+      usual_rate_{0.0},
+      total_{0},
+      bursting_{false},
+      bursts_{0} {
+  static_assert(sizeof(kWindowSeconds) / sizeof(kWindowSeconds[0]) ==
+                    kWindowCount,
+                "every window needs its running count");
+  Reset();
+}
+
+
+ChatAnalytics::~ChatAnalytics() {
+}
+
+
+void ChatAnalytics::Add(uint64_t now_ms, const CommentRecord &record) {
+  Advance(now_ms);
+
+  ++counts_[current_second_ % kSeconds];
+  for (auto &window_count : window_counts_) {
+    ++window_count;
+  }
+  ++total_;
+
+  const uint64_t hash = HashAuthor(record.author);
+  const std::size_t index = static_cast<std::size_t>(
+      hash >> (64 - kRegisterBits));
+  uint64_t rest = hash << kRegisterBits;
+  uint8_t rank{1};
+  while (rank <= 64 - kRegisterBits && (rest & (1ULL << 63)) == 0) {
+    rest <<= 1;
+    ++rank;
+  }
+  if (rank > registers_[index]) {
+    registers_[index] = rank;
+  }
+
+  UpdateBurst();
+}
+
+
+void ChatAnalytics::Advance(uint64_t now_ms) {
+  const uint64_t now_second{now_ms / 1000};
+  if (started_ == false) {
+    started_ = true;
+    current_second_ = now_second;
+    return;
+  }
+  if (now_second <= current_second_) {
+    return;
+  }
+
+  if (now_second - current_second_ >= kSeconds) {
+    for (auto &count : counts_) {
+      count = 0;
+    }
+    for (auto &window_count : window_counts_) {
+      window_count = 0;
+    }
+    usual_rate_ = 0.0;
+    seconds_seen_ = 0;
+    current_second_ = now_second;
+    UpdateBurst();
+    return;
+  }
+
+  while (current_second_ < now_second) {
+    const uint32_t closed_count = counts_[current_second_ % kSeconds];
+    usual_rate_ += kUsualRateWeight * (closed_count - usual_rate_);
+
+    ++current_second_;
+    ++seconds_seen_;
+    for (std::size_t i = 0; i < kWindowCount; ++i) {
+      // nothing leaves a window yet on a clock started near zero.
+      if (current_second_ < kWindowSeconds[i]) {
+        continue;
+      }
+      const uint64_t leaving = current_second_ - kWindowSeconds[i];
+      window_counts_[i] -= counts_[leaving % kSeconds];
+    }
+    counts_[current_second_ % kSeconds] = 0;
+  }
+  UpdateBurst();
+}
+
+
+void ChatAnalytics::Reset() {
+  started_ = false;
+  current_second_ = 0;
+  seconds_seen_ = 0;
+  usual_rate_ = 0.0;
+  for (auto &count : counts_) {
+    count = 0;
+  }
+  for (auto &window_count : window_counts_) {
+    window_count = 0;
+  }
+  total_ = 0;
+  for (auto &reg : registers_) {
+    reg = 0;
+  }
+  bursting_ = false;
+  bursts_ = 0;
+}
+
+
+ChatStats ChatAnalytics::GetStats() const {
+  ChatStats stats;
+  stats.comments_last_10_seconds = window_counts_[0];
+  stats.comments_last_minute = window_counts_[1];
+  stats.comments_last_5_minutes = window_counts_[2];
+  stats.comments_total = total_;
+  stats.bursting = bursting_;
+  stats.bursts = bursts_;
+
+  double sum{0.0};
+  std::size_t zeros{0};
+  for (const auto &reg : registers_) {
+    const uint8_t rank = reg;
+    sum += std::ldexp(1.0, -rank);
+    zeros += (rank == 0) ? 1 : 0;
+  }
+  const double m{static_cast<double>(kRegisterCount)};
+  double estimate{(0.7213 / (1.0 + 1.079 / m)) * m * m / sum};
+  if (estimate <= 2.5 * m && zeros != 0) {
+    // linear counting is more accurate while many registers are empty.
+    estimate = m * std::log(m / zeros);
+  }
+  stats.unique_authors = static_cast<uint64_t>(estimate + 0.5);
+  return stats;
+}
+
+
+void ChatAnalytics::UpdateBurst() {
+  const double recent_rate{window_counts_[0] / 10.0};
+  if (bursting_ == false) {
+    if (seconds_seen_ >= kBurstWarmUpSeconds &&
+        window_counts_[0] >= kBurstMinComments &&
+        recent_rate >= kBurstStartRatio * usual_rate_) {
+      bursting_ = true;
+      ++bursts_;
+    }
+  } else if (recent_rate < kBurstEndRatio * usual_rate_ ||
+             window_counts_[0] < kBurstMinComments / 2) {
+    bursting_ = false;
+  }
+}
+}  // namespace ncstreamer_remote
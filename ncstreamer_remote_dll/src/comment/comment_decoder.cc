@@ -0,0 +1,145 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/src/comment/comment_decoder.h"
+
+#include <cassert>
+#include <codecvt>
+#include <cwchar>
+#include <istream>
+#include <locale>
+#include <vector>
+
+#include "boost/property_tree/json_parser.hpp"
+
+#include "ncstreamer_remote_dll/src/message/message_stream.h"
+
+
+namespace {
+using CommentTree = boost::property_tree::basic_ptree<
+    ncstreamer_remote::ResourceString,
+    ncstreamer_remote::ResourceString>;
+using CommentText =
+    std::vector<wchar_t, ncstreamer_remote::ResourceAllocator<wchar_t>>;
+
+
+const ncstreamer_remote::ResourceString *FindField(
+    const CommentTree &comment,
+    const char *path) {
+  const auto &field = comment.get_child_optional(path);
+  return field ? &field->data() : nullptr;
+}
+
+
+std::size_t GetFieldSize(
+    const CommentTree &comment,
+    const char *path) {
+  const ncstreamer_remote::ResourceString *field = FindField(comment, path);
+  return field ? field->size() : 0;
+}
+
+
+/// @param text Reserved beforehand for the UTF-16 of `field`,
+///        which is never longer than its UTF-8,
+///        so that the strings appended before stay in place.
+const wchar_t *AppendField(
+    const CommentTree &comment,
+    const char *path,
+    CommentText *text) {
+  static const std::codecvt_utf8_utf16<wchar_t> kCodec{};
+
+  const ncstreamer_remote::ResourceString *field = FindField(comment, path);
+  const std::size_t offset{text->size()};
+  const std::size_t max_size{field ? field->size() : 0};
+  text->resize(offset + max_size + 1);
+
+  wchar_t *to = text->data() + offset;
+  wchar_t *to_next = to;
+  if (field) {
+    std::mbstate_t state{};
+    const char *from_next{nullptr};
+    auto result = kCodec.in(
+        state,
+        field->data(), field->data() + field->size(), from_next,
+        to, to + max_size, to_next);
+    if (result != std::codecvt_base::ok) {
+      to_next = to;
+    }
+  }
+  *to_next = L'\0';
+  text->resize(static_cast<std::size_t>(to_next - text->data()) + 1);
+  return to;
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote {
+bool CommentDecoder::Decode(
+    const char *comments,
+    std::size_t size,
+    const CommentFilter *filter,
+    CommentRecords *out) {
+  static const char *const kFields[] = {
+      "id", "from.name", "message", "created_time"};
+
+  assert(out->empty() == true);
+  if (size == 0) {
+    return true;
+  }
+
+  CommentTree tree;
+  PayloadReadBuffer comments_buf{comments, size};
+  std::istream ss{&comments_buf};
+  try {
+    boost::property_tree::read_json(ss, tree);
+  } catch (const std::exception &/*e*/) {
+    return false;
+  }
+
+  const auto &data = tree.get_child_optional("data");
+  const CommentTree &list = data ? *data : tree;
+
+  const CommentFilter::Match kNoMatch{false, 0};
+  std::vector<CommentFilter::Match,
+              ResourceAllocator<CommentFilter::Match>> matches;
+  matches.reserve(list.size());
+
+  std::size_t record_count{0};
+  std::size_t text_size{0};
+  for (const auto &comment : list) {
+    const ResourceString *text = FindField(comment.second, kFields[2]);
+    matches.emplace_back(filter && text ?
+        filter->Scan(text->data(), text->size()) : kNoMatch);
+    if (matches.back().drop == true) {
+      continue;
+    }
+
+    ++record_count;
+    for (const char *field : kFields) {
+      text_size += GetFieldSize(comment.second, field) + 1;
+    }
+  }
+  out->text_.reserve(text_size);
+  out->records_.reserve(record_count);
+
+  auto match = matches.begin();
+  for (const auto &comment : list) {
+    const CommentFilter::Match &comment_match = *match++;
+    if (comment_match.drop == true) {
+      continue;
+    }
+
+    CommentRecord record;
+    record.tags = comment_match.tags;
+    record.id = AppendField(comment.second, kFields[0], &out->text_);
+    record.author = AppendField(comment.second, kFields[1], &out->text_);
+    record.text = AppendField(comment.second, kFields[2], &out->text_);
+    record.created_time =
+        AppendField(comment.second, kFields[3], &out->text_);
+    out->records_.emplace_back(record);
+  }
+  return true;
+}
+}  // namespace ncstreamer_remote
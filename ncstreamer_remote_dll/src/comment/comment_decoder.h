@@ -0,0 +1,35 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_SRC_COMMENT_COMMENT_DECODER_H_
+#define NCSTREAMER_REMOTE_DLL_SRC_COMMENT_COMMENT_DECODER_H_
+
+
+#include <cstddef>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_filter.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_records.h"
+
+
+namespace ncstreamer_remote {
+class CommentDecoder {
+ public:
+  /// @param comments JSON list of comments from NCStreamer,
+  ///        either a bare array or an object holding it as "data".
+  ///        Each comment has "id", "created_time", "message"
+  ///        and "from.name", and a missing field decodes as empty.
+  /// @param filter Drops or tags the comments by their text, if not null.
+  /// @param out Empty records to fill in the order of the list.
+  /// @return False if `comments` is not such a list.
+  static bool Decode(
+      const char *comments,
+      std::size_t size,
+      const CommentFilter *filter,
+      CommentRecords *out);
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_SRC_COMMENT_COMMENT_DECODER_H_
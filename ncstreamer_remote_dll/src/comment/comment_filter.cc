@@ -0,0 +1,128 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_filter.h"
+
+#include <codecvt>
+#include <locale>
+#include <queue>
+
+
+namespace {
+const uint32_t kNoState{0xFFFFFFFF};
+
+
+unsigned char FoldCase(unsigned char byte) {
+  return (byte >= 'A' && byte <= 'Z') ? byte - 'A' + 'a' : byte;
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote {
+CommentFilter::CommentFilter(
+    const std::vector<CommentFilterRule> &rules,
+    bool ignore_case)
+    : byte_classes_(256, 0),
+      class_count_{1},
+      transitions_{},
+      outputs_{} {
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  std::vector<std::string> patterns;
+  patterns.reserve(rules.size());
+  for (const CommentFilterRule &rule : rules) {
+    std::string pattern{converter.to_bytes(rule.pattern)};
+    for (char &ch : pattern) {
+      unsigned char byte = static_cast<unsigned char>(ch);
+      if (ignore_case == true) {
+        byte = FoldCase(byte);
+        ch = static_cast<char>(byte);
+      }
+      if (byte_classes_[byte] == 0) {
+        byte_classes_[byte] = static_cast<uint16_t>(class_count_++);
+      }
+    }
+    patterns.emplace_back(std::move(pattern));
+  }
+  if (ignore_case == true) {
+    for (unsigned char byte = 'A'; byte <= 'Z'; ++byte) {
+      byte_classes_[byte] = byte_classes_[FoldCase(byte)];
+    }
+  }
+
+  // the trie, whose missing transitions are kNoState for now.
+  const Match kNoMatch{false, 0};
+  transitions_.assign(class_count_, kNoState);
+  outputs_.assign(1, kNoMatch);
+  for (std::size_t i = 0; i < patterns.size(); ++i) {
+    if (patterns[i].empty() == true) {
+      continue;
+    }
+    uint32_t state{0};
+    for (char ch : patterns[i]) {
+      const uint16_t cls = byte_classes_[static_cast<unsigned char>(ch)];
+      uint32_t &next = transitions_[state * class_count_ + cls];
+      if (next == kNoState) {
+        next = static_cast<uint32_t>(outputs_.size());
+        transitions_.resize(transitions_.size() + class_count_, kNoState);
+        outputs_.emplace_back(kNoMatch);
+      }
+      state = transitions_[state * class_count_ + cls];
+    }
+    outputs_[state].drop |= rules[i].drop;
+    outputs_[state].tags |= rules[i].drop ? 0 : rules[i].tags;
+  }
+
+  // breadth first, every state falls back to its longest proper suffix,
+  // inheriting its outputs and its transitions.
+  std::vector<uint32_t> fallbacks(outputs_.size(), 0);
+  std::queue<uint32_t> states;
+  for (std::size_t cls = 0; cls < class_count_; ++cls) {
+    uint32_t &next = transitions_[cls];
+    if (next == kNoState) {
+      next = 0;
+    } else {
+      states.push(next);
+    }
+  }
+  while (states.empty() == false) {
+    const uint32_t state = states.front();
+    states.pop();
+    const uint32_t fallback = fallbacks[state];
+    outputs_[state].drop |= outputs_[fallback].drop;
+    outputs_[state].tags |= outputs_[fallback].tags;
+
+    for (std::size_t cls = 0; cls < class_count_; ++cls) {
+      uint32_t &next = transitions_[state * class_count_ + cls];
+      const uint32_t fallback_next =
+          transitions_[fallback * class_count_ + cls];
+      if (next == kNoState) {
+        next = fallback_next;
+      } else {
+        fallbacks[next] = fallback_next;
+        states.push(next);
+      }
+    }
+  }
+}
+
+
+CommentFilter::~CommentFilter() {
+}
+
+
+CommentFilter::Match CommentFilter::Scan(
+    const char *text,
+    std::size_t size) const {
+  Match match{false, 0};
+  uint32_t state{0};
+  for (std::size_t i = 0; i < size; ++i) {
+    const uint16_t cls = byte_classes_[static_cast<unsigned char>(text[i])];
+    state = transitions_[state * class_count_ + cls];
+    match.drop |= outputs_[state].drop;
+    match.tags |= outputs_[state].tags;
+  }
+  return match;
+}
+}  // namespace ncstreamer_remote
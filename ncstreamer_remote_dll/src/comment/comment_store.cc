@@ -0,0 +1,124 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_store.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace ncstreamer_remote {
+CommentStore::CommentStore(std::size_t capacity)
+    : mutex_{},
+      capacity_{capacity},
+      ring_{},
+      oldest_{0},
+      ids_{},
+      cursor_{} {
+  assert(capacity_ > 0);
+  ring_.reserve(capacity_);
+  ids_.reserve(capacity_);
+}
+
+
+CommentStore::~CommentStore() {
+}
+
+
+std::size_t CommentStore::Add(const CommentRecords &records) {
+  return Add(records, nullptr);
+}
+
+
+std::size_t CommentStore::Add(
+    const CommentRecords &records,
+    const std::function<void(const CommentRecord &record)> &on_added) {
+  std::lock_guard<std::mutex> lock{mutex_};
+
+  std::size_t added{0};
+  for (const CommentRecord &record : records) {
+    if (ids_.count(record.id) != 0) {
+      continue;
+    }
+
+    Comment *slot{nullptr};
+    if (ring_.size() < capacity_) {
+      ring_.emplace_back();
+      slot = &ring_.back();
+    } else {
+      slot = &ring_[oldest_];
+      ids_.erase(slot->id);
+      oldest_ = (oldest_ + 1) % capacity_;
+    }
+
+    // assign() keeps the capacity of the evicted comment's strings.
+    slot->id.assign(record.id);
+    slot->author.assign(record.author);
+    slot->text.assign(record.text);
+    slot->created_time.assign(record.created_time);
+    ids_.emplace(slot->id);
+
+    if (slot->created_time > cursor_) {
+      cursor_ = slot->created_time;
+    }
+    if (on_added) {
+      on_added(record);
+    }
+    ++added;
+  }
+  return added;
+}
+
+
+void CommentStore::Clear() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  ring_.clear();
+  oldest_ = 0;
+  ids_.clear();
+  cursor_.clear();
+}
+
+
+std::vector<Comment> CommentStore::GetLast(std::size_t count) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+
+  const std::size_t size{std::min(count, ring_.size())};
+  std::vector<Comment> comments;
+  comments.reserve(size);
+  for (std::size_t i = ring_.size() - size; i < ring_.size(); ++i) {
+    comments.emplace_back(At(i));
+  }
+  return comments;
+}
+
+
+std::vector<Comment> CommentStore::GetSince(
+    const std::wstring &created_time) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+
+  std::size_t first{ring_.size()};
+  while (first > 0 && At(first - 1).created_time > created_time) {
+    --first;
+  }
+
+  std::vector<Comment> comments;
+  comments.reserve(ring_.size() - first);
+  for (std::size_t i = first; i < ring_.size(); ++i) {
+    comments.emplace_back(At(i));
+  }
+  return comments;
+}
+
+
+std::wstring CommentStore::GetCursor() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return cursor_;
+}
+
+
+const Comment &CommentStore::At(std::size_t i) const {
+  return ring_[(oldest_ + i) % ring_.size()];
+}
+}  // namespace ncstreamer_remote
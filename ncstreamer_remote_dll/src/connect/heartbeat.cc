@@ -0,0 +1,61 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/connect/heartbeat.h"
+
+
+namespace ncstreamer_remote {
+Heartbeat::Heartbeat()
+    : sequence_{0},
+      ping_sent_us_{0},
+      awaiting_pong_{false},
+      last_rtt_us_{0},
+      missed_pongs_{0},
+      rtt_histogram_{} {
+}
+
+
+Heartbeat::~Heartbeat() {
+}
+
+
+void Heartbeat::Reset() {
+  ping_sent_us_ = 0;
+  awaiting_pong_ = false;
+  last_rtt_us_ = 0;
+  missed_pongs_ = 0;
+}
+
+
+std::string Heartbeat::OnPing(uint64_t now_us) {
+  ++sequence_;
+  ping_sent_us_ = now_us;
+  awaiting_pong_ = true;
+  return std::to_string(sequence_);
+}
+
+
+bool Heartbeat::OnPong(const std::string &payload, uint64_t now_us) {
+  if (awaiting_pong_ == false || payload != std::to_string(sequence_)) {
+    return false;
+  }
+  awaiting_pong_ = false;
+
+  const uint64_t rtt_us = now_us - ping_sent_us_;
+  last_rtt_us_ = rtt_us;
+  missed_pongs_ = 0;
+  rtt_histogram_.Record(rtt_us);
+  return true;
+}
+
+
+uint32_t Heartbeat::OnPongTimeout(const std::string &payload) {
+  if (awaiting_pong_ == true && payload == std::to_string(sequence_)) {
+    awaiting_pong_ = false;
+    ++missed_pongs_;
+  }
+  return missed_pongs_;
+}
+}  // namespace ncstreamer_remote
@@ -0,0 +1,102 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/connect/port_discovery.h"
+
+#include <fstream>
+
+
+namespace ncstreamer_remote {
+PortCache::PortCache(const std::string &path)
+    : path_{path} {
+}
+
+
+PortCache::~PortCache() {
+}
+
+
+uint16_t PortCache::Load() const {
+  if (path_.empty() == true) {
+    return 0;
+  }
+
+  std::ifstream file{path_};
+  uint32_t port{0};
+  if (!(file >> port) || port > UINT16_MAX) {
+    return 0;
+  }
+  return static_cast<uint16_t>(port);
+}
+
+
+void PortCache::Save(uint16_t port) const {
+  if (path_.empty() == true) {
+    return;
+  }
+
+  std::ofstream file{path_, std::ios::trunc};
+  file << port << std::endl;
+}
+
+
+PortCacheWriter::PortCacheWriter()
+    : mutex_{},
+      pending_changed_{},
+      pending_path_{},
+      pending_port_{0},
+      pending_{false},
+      stopping_{false},
+      thread_{} {
+}
+
+
+PortCacheWriter::~PortCacheWriter() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
+  pending_changed_.notify_one();
+  if (thread_.joinable() == true) {
+    thread_.join();
+  }
+}
+
+
+void PortCacheWriter::Save(const std::string &path, uint16_t port) {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    pending_path_ = path;
+    pending_port_ = port;
+    pending_ = true;
+    if (thread_.joinable() == false) {
+      thread_ = std::thread{[this]() {
+        Run();
+      }};
+    }
+  }
+  pending_changed_.notify_one();
+}
+
+
+void PortCacheWriter::Run() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  while (true) {
+    pending_changed_.wait(lock, [this]() {
+      return pending_ == true || stopping_ == true;
+    });
+    if (pending_ == false) {
+      return;  // stopping.
+    }
+    const std::string path = pending_path_;
+    const uint16_t port = pending_port_;
+    pending_ = false;
+
+    lock.unlock();
+    PortCache{path}.Save(port);
+    lock.lock();
+  }
+}
+}  // namespace ncstreamer_remote
@@ -0,0 +1,53 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/connect/reconnect_backoff.h"
+
+#include <algorithm>
+
+
+namespace ncstreamer_remote {
+ReconnectBackoff::ReconnectBackoff(
+    const ReconnectPolicy &policy,
+    uint32_t seed)
+    : policy_(policy),
+      random_{seed},
+      delay_ms_{0.0},
+      attempts_{0} {
+  Reset();
+}
+
+
+ReconnectBackoff::~ReconnectBackoff() {
+}
+
+
+void ReconnectBackoff::SetPolicy(const ReconnectPolicy &policy) {
+  policy_ = policy;
+  delay_ms_ = std::min(
+      delay_ms_, static_cast<double>(policy_.max_delay_ms));
+}
+
+
+uint32_t ReconnectBackoff::NextDelayMs() {
+  const double jitter = std::max(0.0, std::min(policy_.jitter, 1.0));
+  std::uniform_real_distribution<double> fraction{0.0, jitter};
+  const double delay_ms = delay_ms_ * (1.0 - fraction(random_));
+
+  delay_ms_ = std::min(
+      delay_ms_ * std::max(policy_.multiplier, 1.0),
+      static_cast<double>(policy_.max_delay_ms));
+  ++attempts_;
+  return static_cast<uint32_t>(delay_ms);
+}
+
+
+void ReconnectBackoff::Reset() {
+  // at least 1 ms, so that the delay can grow from it.
+  delay_ms_ = std::max(
+      std::min(policy_.initial_delay_ms, policy_.max_delay_ms), 1U);
+  attempts_ = 0;
+}
+}  // namespace ncstreamer_remote
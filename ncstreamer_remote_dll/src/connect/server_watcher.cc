@@ -0,0 +1,159 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/connect/server_watcher.h"
+
+#include <algorithm>
+#include <future>  // NOLINT
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "Windows.h"  // NOLINT
+
+
+namespace {
+/// The hook thread, running while any watcher is alive.
+class HookThread {
+ public:
+  static HookThread *Get() {
+    static HookThread *const kInstance{new HookThread{}};
+    return kInstance;
+  }
+
+  void Add(ncstreamer_remote::ServerWatcher *watcher) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    watchers_.emplace_back(watcher);
+    if (watchers_.size() == 1) {
+      Start();
+    }
+  }
+
+  void Remove(ncstreamer_remote::ServerWatcher *watcher) {
+    std::thread stopped;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      watchers_.erase(
+          std::remove(watchers_.begin(), watchers_.end(), watcher),
+          watchers_.end());
+      if (watchers_.empty() == false) {
+        return;
+      }
+      ::PostThreadMessage(thread_id_, WM_QUIT, 0, 0);
+      stopped.swap(thread_);
+    }
+    if (stopped.joinable() == true) {
+      stopped.join();
+    }
+  }
+
+  void OnWindowShown(HWND wnd) {
+    static const int kMaxTitle{256};
+    wchar_t title[kMaxTitle];
+    const int size = ::GetWindowTextW(wnd, title, kMaxTitle);
+    if (size <= 0) {
+      return;
+    }
+
+    // a watcher removed is never called after Remove() returns.
+    const std::wstring window_title{title, static_cast<std::size_t>(size)};
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (auto *watcher : watchers_) {
+      watcher->OnWindowShown(window_title);
+    }
+  }
+
+ private:
+  HookThread()
+      : mutex_{},
+        watchers_{},
+        thread_id_{0},
+        thread_{} {
+  }
+
+  void Start() {
+    std::promise<DWORD> started;
+    std::future<DWORD> thread_id = started.get_future();
+    thread_ = std::thread{[this, &started]() {
+      // a message queue of this thread, for WM_QUIT to be posted to.
+      MSG msg;
+      ::PeekMessage(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+      started.set_value(::GetCurrentThreadId());
+      Run();
+    }};
+    thread_id_ = thread_id.get();
+  }
+
+  void Run() {
+    // shown for a new window, and renamed for a title set after showing.
+    static const DWORD kEvents[] = {
+        EVENT_OBJECT_SHOW, EVENT_OBJECT_NAMECHANGE};
+
+    std::vector<HWINEVENTHOOK> hooks;
+    for (DWORD evt : kEvents) {
+      HWINEVENTHOOK hook = ::SetWinEventHook(
+          evt, evt, NULL, OnWinEvent, 0, 0,
+          WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+      if (hook != NULL) {
+        hooks.emplace_back(hook);
+      }
+    }
+
+    // out-of-context hooks are called back from this message loop.
+    MSG msg;
+    while (::GetMessage(&msg, NULL, 0, 0) > 0) {
+      ::TranslateMessage(&msg);
+      ::DispatchMessage(&msg);
+    }
+
+    for (HWINEVENTHOOK hook : hooks) {
+      ::UnhookWinEvent(hook);
+    }
+  }
+
+  static void CALLBACK OnWinEvent(
+      HWINEVENTHOOK /*hook*/,
+      DWORD /*evt*/,
+      HWND wnd,
+      LONG object_id,
+      LONG child_id,
+      DWORD /*event_thread*/,
+      DWORD /*event_time*/) {
+    if (object_id != OBJID_WINDOW || child_id != CHILDID_SELF) {
+      return;
+    }
+    Get()->OnWindowShown(wnd);
+  }
+
+  std::mutex mutex_;
+  std::vector<ncstreamer_remote::ServerWatcher *> watchers_;
+  DWORD thread_id_;
+  std::thread thread_;
+};
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote {
+ServerWatcher::ServerWatcher(
+    const std::wstring &window_title,
+    const AppearHandler &appear_handler)
+    : window_title_{window_title},
+      appear_handler_{appear_handler} {
+  HookThread::Get()->Add(this);
+}
+
+
+ServerWatcher::~ServerWatcher() {
+  HookThread::Get()->Remove(this);
+}
+
+
+void ServerWatcher::OnWindowShown(const std::wstring &window_title) {
+  if (window_title != window_title_) {
+    return;
+  }
+  appear_handler_();
+}
+}  // namespace ncstreamer_remote
@@ -0,0 +1,36 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/handler/handler_memory.h"
+
+
+namespace ncstreamer_remote {
+HandlerMemory::HandlerMemory(MemoryResource *upstream)
+    : upstream_{upstream},
+      storage_{},
+      in_use_{false} {
+}
+
+
+HandlerMemory::~HandlerMemory() {
+}
+
+
+void *HandlerMemory::Allocate(std::size_t size) {
+  if (size <= kSize && in_use_.exchange(true) == false) {
+    return &storage_;
+  }
+  return upstream_->Allocate(size);
+}
+
+
+void HandlerMemory::Deallocate(void *p, std::size_t size) {
+  if (p == &storage_) {
+    in_use_ = false;
+    return;
+  }
+  upstream_->Deallocate(p, size);
+}
+}  // namespace ncstreamer_remote
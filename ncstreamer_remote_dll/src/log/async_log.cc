@@ -0,0 +1,199 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/log/async_log.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+
+
+namespace {
+const std::chrono::milliseconds kFlushInterval{100};
+
+
+std::size_t RoundUpToPowerOfTwo(std::size_t n) {
+  std::size_t power{1};
+  while (power < n) {
+    power <<= 1;
+  }
+  return power;
+}
+
+
+std::string ToRotatedPath(const std::string &path, uint32_t index) {
+  return path + "." + std::to_string(index);
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote {
+AsyncLog::AsyncLog(const std::string &path, const AsyncLogPolicy &policy)
+    : path_{path},
+      policy_(policy),
+      access_ring_{policy.ring_size},
+      error_ring_{policy.ring_size},
+      access_stream_{&access_ring_},
+      error_stream_{&error_ring_},
+      file_{path, std::ios::app},
+      file_size_{0},
+      written_bytes_{0},
+      rotations_{0},
+      stop_mutex_{},
+      stop_condition_{},
+      stopping_{false},
+      flusher_{} {
+  file_.seekp(0, std::ios::end);
+  const std::streamoff size = file_.tellp();
+  file_size_ = (size > 0) ? static_cast<uint64_t>(size) : 0;
+
+  flusher_ = std::thread{[this]() {
+    std::unique_lock<std::mutex> lock{stop_mutex_};
+    while (stopping_ == false) {
+      lock.unlock();
+      Flush();
+      lock.lock();
+      stop_condition_.wait_for(lock, kFlushInterval);
+    }
+  }};
+}
+
+
+AsyncLog::~AsyncLog() {
+  {
+    std::lock_guard<std::mutex> lock{stop_mutex_};
+    stopping_ = true;
+  }
+  stop_condition_.notify_one();
+  if (flusher_.joinable() == true) {
+    flusher_.join();
+  }
+
+  access_stream_.flush();
+  error_stream_.flush();
+  Flush();
+}
+
+
+AsyncLogStats AsyncLog::GetStats() const {
+  AsyncLogStats stats;
+  stats.written_bytes = written_bytes_;
+  stats.dropped_bytes =
+      access_ring_.dropped_bytes() + error_ring_.dropped_bytes();
+  stats.rotations = rotations_;
+  return stats;
+}
+
+
+void AsyncLog::Flush() {
+  const std::size_t written =
+      access_ring_.DrainTo(&file_) + error_ring_.DrainTo(&file_);
+  if (written == 0) {
+    return;
+  }
+  file_.flush();
+  file_size_ += written;
+  written_bytes_ += written;
+
+  if (policy_.max_file_size != 0 && file_size_ >= policy_.max_file_size) {
+    Rotate();
+  }
+}
+
+
+void AsyncLog::Rotate() {
+  file_.close();
+  if (policy_.max_rotated_files == 0) {
+    std::remove(path_.c_str());
+  } else {
+    std::remove(ToRotatedPath(path_, policy_.max_rotated_files).c_str());
+    for (uint32_t i = policy_.max_rotated_files - 1; i > 0; --i) {
+      std::rename(
+          ToRotatedPath(path_, i).c_str(),
+          ToRotatedPath(path_, i + 1).c_str());
+    }
+    std::rename(path_.c_str(), ToRotatedPath(path_, 1).c_str());
+  }
+  file_.open(path_, std::ios::trunc);
+  file_size_ = 0;
+  ++rotations_;
+}
+
+
+AsyncLog::Ring::Ring(std::size_t size)
+    : std::streambuf{},
+      buffer_(RoundUpToPowerOfTwo(size)),
+      mask_{buffer_.size() - 1},
+      head_{0},
+      tail_{0},
+      dropped_bytes_{0},
+      piece_(kPieceSize) {
+  assert(size > 0);
+  setp(piece_.data(), piece_.data() + piece_.size());
+}
+
+
+AsyncLog::Ring::~Ring() {
+}
+
+
+std::size_t AsyncLog::Ring::DrainTo(std::ostream *out) {
+  const std::size_t tail = tail_.load(std::memory_order_relaxed);
+  const std::size_t head = head_.load(std::memory_order_acquire);
+  const std::size_t size = head - tail;
+  if (size == 0) {
+    return 0;
+  }
+
+  const std::size_t begin = tail & mask_;
+  const std::size_t first = std::min(size, buffer_.size() - begin);
+  out->write(buffer_.data() + begin, first);
+  out->write(buffer_.data(), size - first);
+
+  tail_.store(head, std::memory_order_release);
+  return size;
+}
+
+
+AsyncLog::Ring::int_type AsyncLog::Ring::overflow(int_type c) {
+  Publish();
+  if (traits_type::eq_int_type(c, traits_type::eof()) == false) {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+
+int AsyncLog::Ring::sync() {
+  Publish();
+  return 0;
+}
+
+
+void AsyncLog::Ring::Publish() {
+  const std::size_t size = pptr() - pbase();
+  setp(piece_.data(), piece_.data() + piece_.size());
+  if (size == 0) {
+    return;
+  }
+
+  const std::size_t head = head_.load(std::memory_order_relaxed);
+  const std::size_t tail = tail_.load(std::memory_order_acquire);
+  if (size > buffer_.size() - (head - tail)) {
+    dropped_bytes_ += size;
+    return;
+  }
+
+  const std::size_t begin = head & mask_;
+  const std::size_t first = std::min(size, buffer_.size() - begin);
+  std::memcpy(buffer_.data() + begin, piece_.data(), first);
+  std::memcpy(buffer_.data(), piece_.data() + first, size - first);
+
+  head_.store(head + size, std::memory_order_release);
+}
+}  // namespace ncstreamer_remote
@@ -0,0 +1,192 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/memory/memory_resource.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+
+namespace {
+class NewDeleteResource : public ncstreamer_remote::MemoryResource {
+ protected:
+  void *DoAllocate(std::size_t bytes, std::size_t /*alignment*/) override {
+    return ::operator new(bytes);
+  }
+
+  void DoDeallocate(
+      void *p, std::size_t /*bytes*/, std::size_t /*alignment*/) override {
+    ::operator delete(p);
+  }
+
+  bool DoIsEqual(
+      const ncstreamer_remote::MemoryResource &other) const override {
+    return this == &other;
+  }
+};
+
+
+// never destroyed, as memory may be given back to it during exit.
+ncstreamer_remote::MemoryResource *const static_new_delete_resource{
+    new NewDeleteResource{}};
+
+std::atomic<ncstreamer_remote::MemoryResource *> static_default_resource{
+    nullptr};
+
+#if _MSC_VER >= 1900 || !defined(_MSC_VER)
+thread_local ncstreamer_remote::MemoryResource *static_current_resource{
+    nullptr};
+#else
+__declspec(thread) ncstreamer_remote::MemoryResource *static_current_resource =
+    nullptr;
+#endif  // _MSC_VER >= 1900 || !defined(_MSC_VER)
+
+
+const std::size_t kDefaultInitialChunkSize{4096};
+
+
+char *AlignUp(char *p, std::size_t alignment) {
+  const std::uintptr_t value = reinterpret_cast<std::uintptr_t>(p);
+  const std::uintptr_t aligned = (value + alignment - 1) & ~(alignment - 1);
+  return reinterpret_cast<char *>(aligned);
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote {
+MemoryResource *GetNewDeleteResource() {
+  return static_new_delete_resource;
+}
+
+
+MemoryResource *GetDefaultMemoryResource() {
+  MemoryResource *resource = static_default_resource;
+  return resource ? resource : GetNewDeleteResource();
+}
+
+
+MemoryResource *SetDefaultMemoryResource(MemoryResource *resource) {
+  MemoryResource *previous = static_default_resource.exchange(resource);
+  return previous ? previous : GetNewDeleteResource();
+}
+
+
+MemoryResource *GetCurrentMemoryResource() {
+  return static_current_resource ?
+      static_current_resource : GetDefaultMemoryResource();
+}
+
+
+ScopedMemoryResource::ScopedMemoryResource(MemoryResource *resource)
+    : previous_{static_current_resource} {
+  static_current_resource = resource;
+}
+
+
+ScopedMemoryResource::~ScopedMemoryResource() {
+  static_current_resource = previous_;
+}
+
+
+MonotonicBufferResource::MonotonicBufferResource(
+    MemoryResource *upstream,
+    std::size_t initial_size)
+    : upstream_{upstream},
+      next_chunk_size_{initial_size},
+      first_chunk_{nullptr},
+      current_chunk_{nullptr},
+      cursor_{nullptr},
+      end_{nullptr} {
+}
+
+
+MonotonicBufferResource::MonotonicBufferResource(MemoryResource *upstream)
+    : MonotonicBufferResource{upstream, kDefaultInitialChunkSize} {
+}
+
+
+MonotonicBufferResource::~MonotonicBufferResource() {
+  FreeChunks(first_chunk_);
+}
+
+
+void MonotonicBufferResource::Release() {
+  if (!first_chunk_) {
+    return;
+  }
+
+  if (first_chunk_->next) {
+    // retains one chunk as large as the last round needed in total.
+    std::size_t total_size{0};
+    for (Chunk *chunk = first_chunk_; chunk; chunk = chunk->next) {
+      total_size += chunk->size;
+    }
+    FreeChunks(first_chunk_);
+    first_chunk_ = nullptr;
+    current_chunk_ = nullptr;
+    next_chunk_size_ = total_size;
+    AddChunk(0);
+    return;
+  }
+
+  current_chunk_ = first_chunk_;
+  cursor_ = reinterpret_cast<char *>(first_chunk_ + 1);
+  end_ = reinterpret_cast<char *>(first_chunk_) + first_chunk_->size;
+}
+
+
+void *MonotonicBufferResource::DoAllocate(
+    std::size_t bytes, std::size_t alignment) {
+  char *p = cursor_ ? AlignUp(cursor_, alignment) : nullptr;
+  if (!p || p + bytes > end_) {
+    AddChunk(bytes + alignment);
+    p = AlignUp(cursor_, alignment);
+  }
+  cursor_ = p + bytes;
+  return p;
+}
+
+
+void MonotonicBufferResource::DoDeallocate(
+    void * /*p*/, std::size_t /*bytes*/, std::size_t /*alignment*/) {
+}
+
+
+bool MonotonicBufferResource::DoIsEqual(const MemoryResource &other) const {
+  return this == &other;
+}
+
+
+void MonotonicBufferResource::AddChunk(std::size_t min_size) {
+  const std::size_t size =
+      std::max(next_chunk_size_, min_size + sizeof(Chunk));
+  next_chunk_size_ = size * 2;
+
+  Chunk *chunk = static_cast<Chunk *>(upstream_->Allocate(size));
+  chunk->next = nullptr;
+  chunk->size = size;
+
+  if (current_chunk_) {
+    current_chunk_->next = chunk;
+  } else {
+    first_chunk_ = chunk;
+  }
+  current_chunk_ = chunk;
+
+  cursor_ = reinterpret_cast<char *>(chunk + 1);
+  end_ = reinterpret_cast<char *>(chunk) + size;
+}
+
+
+void MonotonicBufferResource::FreeChunks(Chunk *chunk) {
+  while (chunk) {
+    Chunk *next = chunk->next;
+    upstream_->Deallocate(chunk, chunk->size);
+    chunk = next;
+  }
+}
+}  // namespace ncstreamer_remote
@@ -0,0 +1,37 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/message/message_pool.h"
+
+
+namespace {
+#if _MSC_VER >= 1900 || !defined(_MSC_VER)
+thread_local const websocketpp::lib::shared_ptr<
+    ncstreamer_remote::MessagePoolBase> *static_current_pool{nullptr};
+#else
+__declspec(thread) const websocketpp::lib::shared_ptr<
+    ncstreamer_remote::MessagePoolBase> *static_current_pool = nullptr;
+#endif  // _MSC_VER >= 1900 || !defined(_MSC_VER)
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote {
+const websocketpp::lib::shared_ptr<MessagePoolBase> *GetCurrentMessagePool() {
+  return static_current_pool;
+}
+
+
+ScopedMessagePool::ScopedMessagePool(
+    const websocketpp::lib::shared_ptr<MessagePoolBase> &pool)
+    : pool_{pool},
+      previous_{static_current_pool} {
+  static_current_pool = &pool_;
+}
+
+
+ScopedMessagePool::~ScopedMessagePool() {
+  static_current_pool = previous_;
+}
+}  // namespace ncstreamer_remote
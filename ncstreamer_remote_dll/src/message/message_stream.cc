@@ -0,0 +1,24 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/src/message/message_stream.h"
+
+
+namespace ncstreamer_remote {
+PayloadReadBuffer::PayloadReadBuffer(const char *data, std::size_t size)
+    : std::streambuf{} {
+  char *begin = const_cast<char *>(data);
+  setg(begin, begin, begin + size);
+}
+
+
+PayloadReadBuffer::PayloadReadBuffer(const std::string &payload)
+    : PayloadReadBuffer{payload.data(), payload.size()} {
+}
+
+
+PayloadReadBuffer::~PayloadReadBuffer() {
+}
+}  // namespace ncstreamer_remote
@@ -0,0 +1,57 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_DLL_SRC_MESSAGE_MESSAGE_STREAM_H_
+#define NCSTREAMER_REMOTE_DLL_SRC_MESSAGE_MESSAGE_STREAM_H_
+
+
+#include <cstddef>
+#include <streambuf>
+#include <string>
+
+
+namespace ncstreamer_remote {
+/// Output buffer appending straight into a caller-owned string,
+/// so that a reused string keeps its capacity across messages.
+template <typename String>
+class StringAppendBuffer : public std::streambuf {
+ public:
+  explicit StringAppendBuffer(String *out)
+      : std::streambuf{},
+        out_{out} {}
+
+  virtual ~StringAppendBuffer() {}
+
+ protected:
+  int_type overflow(int_type ch) override {
+    if (traits_type::eq_int_type(ch, traits_type::eof()) == true) {
+      return traits_type::not_eof(ch);
+    }
+    out_->push_back(traits_type::to_char_type(ch));
+    return ch;
+  }
+
+  std::streamsize xsputn(const char *s, std::streamsize n) override {
+    out_->append(s, static_cast<std::size_t>(n));
+    return n;
+  }
+
+ private:
+  String *out_;
+};
+
+
+/// Read-only input buffer over a payload owned by someone else,
+/// to parse a received message without copying it.
+class PayloadReadBuffer : public std::streambuf {
+ public:
+  PayloadReadBuffer(const char *data, std::size_t size);
+  explicit PayloadReadBuffer(const std::string &payload);
+  virtual ~PayloadReadBuffer();
+};
+}  // namespace ncstreamer_remote
+
+
+#endif  // NCSTREAMER_REMOTE_DLL_SRC_MESSAGE_MESSAGE_STREAM_H_
@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/metric/latency_histogram.h"
+
+#include <algorithm>
+#include <limits>
+
+
+namespace ncstreamer_remote {
+LatencyHistogram::LatencyHistogram()
+    : sum_us_{0},
+      min_us_{0},
+      max_us_{0} {
+  Clear();
+}
+
+
+LatencyHistogram::~LatencyHistogram() {
+}
+
+
+void LatencyHistogram::Record(uint64_t latency_us) {
+  // the count is summed up from the buckets when read.
+  ++buckets_[ToBucket(latency_us)];
+  sum_us_ += latency_us;
+
+  uint64_t min_us = min_us_;
+  while (latency_us < min_us &&
+         min_us_.compare_exchange_weak(min_us, latency_us) == false) {
+  }
+  uint64_t max_us = max_us_;
+  while (latency_us > max_us &&
+         max_us_.compare_exchange_weak(max_us, latency_us) == false) {
+  }
+}
+
+
+void LatencyHistogram::Clear() {
+  for (auto &bucket : buckets_) {
+    bucket = 0;
+  }
+  sum_us_ = 0;
+  min_us_ = std::numeric_limits<uint64_t>::max();
+  max_us_ = 0;
+}
+
+
+LatencyStats LatencyHistogram::GetStats() const {
+  uint64_t counts[kBucketCount];
+  uint64_t count{0};
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    counts[i] = buckets_[i];
+    count += counts[i];
+  }
+
+  LatencyStats stats;
+  stats.count = count;
+  stats.min_us = (count == 0) ? 0 : static_cast<uint64_t>(min_us_);
+  stats.max_us = max_us_;
+  stats.mean_us = (count == 0) ? 0 : sum_us_ / count;
+  stats.p50_us = 0;
+  stats.p90_us = 0;
+  stats.p99_us = 0;
+  if (count == 0) {
+    return stats;
+  }
+
+  struct Percentile {
+    uint64_t rank;
+    uint64_t *value;
+  };
+  const Percentile percentiles[] = {
+      {(count * 50 + 99) / 100, &stats.p50_us},
+      {(count * 90 + 99) / 100, &stats.p90_us},
+      {(count * 99 + 99) / 100, &stats.p99_us}};
+
+  uint64_t seen{0};
+  std::size_t next{0};
+  for (std::size_t i = 0; i < kBucketCount && next < 3; ++i) {
+    seen += counts[i];
+    while (next < 3 && seen >= percentiles[next].rank) {
+      *percentiles[next].value = std::min(
+          GetBucketUpperBound(i), static_cast<uint64_t>(stats.max_us));
+      ++next;
+    }
+  }
+  return stats;
+}
+
+
+uint64_t LatencyHistogram::GetBucketUpperBound(std::size_t bucket) {
+  if (bucket < 16) {
+    return bucket;
+  }
+  const std::size_t exponent = 4 + (bucket - 16) / 4;
+  const uint64_t sub = (bucket - 16) % 4;
+  const uint64_t step = 1ULL << (exponent - 2);
+  return (1ULL << exponent) + (sub + 1) * step - 1;
+}
+
+
+uint64_t LatencyHistogram::GetBucketCount(std::size_t bucket) const {
+  return buckets_[bucket];
+}
+
+
+std::size_t LatencyHistogram::ToBucket(uint64_t latency_us) {
+  if (latency_us < 16) {
+    return static_cast<std::size_t>(latency_us);
+  }
+  std::size_t exponent{4};
+  while (exponent < 63 && (latency_us >> (exponent + 1)) != 0) {
+    ++exponent;
+  }
+  const std::size_t sub =
+      static_cast<std::size_t>((latency_us >> (exponent - 2)) & 3);
+  return 16 + (exponent - 4) * 4 + sub;
+}
+}  // namespace ncstreamer_remote
@@ -0,0 +1,220 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/metric/request_metrics.h"
+
+#include <algorithm>
+#include <sstream>
+
+
+namespace {
+/// Set on every error key, so that 0 tells an empty slot.
+const uint64_t kUsedKey{1ULL << 63};
+
+
+uint64_t ToErrorKey(
+    int message_type,
+    ncstreamer_remote::ErrorCategory category,
+    int code) {
+  return kUsedKey |
+      (static_cast<uint64_t>(static_cast<uint32_t>(message_type)) << 32) |
+      (static_cast<uint64_t>(static_cast<uint16_t>(category)) << 16) |
+      static_cast<uint16_t>(code);
+}
+
+
+std::size_t HashErrorKey(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  return static_cast<std::size_t>(key);
+}
+
+
+void WriteSummary(
+    const std::string &name,
+    int message_type,
+    const ncstreamer_remote::LatencyStats &stats,
+    std::ostream *out) {
+  const std::string &labels = "type=\"" + std::to_string(message_type) + "\"";
+  *out << name << "{" << labels << ",quantile=\"0.5\"} "
+       << stats.p50_us / 1e6 << "\n"
+       << name << "{" << labels << ",quantile=\"0.9\"} "
+       << stats.p90_us / 1e6 << "\n"
+       << name << "{" << labels << ",quantile=\"0.99\"} "
+       << stats.p99_us / 1e6 << "\n"
+       << name << "_sum{" << labels << "} "
+       << stats.mean_us * stats.count / 1e6 << "\n"
+       << name << "_count{" << labels << "} " << stats.count << "\n";
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote {
+RequestMetrics::RequestMetrics(const std::vector<int> &message_types)
+    : message_types_{message_types},
+      slots_{},
+      slots_by_type_{},
+      parse_failures_{0} {
+  int max_type{0};
+  for (int message_type : message_types_) {
+    max_type = std::max(max_type, message_type);
+  }
+  slots_by_type_.resize(max_type + 1, nullptr);
+  for (int message_type : message_types_) {
+    slots_.emplace_back(new TypeSlot{});
+    slots_by_type_[message_type] = slots_.back().get();
+  }
+  for (std::size_t i = 0; i < kErrorSlotCount; ++i) {
+    error_keys_[i] = 0;
+    error_counts_[i] = 0;
+  }
+}
+
+
+RequestMetrics::~RequestMetrics() {
+}
+
+
+void RequestMetrics::OnSent(int message_type, uint64_t queue_wait_us) {
+  TypeSlot *slot = FindSlot(message_type);
+  if (!slot) {
+    return;
+  }
+  ++slot->requests;
+  slot->queue_wait.Record(queue_wait_us);
+}
+
+
+void RequestMetrics::OnResponded(
+    int message_type,
+    uint64_t wire_rtt_us,
+    uint64_t latency_us) {
+  TypeSlot *slot = FindSlot(message_type);
+  if (!slot) {
+    return;
+  }
+  slot->wire_rtt.Record(wire_rtt_us);
+  slot->latency.Record(latency_us);
+}
+
+
+void RequestMetrics::OnError(
+    int message_type,
+    ErrorCategory category,
+    int code) {
+  TypeSlot *slot = FindSlot(message_type);
+  if (slot) {
+    ++slot->errors;
+  }
+
+  const uint64_t key = ToErrorKey(message_type, category, code);
+  std::size_t i = HashErrorKey(key) % kErrorSlotCount;
+  for (std::size_t probes = 0; probes < kErrorSlotCount; ++probes) {
+    uint64_t found = error_keys_[i];
+    if (found == 0 &&
+        error_keys_[i].compare_exchange_strong(found, key) == true) {
+      found = key;
+    }
+    if (found == key) {
+      ++error_counts_[i];
+      return;
+    }
+    i = (i + 1) % kErrorSlotCount;
+  }
+  // more distinct errors than slots are left uncounted.
+}
+
+
+void RequestMetrics::OnParseFailure() {
+  ++parse_failures_;
+}
+
+
+RequestMetricsSnapshot RequestMetrics::GetSnapshot() const {
+  RequestMetricsSnapshot snapshot;
+  snapshot.requests.reserve(slots_.size());
+  for (std::size_t i = 0; i < slots_.size(); ++i) {
+    const TypeSlot &slot = *slots_[i];
+    RequestTypeMetrics metrics;
+    metrics.message_type = message_types_[i];
+    metrics.requests = slot.requests;
+    metrics.errors = slot.errors;
+    metrics.queue_wait = slot.queue_wait.GetStats();
+    metrics.wire_rtt = slot.wire_rtt.GetStats();
+    metrics.latency = slot.latency.GetStats();
+    snapshot.requests.emplace_back(metrics);
+  }
+
+  for (std::size_t i = 0; i < kErrorSlotCount; ++i) {
+    const uint64_t key = error_keys_[i];
+    const uint64_t count = error_counts_[i];
+    if (key == 0 || count == 0) {
+      continue;
+    }
+    ErrorCount error;
+    error.message_type = static_cast<int>(
+        static_cast<uint32_t>((key & ~kUsedKey) >> 32));
+    error.category = static_cast<ErrorCategory>((key >> 16) & 0xFFFF);
+    error.code = static_cast<int>(key & 0xFFFF);
+    error.count = count;
+    snapshot.errors.emplace_back(error);
+  }
+
+  snapshot.parse_failures = parse_failures_;
+  return snapshot;
+}
+
+
+std::string RequestMetrics::ToOpenMetrics() const {
+  const RequestMetricsSnapshot &snapshot = GetSnapshot();
+  std::ostringstream out;
+
+  out << "# TYPE ncstreamer_remote_requests counter\n";
+  for (const auto &metrics : snapshot.requests) {
+    out << "ncstreamer_remote_requests_total{type=\""
+        << metrics.message_type << "\"} " << metrics.requests << "\n";
+  }
+
+  out << "# TYPE ncstreamer_remote_request_errors counter\n";
+  for (const auto &error : snapshot.errors) {
+    out << "ncstreamer_remote_request_errors_total{type=\""
+        << error.message_type << "\",category=\""
+        << static_cast<int>(error.category) << "\",code=\""
+        << error.code << "\"} " << error.count << "\n";
+  }
+
+  out << "# TYPE ncstreamer_remote_parse_failures counter\n"
+      << "ncstreamer_remote_parse_failures_total "
+      << snapshot.parse_failures << "\n";
+
+  static const char *const kSummaries[] = {
+      "ncstreamer_remote_request_queue_wait_seconds",
+      "ncstreamer_remote_request_wire_rtt_seconds",
+      "ncstreamer_remote_request_latency_seconds"};
+  for (std::size_t i = 0; i < 3; ++i) {
+    out << "# TYPE " << kSummaries[i] << " summary\n"
+        << "# UNIT " << kSummaries[i] << " seconds\n";
+    for (const auto &metrics : snapshot.requests) {
+      const LatencyStats &stats =
+          (i == 0) ? metrics.queue_wait :
+          (i == 1) ? metrics.wire_rtt : metrics.latency;
+      WriteSummary(kSummaries[i], metrics.message_type, stats, &out);
+    }
+  }
+
+  out << "# EOF\n";
+  return out.str();
+}
+
+
+RequestMetrics::TypeSlot *RequestMetrics::FindSlot(int message_type) const {
+  if (message_type < 0 ||
+      static_cast<std::size_t>(message_type) >= slots_by_type_.size()) {
+    return nullptr;
+  }
+  return slots_by_type_[message_type];
+}
+}  // namespace ncstreamer_remote
@@ -0,0 +1,146 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/metric/trace_recorder.h"
+
+#include <set>
+#include <sstream>
+
+
+namespace {
+const char *const kPhaseNames[] = {
+    "request",
+    "queue",
+    "connect",
+    "serialize",
+    "remote",
+    "parse",
+    "handler"};
+
+
+const char *ToPhaseName(ncstreamer_remote::TracePhase phase) {
+  const std::size_t i = static_cast<std::size_t>(phase);
+  if (i >= sizeof(kPhaseNames) / sizeof(kPhaseNames[0])) {
+    return "unknown";
+  }
+  return kPhaseNames[i];
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote {
+TraceRecorder::TraceRecorder(std::size_t capacity)
+    : capacity_{capacity},
+      allocation_mutex_{},
+      spans_{},
+      enabled_{false},
+      next_{0} {
+}
+
+
+TraceRecorder::~TraceRecorder() {
+}
+
+
+void TraceRecorder::SetEnabled(bool enabled) {
+  std::lock_guard<std::mutex> lock{allocation_mutex_};
+  if (enabled == true && !spans_) {
+    if (capacity_ == 0) {
+      return;
+    }
+    spans_.reset(new Span[capacity_]);
+  }
+  enabled_.store(enabled, std::memory_order_release);
+}
+
+
+void TraceRecorder::Record(
+    TracePhase phase,
+    int message_type,
+    uint64_t request_id,
+    uint64_t begin_us,
+    uint64_t end_us) {
+  if (enabled() == false) {
+    return;
+  }
+
+  const uint64_t index = next_.fetch_add(1, std::memory_order_relaxed);
+  Span &span = spans_[static_cast<std::size_t>(index % capacity_)];
+  span.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  span.phase = phase;
+  span.message_type = message_type;
+  span.request_id = request_id;
+  span.begin_us = begin_us;
+  span.end_us = end_us;
+  span.sequence.store(index + 1, std::memory_order_release);
+}
+
+
+TraceStats TraceRecorder::GetStats() const {
+  const uint64_t recorded = next_;
+  TraceStats stats;
+  stats.recorded = recorded;
+  stats.overwritten = (recorded > capacity_) ? recorded - capacity_ : 0;
+  return stats;
+}
+
+
+std::string TraceRecorder::ToChromeTrace() const {
+  std::ostringstream out;
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":["
+      << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+      << "\"args\":{\"name\":\"ncstreamer_remote\"}}";
+
+  const Span *spans{nullptr};
+  {
+    std::lock_guard<std::mutex> lock{allocation_mutex_};
+    spans = spans_.get();
+  }
+  if (!spans) {
+    out << "]}";
+    return out.str();
+  }
+
+  std::set<uint64_t> tracks;
+  const uint64_t end = next_;
+  const uint64_t begin = (end > capacity_) ? end - capacity_ : 0;
+  for (uint64_t index = begin; index < end; ++index) {
+    const Span &span = spans[static_cast<std::size_t>(index % capacity_)];
+    if (span.sequence.load(std::memory_order_acquire) != index + 1) {
+      continue;
+    }
+    const TracePhase phase = span.phase;
+    const int message_type = span.message_type;
+    const uint64_t request_id = span.request_id;
+    const uint64_t begin_us = span.begin_us;
+    const uint64_t end_us = span.end_us;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (span.sequence.load(std::memory_order_relaxed) != index + 1) {
+      continue;  // overwritten while being read.
+    }
+
+    if (tracks.insert(request_id).second == true) {
+      out << ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+          << request_id << ",\"args\":{\"name\":\"";
+      if (request_id == 0) {
+        out << "events";
+      } else {
+        out << "request " << request_id;
+      }
+      out << "\"}}";
+    }
+    out << ",{\"name\":\"" << ToPhaseName(phase)
+        << "\",\"cat\":\"ncstreamer_remote\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+        << request_id << ",\"ts\":" << begin_us
+        << ",\"dur\":" << ((end_us > begin_us) ? end_us - begin_us : 0)
+        << ",\"args\":{\"type\":" << message_type
+        << ",\"request\":" << request_id << "}}";
+  }
+
+  out << "]}";
+  return out.str();
+}
+}  // namespace ncstreamer_remote
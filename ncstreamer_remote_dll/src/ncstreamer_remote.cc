@@ -5,42 +5,221 @@
 
 #include "ncstreamer_remote_dll/include/ncstreamer_remote/ncstreamer_remote.h"
 
+#include <algorithm>
 #include <cassert>
 #include <codecvt>
+#include <cstdlib>
+#include <future>  // NOLINT
+#include <istream>
 #include <locale>
+#include <ostream>
 #include <sstream>
-#include <unordered_map>
+#include <unordered_set>
 
 #include "boost/algorithm/string.hpp"
 #include "boost/property_tree/json_parser.hpp"
 
 #include "Windows.h"  // NOLINT
 
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/chat_analytics.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_filter.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_store.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/connect/heartbeat.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/connect/port_discovery.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/connect/reconnect_backoff.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/connect/server_watcher.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/executor/remote_executor.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/handler/handler_memory.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/log/async_log.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/metric/latency_histogram.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/metric/request_metrics.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/metric/trace_recorder.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/poll/poll_schedule.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/session/session_state.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/status/status_mirror.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/viewer/viewer_series.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/wire/wire_recording.h"
+#include "ncstreamer_remote_dll/src/comment/comment_decoder.h"
 #include "ncstreamer_remote_dll/src/error/error_converter.h"
+#include "ncstreamer_remote_dll/src/message/message_stream.h"
 #include "ncstreamer_remote_dll/src/ncstreamer_remote_message_types.h"
 
 
 namespace {
 namespace placeholders = websocketpp::lib::placeholders;
+using RemoteMessageType = ncstreamer::RemoteMessage::MessageType;
+
+const std::size_t kCommentStoreCapacity{1000};
+const double kDefaultPollRateCeiling{4.0};
+const ncstreamer_remote::ReconnectPolicy kDefaultReconnectPolicy{
+    500, 2.0, 30 * 1000, 0.2};
+const ncstreamer_remote::HeartbeatPolicy kDefaultHeartbeatPolicy{
+    5 * 1000, 3 * 1000, 2};
+const uint32_t kDefaultStatusMaxAge{30 * 1000};
+// before the other loopback address is tried alongside the first,
+// as Windows retries a refused loopback connection for a while.
+const uint32_t kConnectFallbackDelay{100};
+const ncstreamer_remote::AsyncLogPolicy kDefaultLogPolicy{
+    1024 * 1024, 10 * 1024 * 1024, 3};
+const uint32_t kDefaultAccessChannels{
+    websocketpp::log::alevel::all &
+    ~(websocketpp::log::alevel::frame_header |
+      websocketpp::log::alevel::frame_payload)};
+const uint32_t kDefaultFrameLogSampling{100};
+const uint16_t kDefaultRemotePort{9003};
+const std::size_t kTraceCapacity{16 * 1024};
+
+const std::vector<int> kRequestTypes{
+    static_cast<int>(RemoteMessageType::kStreamingStatusRequest),
+    static_cast<int>(RemoteMessageType::kStreamingStartRequest),
+    static_cast<int>(RemoteMessageType::kStreamingStopRequest),
+    static_cast<int>(RemoteMessageType::kSettingsQualityUpdateRequest),
+    static_cast<int>(RemoteMessageType::kStreamingCommentsRequest),
+    static_cast<int>(RemoteMessageType::kStreamingCommentsSubscribeRequest),
+    static_cast<int>(RemoteMessageType::kStreamingCommentsUnsubscribeRequest),
+    static_cast<int>(RemoteMessageType::kSettingsWebcamSearchRequest),
+    static_cast<int>(RemoteMessageType::kSettingsWebcamOnRequest),
+    static_cast<int>(RemoteMessageType::kSettingsWebcamOffRequest),
+    static_cast<int>(RemoteMessageType::kSettingsWebcamSizeRequest),
+    static_cast<int>(RemoteMessageType::kSettingsWebcamPositionRequest),
+    static_cast<int>(RemoteMessageType::kSettingsChromaKeyOnRequest),
+    static_cast<int>(RemoteMessageType::kSettingsChromaKeyOffRequest),
+    static_cast<int>(RemoteMessageType::kSettingsChromaKeyColorRequest),
+    static_cast<int>(RemoteMessageType::kSettingsChromaKeySimilarityRequest),
+    static_cast<int>(RemoteMessageType::kSettingsMicOnRequest),
+    static_cast<int>(RemoteMessageType::kSettingsMicOffRequest),
+    static_cast<int>(RemoteMessageType::kSettingsMicSearchRequest),
+    static_cast<int>(RemoteMessageType::kStreamingViewersRequest),
+    static_cast<int>(RemoteMessageType::kNcStreamerExitRequest)};
+
+/// Requests sent on the bulk connection, if any.
+/// Their responses and the comments events subscribed
+/// come back on the same connection.
+const std::unordered_set<int> kBulkRequestTypes{
+    static_cast<int>(RemoteMessageType::kStreamingCommentsRequest),
+    static_cast<int>(RemoteMessageType::kStreamingCommentsSubscribeRequest),
+    static_cast<int>(RemoteMessageType::kStreamingCommentsUnsubscribeRequest),
+    static_cast<int>(RemoteMessageType::kSettingsWebcamSearchRequest),
+    static_cast<int>(RemoteMessageType::kSettingsMicSearchRequest)};
+const ncstreamer_remote::PortDiscoveryPolicy kDefaultPortDiscovery{
+    {9003, 9004, 9005, 9006, 9007, 9008, 9009, 9010},
+    500,
+    "ncstreamer_remote.port"};
+
+
+uint64_t GetSteadyMilliseconds() {
+  const auto &now = Chrono::duration_cast<Chrono::milliseconds>(
+      Chrono::steady_clock::now().time_since_epoch());
+  return static_cast<uint64_t>(now.count());
+}
+
+
+uint64_t GetSteadyMicroseconds() {
+  const auto &now = Chrono::duration_cast<Chrono::microseconds>(
+      Chrono::steady_clock::now().time_since_epoch());
+  return static_cast<uint64_t>(now.count());
+}
+
+
+std::shared_ptr<const std::vector<websocketpp::uri_ptr>> NewLoopbackUris(
+    uint16_t port) {
+  return std::make_shared<const std::vector<websocketpp::uri_ptr>>(
+      std::vector<websocketpp::uri_ptr>{
+          websocketpp::uri_ptr{new websocketpp::uri{false, "::1", port, ""}},
+          websocketpp::uri_ptr{
+              new websocketpp::uri{false, "127.0.0.1", port, ""}}});
+}
+
+
+bool IsStatusResponse(const std::string &payload) {
+  boost::property_tree::ptree tree;
+  std::istringstream ss{payload};
+  try {
+    boost::property_tree::read_json(ss, tree);
+    return tree.get<int>("type") ==
+        static_cast<int>(RemoteMessageType::kStreamingStatusResponse);
+  } catch (const std::exception &/*e*/) {
+    return false;
+  }
+}
 }  // unnamed namespace
 
 
 namespace ncstreamer_remote {
+struct NcStreamerRemote::RequestLane {
+  explicit RequestLane(MemoryResource *memory_resource)
+      : busy{false},
+        error_handler{},
+        request{},
+        text{},
+        query{},
+        requested_us{0},
+        waiting{false},
+        in_flight{false},
+        polled{nullptr},
+        poll_changed{false},
+        type{0},
+        id{0},
+        begun_us{0},
+        sent_us{0},
+        sent_connection{},
+        handler_memory{memory_resource} {}
+
+  std::atomic_bool busy;
+  Inplace<ErrorHandler> error_handler;
+  LaneRequest request;
+  /// The string argument of the request, if any.
+  std::wstring text;
+  CommentsQuery query;
+  uint64_t requested_us;
+
+  /// The rest is of the io thread.
+  /// Set while the request waits for the poll in flight.
+  bool waiting;
+  bool in_flight;
+  /// Of the poll in flight, which the caller doesn't wait for.
+  PollSchedule *polled;
+  bool poll_changed;
+  /// Of the request sent. 0 until sent.
+  int type;
+  uint64_t id;
+  uint64_t begun_us;
+  uint64_t sent_us;
+  websocketpp::connection_hdl sent_connection;
+  HandlerMemory handler_memory;
+};
+
+
 void NcStreamerRemote::SetUp(uint16_t remote_port) {
+  SetUp(remote_port, GetNewDeleteResource());
+}
+
+
+void NcStreamerRemote::SetUp(
+    uint16_t remote_port,
+    MemoryResource *memory_resource) {
   assert(!static_instance);
-  static_instance = new NcStreamerRemote{remote_port};
+  assert(memory_resource);
+  static_previous_resource = SetDefaultMemoryResource(memory_resource);
+  static_instance = Create(
+      remote_port, memory_resource, nullptr, "ncstreamer_remote.log");
 }
 
 
 void NcStreamerRemote::SetUpDefault() {
-  SetUp(9003);
+  const uint16_t cached_port =
+      PortCache{kDefaultPortDiscovery.cache_path}.Load();
+  SetUp(cached_port != 0 ? cached_port : kDefaultRemotePort);
+  static_instance->SetPortDiscovery(kDefaultPortDiscovery);
 }
 
 
 void NcStreamerRemote::ShutDown() {
   assert(static_instance);
-  delete static_instance;
+  Destroy(static_instance);
   static_instance = nullptr;
+  SetDefaultMemoryResource(static_previous_resource);
+  static_previous_resource = nullptr;
 }
 
 
@@ -50,365 +229,1222 @@ NcStreamerRemote *NcStreamerRemote::Get() {
 }
 
 
+NcStreamerRemote *NcStreamerRemote::Create(
+    uint16_t remote_port,
+    MemoryResource *memory_resource,
+    RemoteExecutor *executor,
+    const std::string &log_path) {
+  assert(memory_resource);
+  return new NcStreamerRemote{
+      remote_port, memory_resource, executor, log_path, false};
+}
+
+
+NcStreamerRemote *NcStreamerRemote::CreateOffline(
+    MemoryResource *memory_resource,
+    RemoteExecutor *executor) {
+  assert(memory_resource);
+  return new NcStreamerRemote{0, memory_resource, executor, "", true};
+}
+
+
+void NcStreamerRemote::Destroy(NcStreamerRemote *remote) {
+  assert(remote);
+  delete remote;
+}
+
+
 void NcStreamerRemote::RegisterConnectHandler(
     const ConnectHandler &connect_handler) {
-  connect_handler_ = connect_handler;
+  RegisterConnectHandler(Inplace<ConnectHandler>{connect_handler});
+}
+
+
+void NcStreamerRemote::RegisterConnectHandler(
+    Inplace<ConnectHandler> &&connect_handler) {
+  connect_handler_ = std::move(connect_handler);
 }
 
 
 void NcStreamerRemote::RegisterDisconnectHandler(
     const DisconnectHandler &disconnect_handler) {
-  disconnect_handler_ = disconnect_handler;
+  RegisterDisconnectHandler(Inplace<DisconnectHandler>{disconnect_handler});
+}
+
+
+void NcStreamerRemote::RegisterDisconnectHandler(
+    Inplace<DisconnectHandler> &&disconnect_handler) {
+  disconnect_handler_ = std::move(disconnect_handler);
 }
 
 
 void NcStreamerRemote::RegisterStartEventHandler(
     const StartEventHandler &start_event_handler) {
-  start_event_handler_ = start_event_handler;
+  RegisterStartEventHandler(Inplace<StartEventHandler>{start_event_handler});
+}
+
+
+void NcStreamerRemote::RegisterStartEventHandler(
+    Inplace<StartEventHandler> &&start_event_handler) {
+  start_event_handler_ = std::move(start_event_handler);
 }
 
 
 void NcStreamerRemote::RegisterStopEventHandler(
     const StopEventHandler &stop_event_handler) {
-  stop_event_handler_ = stop_event_handler;
+  RegisterStopEventHandler(Inplace<StopEventHandler>{stop_event_handler});
 }
 
 
-void NcStreamerRemote::RequestStatus(
-    const ErrorHandler &error_handler,
-    const StatusResponseHandler &status_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
-
-  current_error_handler_ = error_handler;
-  current_status_response_handler_ = status_response_handler;
+void NcStreamerRemote::RegisterStopEventHandler(
+    Inplace<StopEventHandler> &&stop_event_handler) {
+  stop_event_handler_ = std::move(stop_event_handler);
+}
 
-  if (!remote_connection_.lock()) {
-    Connect([this]() {
-      SendStatusRequest();
-    });
-    return;
-  }
 
-  SendStatusRequest();
+void NcStreamerRemote::RegisterCommentsEventHandler(
+    const CommentsEventHandler &comments_event_handler) {
+  RegisterCommentsEventHandler(
+      Inplace<CommentsEventHandler>{comments_event_handler});
 }
 
 
-void NcStreamerRemote::RequestStart(
-    const std::wstring &title,
-    const ErrorHandler &error_handler,
-    const StartResponseHandler &start_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
+void NcStreamerRemote::RegisterCommentsEventHandler(
+    Inplace<CommentsEventHandler> &&comments_event_handler) {
+  comments_event_handler_ = std::move(comments_event_handler);
+}
 
-  current_error_handler_ = error_handler;
-  current_start_response_handler_ = start_response_handler;
 
-  if (!remote_connection_.lock()) {
-    Connect([this, title]() {
-      SendStartRequest(title);
-    });
-    return;
-  }
+void NcStreamerRemote::RegisterCommentRecordsEventHandler(
+    const CommentRecordsHandler &comment_records_event_handler) {
+  RegisterCommentRecordsEventHandler(
+      Inplace<CommentRecordsHandler>{comment_records_event_handler});
+}
 
-  SendStartRequest(title);
+
+void NcStreamerRemote::RegisterCommentRecordsEventHandler(
+    Inplace<CommentRecordsHandler> &&comment_records_event_handler) {
+  comment_records_event_handler_ = std::move(comment_records_event_handler);
 }
 
 
-void NcStreamerRemote::RequestStop(
-    const std::wstring &title,
-    const ErrorHandler &error_handler,
-    const StopResponseHandler &stop_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
+MessagePoolStats NcStreamerRemote::GetMessagePoolStats() const {
+  return message_pool_->GetStats();
+}
 
-  current_error_handler_ = error_handler;
-  current_stop_response_handler_ = stop_response_handler;
 
-  if (!remote_connection_.lock()) {
-    Connect([this, title]() {
-      SendStopRequest(title);
-    });
+void NcStreamerRemote::SetLogChannels(
+    uint32_t access_channels,
+    uint32_t error_channels) {
+  if (!remote_log_) {
     return;
   }
-
-  SendStopRequest(title);
+  remote_.clear_access_channels(websocketpp::log::alevel::all);
+  remote_.set_access_channels(access_channels);
+  remote_.clear_error_channels(websocketpp::log::elevel::all);
+  remote_.set_error_channels(error_channels);
 }
 
 
-void NcStreamerRemote::RequestQualityUpdate(
-    const std::wstring &quality,
-    const ErrorHandler &error_handler,
-    const SuccessHandler &quality_update_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
+void NcStreamerRemote::SetFrameLogSampling(uint32_t one_in) {
+  frame_log_sampling_ = one_in;
+}
 
-  current_error_handler_ = error_handler;
-  current_quality_update_response_handler_ = quality_update_response_handler;
 
-  if (!remote_connection_.lock()) {
-    Connect([this, quality]() {
-      SendQualityUpdateRequest(quality);
-    });
-    return;
+AsyncLogStats NcStreamerRemote::GetLogStats() const {
+  if (!remote_log_) {
+    return AsyncLogStats{0, 0, 0};
   }
+  return remote_log_->GetStats();
+}
 
-  SendQualityUpdateRequest(quality);
+
+void NcStreamerRemote::SetReconnectPolicy(const ReconnectPolicy &policy) {
+  io_service_.post([this, policy]() {
+    reconnect_backoff_->SetPolicy(policy);
+  });
 }
 
 
-void NcStreamerRemote::RequestExit(
-    const ErrorHandler &error_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
+void NcStreamerRemote::SetHeartbeatPolicy(const HeartbeatPolicy &policy) {
+  io_service_.post([this, policy]() {
+    *heartbeat_policy_ = policy;
+    timer_to_ping_.cancel();
+    KeepHeartbeat();
+  });
+}
 
-  current_error_handler_ = error_handler;
 
-  if (!remote_connection_.lock()) {
-    Connect([this]() {
-      SendExitRequest();
-    });
-    return;
-  }
+void NcStreamerRemote::SetPortDiscovery(const PortDiscoveryPolicy &policy) {
+  io_service_.post([this, policy]() {
+    *port_discovery_ = policy;
+  });
+}
 
-  SendExitRequest();
+
+uint16_t NcStreamerRemote::GetRemotePort() const {
+  return remote_port_;
 }
 
 
-void NcStreamerRemote::RequstComments(
-    const std::wstring &created_time,
-    const ErrorHandler &error_handler,
-    const CommentsResponseHandler &comments_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
+void NcStreamerRemote::SetBulkConnection(bool enabled) {
+  bulk_enabled_ = enabled;
+  io_service_.post([this, enabled]() {
+    if (enabled == true) {
+      bulk_failed_ = false;
+      OpenBulkConnection();
+    } else {
+      CloseBulkConnection();
+    }
+  });
+}
 
-  current_error_handler_ = error_handler;
-  current_comments_response_handler_ = comments_response_handler;
 
-  if (!remote_connection_.lock()) {
-    Connect([this, created_time]() {
-      SendCommentsRequest(created_time);
-    });
-    return;
+ConnectionInfo NcStreamerRemote::GetConnectionInfo() const {
+  ConnectionInfo info;
+  info.state = connection_state_;
+  info.time_in_state_ms = GetSteadyMilliseconds() - connection_state_ms_;
+  info.last_rtt_us = heartbeat_->last_rtt_us();
+  info.missed_pongs = heartbeat_->missed_pongs();
+  info.reconnects = reconnects_;
+  {
+    std::lock_guard<std::mutex> lock{bulk_mutex_};
+    info.bulk_connected = !bulk_connection_.expired();
   }
+  return info;
+}
+
 
-  SendCommentsRequest(created_time);
+LatencyStats NcStreamerRemote::GetRttStats() const {
+  return heartbeat_->rtt_histogram().GetStats();
 }
 
 
-void NcStreamerRemote::RequestViewers(
-    const ErrorHandler &error_handler,
-    const ViewersResponseHandler &viewers_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
+LatencyStats NcStreamerRemote::GetConnectLatencyStats() const {
+  return connect_latency_->GetStats();
+}
 
-  current_error_handler_ = error_handler;
-  current_viewers_response_handler_ = viewers_response_handler;
 
-  if (!remote_connection_.lock()) {
-    Connect([this]() {
-      SendViewersRequest();
-    });
-    return;
-  }
+LatencyStats NcStreamerRemote::GetLaunchToResponseStats() const {
+  return launch_to_response_->GetStats();
+}
 
-  SendViewersRequest();
+
+RequestMetricsSnapshot NcStreamerRemote::GetRequestMetrics() const {
+  return request_metrics_->GetSnapshot();
 }
 
 
-void NcStreamerRemote::RequestWebcamSearch(
-    const ErrorHandler &error_handler,
-    const WebcamSearchResponseHandler &webcam_search_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
+std::string NcStreamerRemote::GetRequestMetricsText() const {
+  return request_metrics_->ToOpenMetrics();
+}
 
-  current_error_handler_ = error_handler;
-  current_webcam_search_response_handler_ = webcam_search_response_handler;
 
-  if (!remote_connection_.lock()) {
-    Connect([this]() {
-      SendWebcamSearchRequest();
-    });
-    return;
-  }
+void NcStreamerRemote::SetTracing(bool enabled) {
+  tracer_->SetEnabled(enabled);
+}
 
-  SendWebcamSearchRequest();
+
+TraceStats NcStreamerRemote::GetTraceStats() const {
+  return tracer_->GetStats();
 }
 
 
-void NcStreamerRemote::RequestWebcamOn(
-    const std::wstring &device_id,
-    const float &normal_width,
-    const float &normal_height,
-    const float &normal_x,
-    const float &normal_y,
-    const ErrorHandler &error_handler,
-    const WebcamResponseHandler &webcam_on_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
+std::string NcStreamerRemote::GetChromeTrace() const {
+  return tracer_->ToChromeTrace();
+}
 
-  current_error_handler_ = error_handler;
-  current_webcam_on_response_handler_ = webcam_on_response_handler;
 
-  if (!remote_connection_.lock()) {
-    Connect([
-        device_id, normal_width, normal_height, normal_x, normal_y, this]() {
-      SendWebcamOnRequest(
-          device_id, normal_width, normal_height, normal_x, normal_y);
-    });
-    return;
+bool NcStreamerRemote::StartWireRecording(const std::string &path) {
+  std::shared_ptr<WireRecorder> recorder{new WireRecorder{path}};
+  if (recorder->is_open() == false) {
+    return false;
   }
+  std::atomic_store(&wire_recorder_, recorder);
+  return true;
+}
 
-  SendWebcamOnRequest(
-      device_id, normal_width, normal_height, normal_x, normal_y);
+
+void NcStreamerRemote::StopWireRecording() {
+  std::atomic_store(&wire_recorder_, std::shared_ptr<WireRecorder>{});
 }
 
 
-void NcStreamerRemote::RequestWebcamOff(
-    const ErrorHandler &error_handler,
-    const WebcamResponseHandler &webcam_off_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
+WireReplayStats NcStreamerRemote::ReplayWireRecording(
+    const std::string &path,
+    bool at_recorded_pace) {
+  WireReplayStats stats{0, 0, 0, 0, 0, 0.0};
+  if (offline_ == false) {
+    LogError("wire replay into a connecting client");
+    return stats;
+  }
+  if (executor_->RunsInThisThread() == true) {
+    LogError("wire replay on the thread of the executor");
+    return stats;
+  }
+  WireReader reader{path};
+  if (reader.is_open() == false) {
+    return stats;
   }
-  busy_ = true;
 
-  current_error_handler_ = error_handler;
-  current_webcam_off_response_handler_ = webcam_off_response_handler;
+  const uint64_t started_us = GetSteadyMicroseconds();
+  uint64_t first_frame_us{0};
+  bool first{true};
 
-  if (!remote_connection_.lock()) {
-    Connect([this]() {
-      SendWebcamOffRequest();
+  // paced on this thread, so that the executor only dispatches.
+  WireFrame frame;
+  while (reader.Next(&frame) == true) {
+    if (frame.direction != WireDirection::kInbound) {
+      continue;
+    }
+    if (first == true) {
+      first_frame_us = frame.timestamp_us;
+      first = false;
+    }
+    if (at_recorded_pace == true) {
+      const uint64_t due_us =
+          started_us + (frame.timestamp_us - first_frame_us);
+      const uint64_t now_us = GetSteadyMicroseconds();
+      if (due_us > now_us) {
+        std::this_thread::sleep_for(
+            std::chrono::microseconds{due_us - now_us});
+      }
+    }
+    io_service_.post([this, frame, &stats]() {
+      ReplayWireFrame(frame, &stats);
     });
-    return;
   }
 
-  SendWebcamOffRequest();
+  // the frames point into `reader`, so wait until they are dispatched.
+  std::promise<void> replayed;
+  io_service_.post([&replayed]() {
+    replayed.set_value();
+  });
+  replayed.get_future().wait();
+  stats.elapsed_us = GetSteadyMicroseconds() - started_us;
+
+  if (stats.dispatch_us != 0) {
+    stats.frames_per_second =
+        stats.frames * 1e6 / static_cast<double>(stats.dispatch_us);
+  }
+  return stats;
 }
 
 
-void NcStreamerRemote::RequestWebcamSize(
-    const float &normal_width,
-    const float &normal_height,
-    const ErrorHandler &error_handler,
-    const WebcamResponseHandler &webcam_size_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
+SessionSnapshot NcStreamerRemote::GetSessionState() const {
+  return session_state_->Get();
+}
 
-  current_error_handler_ = error_handler;
-  current_webcam_size_response_handler_ = webcam_size_response_handler;
 
-  if (!remote_connection_.lock()) {
-    Connect([normal_width, normal_height, this]() {
-      SendWebcamSizeRequest(normal_width, normal_height);
-    });
-    return;
-  }
+void NcStreamerRemote::ClearSessionState() {
+  session_state_->Clear();
+}
 
-  SendWebcamSizeRequest(normal_width, normal_height);
+
+SessionReplayMetrics NcStreamerRemote::GetSessionReplayMetrics() const {
+  SessionReplayMetrics metrics;
+  metrics.replays = session_replays_;
+  metrics.requests = session_replay_requests_;
+  metrics.failures = session_replay_failures_;
+  metrics.restore_ms = session_restore_ms_;
+  return metrics;
 }
 
 
-void NcStreamerRemote::RequestWebcamPosition(
-    const float &normal_x,
-    const float &normal_y,
-    const ErrorHandler &error_handler,
-    const WebcamResponseHandler &webcam_position_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
+CachedStatus NcStreamerRemote::GetCachedStatus() const {
+  return status_mirror_->Get(GetSteadyMilliseconds());
+}
 
-  current_error_handler_ = error_handler;
-  current_webcam_position_response_handler_ = webcam_position_response_handler;
 
-  if (!remote_connection_.lock()) {
-    Connect([normal_x, normal_y, this]() {
-      SendWebcamPositionRequest(normal_x, normal_y);
-    });
-    return;
-  }
+void NcStreamerRemote::SetStatusMaxAge(uint32_t max_age_ms) {
+  status_mirror_->SetMaxAge(max_age_ms);
+}
 
-  SendWebcamPositionRequest(normal_x, normal_y);
+
+void NcStreamerRemote::InvalidateCachedStatus() {
+  status_mirror_->Invalidate();
 }
 
 
-void NcStreamerRemote::RequestChromaKeyOn(
-    const uint32_t &color,
-    const int &similarity,
-    const ErrorHandler &error_handler,
-    const ChromaKeyResponseHandler &chroma_key_on_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
+void NcStreamerRemote::StartCommentsPolling(const PollPolicy &policy) {
+  io_service_.post([this, policy]() {
+    comments_poll_->Start(policy);
+    timer_to_poll_comments_.cancel();
+    PollComments();
+  });
+}
 
-  current_error_handler_ = error_handler;
-  current_chroma_key_on_response_handler_ = chroma_key_on_response_handler;
 
-  if (!remote_connection_.lock()) {
-    Connect([color, similarity, this]() {
-      SendChromaKeyOnRequest(color, similarity);
-    });
-    return;
-  }
+void NcStreamerRemote::StartCommentsPolling(uint32_t interval_ms) {
+  PollPolicy policy;
+  policy.min_interval_ms = interval_ms;
+  policy.max_interval_ms = interval_ms;
+  policy.backoff = 1.0;
+  StartCommentsPolling(policy);
+}
 
-  SendChromaKeyOnRequest(color, similarity);
+
+void NcStreamerRemote::StopCommentsPolling() {
+  io_service_.post([this]() {
+    comments_poll_->Stop();
+    timer_to_poll_comments_.cancel();
+  });
 }
 
 
-void NcStreamerRemote::RequestChromaKeyOff(
-    const ErrorHandler &error_handler,
-    const ChromaKeyResponseHandler &chroma_key_off_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
-    return;
-  }
-  busy_ = true;
+PollMetrics NcStreamerRemote::GetCommentsPollMetrics() const {
+  return comments_poll_->GetMetrics();
+}
 
-  current_error_handler_ = error_handler;
-  current_chroma_key_off_response_handler_ = chroma_key_off_response_handler;
 
-  if (!remote_connection_.lock()) {
-    Connect([this]() {
-      SendChromaKeyOffRequest();
-    });
-    return;
-  }
+std::vector<Comment> NcStreamerRemote::GetLastComments(
+    std::size_t count) const {
+  return comment_store_->GetLast(count);
+}
 
-  SendChromaKeyOffRequest();
+
+std::vector<Comment> NcStreamerRemote::GetCommentsSince(
+    const std::wstring &created_time) const {
+  return comment_store_->GetSince(created_time);
+}
+
+
+std::wstring NcStreamerRemote::GetCommentsCursor() const {
+  return comment_store_->GetCursor();
+}
+
+
+ChatStats NcStreamerRemote::GetChatStats() const {
+  return chat_analytics_->GetStats();
+}
+
+
+void NcStreamerRemote::SetCommentFilter(
+    const std::vector<CommentFilterRule> &rules,
+    bool ignore_case) {
+  std::shared_ptr<const CommentFilter> filter{
+      new CommentFilter{rules, ignore_case}};
+  std::atomic_store(&comment_filter_, filter);
+}
+
+
+void NcStreamerRemote::ClearCommentFilter() {
+  std::atomic_store(
+      &comment_filter_, std::shared_ptr<const CommentFilter>{});
+}
+
+
+void NcStreamerRemote::SetCommentsPollQuery(const CommentsQuery &query) {
+  io_service_.post([this, query]() {
+    comments_poll_query_ = query;
+    // the comment store needs both, to de-duplicate and to advance.
+    comments_poll_query_.fields |=
+        CommentsQuery::kId | CommentsQuery::kCreatedTime;
+  });
+}
+
+
+void NcStreamerRemote::StartViewersSampling(const PollPolicy &policy) {
+  io_service_.post([this, policy]() {
+    viewers_poll_->Start(policy);
+    timer_to_sample_viewers_.cancel();
+    SampleViewers();
+  });
+}
+
+
+void NcStreamerRemote::StartViewersSampling(uint32_t interval_ms) {
+  PollPolicy policy;
+  policy.min_interval_ms = interval_ms;
+  policy.max_interval_ms = interval_ms;
+  policy.backoff = 1.0;
+  StartViewersSampling(policy);
+}
+
+
+void NcStreamerRemote::StopViewersSampling() {
+  io_service_.post([this]() {
+    viewers_poll_->Stop();
+    timer_to_sample_viewers_.cancel();
+  });
+}
+
+
+PollMetrics NcStreamerRemote::GetViewersPollMetrics() const {
+  return viewers_poll_->GetMetrics();
+}
+
+
+void NcStreamerRemote::SetPollRateCeiling(double requests_per_second) {
+  io_service_.post([this, requests_per_second]() {
+    poll_rate_ceiling_->Set(requests_per_second);
+  });
+}
+
+
+ViewerStats NcStreamerRemote::GetViewerStats(
+    ViewerResolution resolution) const {
+  return viewer_series_->GetStats(resolution);
+}
+
+
+std::vector<ViewerPoint> NcStreamerRemote::GetViewerPoints(
+    ViewerResolution resolution) const {
+  return viewer_series_->GetPoints(resolution);
+}
+
+
+void NcStreamerRemote::RequestStatus(
+    const ErrorHandler &error_handler,
+    const StatusResponseHandler &status_response_handler) {
+  RequestStatus(
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<StatusResponseHandler>{status_response_handler});
+}
+
+
+void NcStreamerRemote::RequestStatus(
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<StatusResponseHandler> &&status_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_status_response_handler_ = std::move(status_response_handler);
+  control_lane_->request = [this]() {
+    DoRequestStatus();
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestStatus() {
+  if (!remote_connection_.lock()) {
+    Connect(control_lane_.get(), [this]() {
+      SendStatusRequest();
+    });
+    return;
+  }
+
+  SendStatusRequest();
+}
+
+
+void NcStreamerRemote::RequestCachedStatus(
+    const ErrorHandler &error_handler,
+    const StatusResponseHandler &status_response_handler) {
+  RequestCachedStatus(
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<StatusResponseHandler>{status_response_handler});
+}
+
+
+void NcStreamerRemote::RequestCachedStatus(
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<StatusResponseHandler> &&status_response_handler) {
+  const CachedStatus &cached = GetCachedStatus();
+  if (cached.stale == true) {
+    RequestStatus(
+        std::move(error_handler), std::move(status_response_handler));
+    return;
+  }
+
+  const StatusSnapshot &snapshot = *cached.snapshot;
+  status_response_handler(
+      snapshot.status,
+      snapshot.source_title,
+      snapshot.user_name,
+      snapshot.quality);
+}
+
+
+void NcStreamerRemote::RequestStart(
+    const std::wstring &title,
+    const ErrorHandler &error_handler,
+    const StartResponseHandler &start_response_handler) {
+  RequestStart(
+      title,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<StartResponseHandler>{start_response_handler});
+}
+
+
+void NcStreamerRemote::RequestStart(
+    const std::wstring &title,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<StartResponseHandler> &&start_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_start_response_handler_ = std::move(start_response_handler);
+  control_lane_->text = title;
+  control_lane_->request = [this]() {
+    DoRequestStart(control_lane_->text);
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestStart(
+    const std::wstring &title) {
+  if (!remote_connection_.lock()) {
+    Connect(control_lane_.get(), [this, title]() {
+      SendStartRequest(title);
+    });
+    return;
+  }
+
+  SendStartRequest(title);
+}
+
+
+void NcStreamerRemote::RequestStop(
+    const std::wstring &title,
+    const ErrorHandler &error_handler,
+    const StopResponseHandler &stop_response_handler) {
+  RequestStop(
+      title,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<StopResponseHandler>{stop_response_handler});
+}
+
+
+void NcStreamerRemote::RequestStop(
+    const std::wstring &title,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<StopResponseHandler> &&stop_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_stop_response_handler_ = std::move(stop_response_handler);
+  control_lane_->text = title;
+  control_lane_->request = [this]() {
+    DoRequestStop(control_lane_->text);
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestStop(
+    const std::wstring &title) {
+  if (!remote_connection_.lock()) {
+    Connect(control_lane_.get(), [this, title]() {
+      SendStopRequest(title);
+    });
+    return;
+  }
+
+  SendStopRequest(title);
+}
+
+
+void NcStreamerRemote::RequestQualityUpdate(
+    const std::wstring &quality,
+    const ErrorHandler &error_handler,
+    const SuccessHandler &quality_update_response_handler) {
+  RequestQualityUpdate(
+      quality,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<SuccessHandler>{quality_update_response_handler});
+}
+
+
+void NcStreamerRemote::RequestQualityUpdate(
+    const std::wstring &quality,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<SuccessHandler> &&quality_update_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_quality_update_response_handler_ =
+      std::move(quality_update_response_handler);
+  control_lane_->text = quality;
+  control_lane_->request = [this]() {
+    DoRequestQualityUpdate(control_lane_->text);
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestQualityUpdate(
+    const std::wstring &quality) {
+  session_requested_->quality = quality;
+
+  if (!remote_connection_.lock()) {
+    Connect(control_lane_.get(), [this, quality]() {
+      SendQualityUpdateRequest(quality);
+    });
+    return;
+  }
+
+  SendQualityUpdateRequest(quality);
+}
+
+
+void NcStreamerRemote::RequestExit(
+    const ErrorHandler &error_handler) {
+  RequestExit(Inplace<ErrorHandler>{error_handler});
+}
+
+
+void NcStreamerRemote::RequestExit(
+    Inplace<ErrorHandler> &&error_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  control_lane_->request = [this]() {
+    DoRequestExit();
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestExit() {
+  if (!remote_connection_.lock()) {
+    Connect(control_lane_.get(), [this]() {
+      SendExitRequest();
+    });
+    return;
+  }
+
+  SendExitRequest();
+}
+
+
+void NcStreamerRemote::RequstComments(
+    const std::wstring &created_time,
+    const ErrorHandler &error_handler,
+    const CommentsResponseHandler &comments_response_handler) {
+  RequstComments(
+      created_time,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<CommentsResponseHandler>{comments_response_handler});
+}
+
+
+void NcStreamerRemote::RequstComments(
+    const std::wstring &created_time,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<CommentsResponseHandler> &&comments_response_handler) {
+  if (BeginRequest(bulk_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_comments_response_handler_ = std::move(comments_response_handler);
+  current_comment_records_response_handler_ = nullptr;
+  bulk_lane_->text = created_time;
+  bulk_lane_->request = [this]() {
+    DoRequstComments(bulk_lane_->text);
+  };
+  PostRequest(bulk_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequstComments(
+    const std::wstring &created_time) {
+  if (!remote_connection_.lock()) {
+    Connect(bulk_lane_.get(), [this, created_time]() {
+      SendCommentsRequest(created_time, CommentsQuery{});
+    });
+    return;
+  }
+
+  SendCommentsRequest(created_time, CommentsQuery{});
+}
+
+
+void NcStreamerRemote::RequestCommentRecords(
+    const std::wstring &created_time,
+    const ErrorHandler &error_handler,
+    const CommentRecordsHandler &comment_records_response_handler) {
+  RequestCommentRecords(
+      created_time,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<CommentRecordsHandler>{comment_records_response_handler});
+}
+
+
+void NcStreamerRemote::RequestCommentRecords(
+    const std::wstring &created_time,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<CommentRecordsHandler> &&comment_records_response_handler) {
+  RequestCommentRecords(
+      created_time,
+      CommentsQuery{},
+      std::move(error_handler),
+      std::move(comment_records_response_handler));
+}
+
+
+void NcStreamerRemote::RequestCommentRecords(
+    const std::wstring &created_time,
+    const CommentsQuery &query,
+    const ErrorHandler &error_handler,
+    const CommentRecordsHandler &comment_records_response_handler) {
+  RequestCommentRecords(
+      created_time,
+      query,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<CommentRecordsHandler>{comment_records_response_handler});
+}
+
+
+void NcStreamerRemote::RequestCommentRecords(
+    const std::wstring &created_time,
+    const CommentsQuery &query,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<CommentRecordsHandler> &&comment_records_response_handler) {
+  if (BeginRequest(bulk_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_comments_response_handler_ = nullptr;
+  current_comment_records_response_handler_ =
+      std::move(comment_records_response_handler);
+  bulk_lane_->text = created_time;
+  bulk_lane_->query = query;
+  bulk_lane_->request = [this]() {
+    DoRequestCommentRecords(bulk_lane_->text, bulk_lane_->query);
+  };
+  PostRequest(bulk_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestCommentRecords(
+    const std::wstring &created_time,
+    const CommentsQuery &query) {
+  if (!remote_connection_.lock()) {
+    Connect(bulk_lane_.get(), [this, created_time, query]() {
+      SendCommentsRequest(created_time, query);
+    });
+    return;
+  }
+
+  SendCommentsRequest(created_time, query);
+}
+
+
+void NcStreamerRemote::RequestCommentsSubscribe(
+    const std::wstring &created_time,
+    const ErrorHandler &error_handler,
+    const SuccessHandler &comments_subscribe_response_handler) {
+  RequestCommentsSubscribe(
+      created_time,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<SuccessHandler>{comments_subscribe_response_handler});
+}
+
+
+void NcStreamerRemote::RequestCommentsSubscribe(
+    const std::wstring &created_time,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<SuccessHandler> &&comments_subscribe_response_handler) {
+  if (BeginRequest(bulk_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_comments_subscribe_response_handler_ =
+      std::move(comments_subscribe_response_handler);
+  bulk_lane_->text = created_time;
+  bulk_lane_->request = [this]() {
+    DoRequestCommentsSubscribe(bulk_lane_->text);
+  };
+  PostRequest(bulk_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestCommentsSubscribe(
+    const std::wstring &created_time) {
+  if (!remote_connection_.lock()) {
+    Connect(bulk_lane_.get(), [this, created_time]() {
+      SendCommentsSubscribeRequest(created_time);
+    });
+    return;
+  }
+
+  SendCommentsSubscribeRequest(created_time);
+}
+
+
+void NcStreamerRemote::RequestCommentsUnsubscribe(
+    const ErrorHandler &error_handler,
+    const SuccessHandler &comments_unsubscribe_response_handler) {
+  RequestCommentsUnsubscribe(
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<SuccessHandler>{comments_unsubscribe_response_handler});
+}
+
+
+void NcStreamerRemote::RequestCommentsUnsubscribe(
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<SuccessHandler> &&comments_unsubscribe_response_handler) {
+  if (BeginRequest(bulk_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_comments_unsubscribe_response_handler_ =
+      std::move(comments_unsubscribe_response_handler);
+  bulk_lane_->request = [this]() {
+    DoRequestCommentsUnsubscribe();
+  };
+  PostRequest(bulk_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestCommentsUnsubscribe() {
+  if (!remote_connection_.lock()) {
+    Connect(bulk_lane_.get(), [this]() {
+      SendCommentsUnsubscribeRequest();
+    });
+    return;
+  }
+
+  SendCommentsUnsubscribeRequest();
+}
+
+
+void NcStreamerRemote::RequestViewers(
+    const ErrorHandler &error_handler,
+    const ViewersResponseHandler &viewers_response_handler) {
+  RequestViewers(
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<ViewersResponseHandler>{viewers_response_handler});
+}
+
+
+void NcStreamerRemote::RequestViewers(
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<ViewersResponseHandler> &&viewers_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_viewers_response_handler_ = std::move(viewers_response_handler);
+  control_lane_->request = [this]() {
+    DoRequestViewers();
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestViewers() {
+  if (!remote_connection_.lock()) {
+    Connect(control_lane_.get(), [this]() {
+      SendViewersRequest();
+    });
+    return;
+  }
+
+  SendViewersRequest();
+}
+
+
+void NcStreamerRemote::RequestWebcamSearch(
+    const ErrorHandler &error_handler,
+    const WebcamSearchResponseHandler &webcam_search_response_handler) {
+  RequestWebcamSearch(
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<WebcamSearchResponseHandler>{webcam_search_response_handler});
+}
+
+
+void NcStreamerRemote::RequestWebcamSearch(
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<WebcamSearchResponseHandler> &&webcam_search_response_handler) {
+  if (BeginRequest(bulk_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_webcam_search_response_handler_ =
+      std::move(webcam_search_response_handler);
+  bulk_lane_->request = [this]() {
+    DoRequestWebcamSearch();
+  };
+  PostRequest(bulk_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestWebcamSearch() {
+  if (!remote_connection_.lock()) {
+    Connect(bulk_lane_.get(), [this]() {
+      SendWebcamSearchRequest();
+    });
+    return;
+  }
+
+  SendWebcamSearchRequest();
+}
+
+
+void NcStreamerRemote::RequestWebcamOn(
+    const std::wstring &device_id,
+    const float &normal_width,
+    const float &normal_height,
+    const float &normal_x,
+    const float &normal_y,
+    const ErrorHandler &error_handler,
+    const WebcamResponseHandler &webcam_on_response_handler) {
+  RequestWebcamOn(
+      device_id,
+      normal_width,
+      normal_height,
+      normal_x,
+      normal_y,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<WebcamResponseHandler>{webcam_on_response_handler});
+}
+
+
+void NcStreamerRemote::RequestWebcamOn(
+    const std::wstring &device_id,
+    const float &normal_width,
+    const float &normal_height,
+    const float &normal_x,
+    const float &normal_y,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<WebcamResponseHandler> &&webcam_on_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_webcam_on_response_handler_ = std::move(webcam_on_response_handler);
+  control_lane_->text = device_id;
+  control_lane_->request = [
+      this, normal_width, normal_height, normal_x, normal_y]() {
+    DoRequestWebcamOn(
+        control_lane_->text, normal_width, normal_height, normal_x, normal_y);
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestWebcamOn(
+    const std::wstring &device_id,
+    const float &normal_width,
+    const float &normal_height,
+    const float &normal_x,
+    const float &normal_y) {
+  session_requested_->webcam.device_id = device_id;
+  session_requested_->webcam.normal_width = normal_width;
+  session_requested_->webcam.normal_height = normal_height;
+  session_requested_->webcam.normal_x = normal_x;
+  session_requested_->webcam.normal_y = normal_y;
+
+  if (!remote_connection_.lock()) {
+    Connect(control_lane_.get(), [
+        device_id, normal_width, normal_height, normal_x, normal_y, this]() {
+      SendWebcamOnRequest(
+          device_id, normal_width, normal_height, normal_x, normal_y);
+    });
+    return;
+  }
+
+  SendWebcamOnRequest(
+      device_id, normal_width, normal_height, normal_x, normal_y);
+}
+
+
+void NcStreamerRemote::RequestWebcamOff(
+    const ErrorHandler &error_handler,
+    const WebcamResponseHandler &webcam_off_response_handler) {
+  RequestWebcamOff(
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<WebcamResponseHandler>{webcam_off_response_handler});
+}
+
+
+void NcStreamerRemote::RequestWebcamOff(
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<WebcamResponseHandler> &&webcam_off_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_webcam_off_response_handler_ = std::move(webcam_off_response_handler);
+  control_lane_->request = [this]() {
+    DoRequestWebcamOff();
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestWebcamOff() {
+  if (!remote_connection_.lock()) {
+    Connect(control_lane_.get(), [this]() {
+      SendWebcamOffRequest();
+    });
+    return;
+  }
+
+  SendWebcamOffRequest();
+}
+
+
+void NcStreamerRemote::RequestWebcamSize(
+    const float &normal_width,
+    const float &normal_height,
+    const ErrorHandler &error_handler,
+    const WebcamResponseHandler &webcam_size_response_handler) {
+  RequestWebcamSize(
+      normal_width,
+      normal_height,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<WebcamResponseHandler>{webcam_size_response_handler});
+}
+
+
+void NcStreamerRemote::RequestWebcamSize(
+    const float &normal_width,
+    const float &normal_height,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<WebcamResponseHandler> &&webcam_size_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_webcam_size_response_handler_ =
+      std::move(webcam_size_response_handler);
+  control_lane_->request = [this, normal_width, normal_height]() {
+    DoRequestWebcamSize(normal_width, normal_height);
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestWebcamSize(
+    const float &normal_width,
+    const float &normal_height) {
+  session_requested_->webcam.normal_width = normal_width;
+  session_requested_->webcam.normal_height = normal_height;
+
+  if (!remote_connection_.lock()) {
+    Connect(control_lane_.get(), [normal_width, normal_height, this]() {
+      SendWebcamSizeRequest(normal_width, normal_height);
+    });
+    return;
+  }
+
+  SendWebcamSizeRequest(normal_width, normal_height);
+}
+
+
+void NcStreamerRemote::RequestWebcamPosition(
+    const float &normal_x,
+    const float &normal_y,
+    const ErrorHandler &error_handler,
+    const WebcamResponseHandler &webcam_position_response_handler) {
+  RequestWebcamPosition(
+      normal_x,
+      normal_y,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<WebcamResponseHandler>{webcam_position_response_handler});
+}
+
+
+void NcStreamerRemote::RequestWebcamPosition(
+    const float &normal_x,
+    const float &normal_y,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<WebcamResponseHandler> &&webcam_position_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_webcam_position_response_handler_ =
+      std::move(webcam_position_response_handler);
+  control_lane_->request = [this, normal_x, normal_y]() {
+    DoRequestWebcamPosition(normal_x, normal_y);
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestWebcamPosition(
+    const float &normal_x,
+    const float &normal_y) {
+  session_requested_->webcam.normal_x = normal_x;
+  session_requested_->webcam.normal_y = normal_y;
+
+  if (!remote_connection_.lock()) {
+    Connect(control_lane_.get(), [normal_x, normal_y, this]() {
+      SendWebcamPositionRequest(normal_x, normal_y);
+    });
+    return;
+  }
+
+  SendWebcamPositionRequest(normal_x, normal_y);
+}
+
+
+void NcStreamerRemote::RequestChromaKeyOn(
+    const uint32_t &color,
+    const int &similarity,
+    const ErrorHandler &error_handler,
+    const ChromaKeyResponseHandler &chroma_key_on_response_handler) {
+  RequestChromaKeyOn(
+      color,
+      similarity,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<ChromaKeyResponseHandler>{chroma_key_on_response_handler});
+}
+
+
+void NcStreamerRemote::RequestChromaKeyOn(
+    const uint32_t &color,
+    const int &similarity,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<ChromaKeyResponseHandler> &&chroma_key_on_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_chroma_key_on_response_handler_ =
+      std::move(chroma_key_on_response_handler);
+  control_lane_->request = [this, color, similarity]() {
+    DoRequestChromaKeyOn(color, similarity);
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestChromaKeyOn(
+    const uint32_t &color,
+    const int &similarity) {
+  session_requested_->chroma_key.color = color;
+  session_requested_->chroma_key.similarity = similarity;
+
+  if (!remote_connection_.lock()) {
+    Connect(control_lane_.get(), [color, similarity, this]() {
+      SendChromaKeyOnRequest(color, similarity);
+    });
+    return;
+  }
+
+  SendChromaKeyOnRequest(color, similarity);
+}
+
+
+void NcStreamerRemote::RequestChromaKeyOff(
+    const ErrorHandler &error_handler,
+    const ChromaKeyResponseHandler &chroma_key_off_response_handler) {
+  RequestChromaKeyOff(
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<ChromaKeyResponseHandler>{chroma_key_off_response_handler});
+}
+
+
+void NcStreamerRemote::RequestChromaKeyOff(
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<ChromaKeyResponseHandler> &&chroma_key_off_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
+    return;
+  }
+  current_chroma_key_off_response_handler_ =
+      std::move(chroma_key_off_response_handler);
+  control_lane_->request = [this]() {
+    DoRequestChromaKeyOff();
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestChromaKeyOff() {
+  if (!remote_connection_.lock()) {
+    Connect(control_lane_.get(), [this]() {
+      SendChromaKeyOffRequest();
+    });
+    return;
+  }
+
+  SendChromaKeyOffRequest();
 }
 
 
@@ -416,18 +1452,35 @@ void NcStreamerRemote::RequestChromaKeyColor(
     const uint32_t &color,
     const ErrorHandler &error_handler,
     const ChromaKeyResponseHandler &chroma_key_color_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
+  RequestChromaKeyColor(
+      color,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<ChromaKeyResponseHandler>{chroma_key_color_response_handler});
+}
+
+
+void NcStreamerRemote::RequestChromaKeyColor(
+    const uint32_t &color,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<ChromaKeyResponseHandler> &&chroma_key_color_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
     return;
   }
-  busy_ = true;
-
-  current_error_handler_ = error_handler;
   current_chroma_key_color_response_handler_ =
-      chroma_key_color_response_handler;
+      std::move(chroma_key_color_response_handler);
+  control_lane_->request = [this, color]() {
+    DoRequestChromaKeyColor(color);
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestChromaKeyColor(
+    const uint32_t &color) {
+  session_requested_->chroma_key.color = color;
 
   if (!remote_connection_.lock()) {
-    Connect([color, this]() {
+    Connect(control_lane_.get(), [color, this]() {
       SendChromaKeyColorRequest(color);
     });
     return;
@@ -441,18 +1494,37 @@ void NcStreamerRemote::RequestChromaKeySimilarity(
     const int &similarity,
     const ErrorHandler &error_handler,
     const ChromaKeyResponseHandler &chroma_key_similarity_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
+  RequestChromaKeySimilarity(
+      similarity,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<ChromaKeyResponseHandler>{
+          chroma_key_similarity_response_handler});
+}
+
+
+void NcStreamerRemote::RequestChromaKeySimilarity(
+    const int &similarity,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<ChromaKeyResponseHandler>
+        &&chroma_key_similarity_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
     return;
   }
-  busy_ = true;
-
-  current_error_handler_ = error_handler;
   current_chroma_key_similarity_response_handler_ =
-      chroma_key_similarity_response_handler;
+      std::move(chroma_key_similarity_response_handler);
+  control_lane_->request = [this, similarity]() {
+    DoRequestChromaKeySimilarity(similarity);
+  };
+  PostRequest(control_lane_.get());
+}
+
+
+void NcStreamerRemote::DoRequestChromaKeySimilarity(
+    const int &similarity) {
+  session_requested_->chroma_key.similarity = similarity;
 
   if (!remote_connection_.lock()) {
-    Connect([similarity, this]() {
+    Connect(control_lane_.get(), [similarity, this]() {
       SendChromaKeySimilarityRequest(similarity);
     });
     return;
@@ -465,17 +1537,29 @@ void NcStreamerRemote::RequestChromaKeySimilarity(
 void NcStreamerRemote::RequestMicSearch(
     const ErrorHandler &error_handler,
     const MicSearchResponseHandler &mic_search_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
+  RequestMicSearch(
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<MicSearchResponseHandler>{mic_search_response_handler});
+}
+
+
+void NcStreamerRemote::RequestMicSearch(
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<MicSearchResponseHandler> &&mic_search_response_handler) {
+  if (BeginRequest(bulk_lane_.get(), &error_handler) == false) {
     return;
   }
-  busy_ = true;
+  current_mic_search_response_handler_ = std::move(mic_search_response_handler);
+  bulk_lane_->request = [this]() {
+    DoRequestMicSearch();
+  };
+  PostRequest(bulk_lane_.get());
+}
 
-  current_error_handler_ = error_handler;
-  current_mic_search_response_handler_ = mic_search_response_handler;
 
+void NcStreamerRemote::DoRequestMicSearch() {
   if (!remote_connection_.lock()) {
-    Connect([this]() {
+    Connect(bulk_lane_.get(), [this]() {
       SendMicSearchRequest();
     });
     return;
@@ -488,19 +1572,41 @@ void NcStreamerRemote::RequestMicSearch(
 void NcStreamerRemote::RequestMicOn(
     const std::wstring &device_id,
     const float &volume,
-    const ErrorHandler &error_handler,
-    const MicResponseHandler &mic_on_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
+    const ErrorHandler &error_handler,
+    const MicResponseHandler &mic_on_response_handler) {
+  RequestMicOn(
+      device_id,
+      volume,
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<MicResponseHandler>{mic_on_response_handler});
+}
+
+
+void NcStreamerRemote::RequestMicOn(
+    const std::wstring &device_id,
+    const float &volume,
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<MicResponseHandler> &&mic_on_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
     return;
   }
-  busy_ = true;
+  current_mic_on_response_handler_ = std::move(mic_on_response_handler);
+  control_lane_->text = device_id;
+  control_lane_->request = [this, volume]() {
+    DoRequestMicOn(control_lane_->text, volume);
+  };
+  PostRequest(control_lane_.get());
+}
 
-  current_error_handler_ = error_handler;
-  current_mic_on_response_handler_ = mic_on_response_handler;
+
+void NcStreamerRemote::DoRequestMicOn(
+    const std::wstring &device_id,
+    const float &volume) {
+  session_requested_->mic.device_id = device_id;
+  session_requested_->mic.volume = volume;
 
   if (!remote_connection_.lock()) {
-    Connect([this, device_id, volume]() {
+    Connect(control_lane_.get(), [this, device_id, volume]() {
       SendMicOnRequest(device_id, volume);
     });
     return;
@@ -513,17 +1619,29 @@ void NcStreamerRemote::RequestMicOn(
 void NcStreamerRemote::RequestMicOff(
     const ErrorHandler &error_handler,
     const MicResponseHandler &mic_off_response_handler) {
-  if (busy_ == true) {
-    HandleConnectionError(Error::Connection::kBusy, error_handler);
+  RequestMicOff(
+      Inplace<ErrorHandler>{error_handler},
+      Inplace<MicResponseHandler>{mic_off_response_handler});
+}
+
+
+void NcStreamerRemote::RequestMicOff(
+    Inplace<ErrorHandler> &&error_handler,
+    Inplace<MicResponseHandler> &&mic_off_response_handler) {
+  if (BeginRequest(control_lane_.get(), &error_handler) == false) {
     return;
   }
-  busy_ = true;
+  current_mic_off_response_handler_ = std::move(mic_off_response_handler);
+  control_lane_->request = [this]() {
+    DoRequestMicOff();
+  };
+  PostRequest(control_lane_.get());
+}
 
-  current_error_handler_ = error_handler;
-  current_mic_off_response_handler_ = mic_off_response_handler;
 
+void NcStreamerRemote::DoRequestMicOff() {
   if (!remote_connection_.lock()) {
-    Connect([this]() {
+    Connect(control_lane_.get(), [this]() {
       SendMicOffRequest();
     });
     return;
@@ -533,26 +1651,104 @@ void NcStreamerRemote::RequestMicOff(
 }
 
 
-NcStreamerRemote::NcStreamerRemote(uint16_t remote_port)
-    : remote_uri_{new websocketpp::uri{false, "::1", remote_port, ""}},
-      io_service_{},
-      io_service_work_{io_service_},
+NcStreamerRemote::NcStreamerRemote(
+    uint16_t remote_port,
+    MemoryResource *memory_resource,
+    RemoteExecutor *executor,
+    const std::string &log_path,
+    bool offline)
+    : owned_executor_{executor ? nullptr : new RemoteExecutor{}},
+      executor_{executor ? executor : owned_executor_.get()},
+      io_service_(executor_->io_service()),
       remote_{},
-      remote_threads_{},
       remote_log_{},
+      frame_log_sampling_{kDefaultFrameLogSampling},
+      frames_{0},
+      wire_recorder_{},
+      shutting_down_{false},
+      offline_{offline},
+      connections_mutex_{},
+      connections_{},
+      connections_released_{},
+      memory_resource_{memory_resource},
+      inbound_arena_{memory_resource},
+      message_pool_{
+          new MessagePool<AsioClient::message_type>{memory_resource}},
+      outbound_mutex_{},
+      outbound_payload_{memory_resource},
+      remote_port_{remote_port},
+      remote_uris_{NewLoopbackUris(remote_port)},
+      preferred_uri_{0},
+      connect_latency_{new LatencyHistogram{}},
+      launch_to_response_{new LatencyHistogram{}},
+      appeared_us_{0},
       remote_connection_{},
       timer_to_keep_connected_{io_service_},
-      busy_{},
+      reconnect_backoff_{new ReconnectBackoff{
+          kDefaultReconnectPolicy,
+          static_cast<uint32_t>(GetSteadyMilliseconds())}},
+      server_watcher_{},
+      port_discovery_{new PortDiscoveryPolicy{}},
+      port_discovery_due_{false},
+      port_cache_writer_{new PortCacheWriter{}},
+      bulk_enabled_{false},
+      bulk_mutex_{},
+      bulk_connection_{},
+      bulk_opening_{false},
+      bulk_open_posted_{false},
+      bulk_failed_{false},
+      connection_state_{ConnectionState::kDisconnected},
+      connection_state_ms_{GetSteadyMilliseconds()},
+      ever_connected_{false},
+      reconnects_{0},
+      heartbeat_policy_{new HeartbeatPolicy(kDefaultHeartbeatPolicy)},
+      heartbeat_{new Heartbeat{}},
+      timer_to_ping_{io_service_},
+      on_air_state_{OnAirState::kUnknown},
+      poll_rate_ceiling_{new PollRateCeiling{}},
+      comment_store_{new CommentStore{kCommentStoreCapacity}},
+      comment_filter_{},
+      chat_analytics_{new ChatAnalytics{}},
+      timer_to_poll_comments_{io_service_},
+      comments_poll_{new PollSchedule{}},
+      comments_poll_query_{},
+      viewer_series_{new ViewerSeries{}},
+      timer_to_sample_viewers_{io_service_},
+      viewers_poll_{new PollSchedule{}},
+      last_sampled_viewers_{},
+      session_state_{new SessionState{}},
+      session_requested_{new SessionSnapshot{}},
+      session_replay_due_{false},
+      session_replay_sending_{false},
+      session_replay_pending_{},
+      session_replay_failed_{0},
+      reconnected_ms_{0},
+      session_replays_{0},
+      session_replay_requests_{0},
+      session_replay_failures_{0},
+      session_restore_ms_{0},
+      status_mirror_{new StatusMirror{kDefaultStatusMaxAge}},
+      control_lane_{new RequestLane{memory_resource}},
+      bulk_lane_{new RequestLane{memory_resource}},
+      responding_lane_{nullptr},
+      comments_polled_cursor_{},
+      request_metrics_{new RequestMetrics{kRequestTypes}},
+      request_id_{0},
+      tracer_{new TraceRecorder{kTraceCapacity}},
       connect_handler_{},
       disconnect_handler_{},
       start_event_handler_{},
       stop_event_handler_{},
-      current_error_handler_{},
+      comments_event_handler_{},
+      comment_records_event_handler_{},
       current_status_response_handler_{},
       current_start_response_handler_{},
       current_stop_response_handler_{},
       current_quality_update_response_handler_{},
       current_comments_response_handler_{},
+      current_comment_records_response_handler_{},
+      current_comments_subscribe_response_handler_{},
+      current_comments_unsubscribe_response_handler_{},
       current_viewers_response_handler_{},
       current_webcam_search_response_handler_{},
       current_webcam_on_response_handler_{},
@@ -566,18 +1762,24 @@ NcStreamerRemote::NcStreamerRemote(uint16_t remote_port)
       current_mic_search_response_handler_{},
       current_mic_on_response_handler_{},
       current_mic_off_response_handler_{} {
-  busy_ = false;
-
-  remote_log_.open("ncstreamer_remote.log");
-  remote_.set_access_channels(websocketpp::log::alevel::all);
-  remote_.set_access_channels(websocketpp::log::elevel::all);
-  remote_.get_alog().set_ostream(&remote_log_);
-  remote_.get_elog().set_ostream(&remote_log_);
+  poll_rate_ceiling_->Set(kDefaultPollRateCeiling);
+
+  if (log_path.empty() == false) {
+    remote_log_.reset(new AsyncLog{log_path, kDefaultLogPolicy});
+    remote_.set_access_channels(kDefaultAccessChannels);
+    remote_.set_error_channels(websocketpp::log::elevel::all);
+    remote_.get_alog().set_ostream(remote_log_->access_stream());
+    remote_.get_elog().set_ostream(remote_log_->error_stream());
+  } else {
+    remote_.clear_access_channels(websocketpp::log::alevel::all);
+    remote_.clear_error_channels(websocketpp::log::elevel::all);
+  }
 
   websocketpp::lib::error_code ec;
   remote_.init_asio(&io_service_, ec);
   if (ec) {
-    HandleError(Error::Connection::kRemoteInitAsio, ec);
+    HandleError(
+        Error::Connection::kRemoteInitAsio, ec, Inplace<ErrorHandler>{});
     assert(false);
     return;
   }
@@ -586,28 +1788,93 @@ NcStreamerRemote::NcStreamerRemote(uint16_t remote_port)
       &NcStreamerRemote::OnRemoteFail, this, placeholders::_1));
   remote_.set_close_handler(websocketpp::lib::bind(
       &NcStreamerRemote::OnRemoteClose, this, placeholders::_1));
+  remote_.set_pong_handler(websocketpp::lib::bind(
+      &NcStreamerRemote::OnRemotePong, this,
+          placeholders::_1, placeholders::_2));
+  remote_.set_pong_timeout_handler(websocketpp::lib::bind(
+      &NcStreamerRemote::OnRemotePongTimeout, this,
+          placeholders::_1, placeholders::_2));
   remote_.set_message_handler(websocketpp::lib::bind(
       &NcStreamerRemote::OnRemoteMessage, this,
           placeholders::_1, placeholders::_2));
 
-  static const std::size_t kRemoteThreadsSize{1};  // just one enough.
-  for (std::size_t i = 0; i < kRemoteThreadsSize; ++i) {
-    remote_threads_.emplace_back([this]() {
-      remote_.run();
-    });
+  if (offline == true) {
+    return;
   }
 
-  KeepConnected();
+  server_watcher_.reset(new ServerWatcher{
+      ncstreamer::kNcStreamerWindowTitle, [this]() {
+    io_service_.post([this]() {
+      OnNcStreamerAppeared();
+    });
+  }});
+
+  io_service_.post([this]() {
+    KeepConnected();
+  });
 }
 
 
 NcStreamerRemote::~NcStreamerRemote() {
-  remote_.stop();
-  for (auto &t : remote_threads_) {
-    if (t.joinable() == true) {
-      t.join();
+  assert(executor_->RunsInThisThread() == false);
+  server_watcher_.reset();
+
+  io_service_.post([this]() {
+    shutting_down_ = true;
+    timer_to_keep_connected_.cancel();
+    timer_to_poll_comments_.cancel();
+    timer_to_sample_viewers_.cancel();
+    timer_to_ping_.cancel();
+    if (remote_connection_.lock()) {
+      websocketpp::lib::error_code ec;
+      remote_.close(
+          remote_connection_, websocketpp::close::status::going_away, "", ec);
+    }
+    CloseBulkConnection();
+  });
+
+  // the executor may run on for other clients,
+  // so wait until websocketpp lets go of every connection of this,
+  // as a connection calls back into this and logs to `remote_`.
+  {
+    std::unique_lock<std::mutex> lock{connections_mutex_};
+    while (ForgetReleasedConnections() == false) {
+      // notified as each connection ends, and checked again now and then
+      // for one let go of only after the notification.
+      connections_released_.wait_for(lock, std::chrono::milliseconds{100});
     }
   }
+
+  // and until the handlers queued so far, like of the timers, are done.
+  std::promise<void> drained;
+  io_service_.post([&drained]() {
+    drained.set_value();
+  });
+  drained.get_future().wait();
+}
+
+
+bool NcStreamerRemote::ForgetReleasedConnections() {
+  connections_.erase(std::remove_if(
+      connections_.begin(), connections_.end(),
+      [](const websocketpp::connection_hdl &connection) {
+    return connection.expired();
+  }), connections_.end());
+  return connections_.empty();
+}
+
+
+void NcStreamerRemote::OnConnectionEnded() {
+  if (shutting_down_ == false) {
+    return;
+  }
+  // websocketpp lets go of the connection after its handler returns.
+  io_service_.post([this]() {
+    std::lock_guard<std::mutex> lock{connections_mutex_};
+    if (ForgetReleasedConnections() == true) {
+      connections_released_.notify_all();
+    }
+  });
 }
 
 
@@ -618,221 +1885,837 @@ bool NcStreamerRemote::ExistsNcStreamer() {
 
 
 void NcStreamerRemote::KeepConnected() {
+  if (shutting_down_ == true || remote_connection_.lock()) {
+    return;
+  }
+
+  if (port_discovery_due_ == true) {
+    DiscoverPort();
+    return;
+  }
+
+  Connect(0, [this](
+      ErrorCategory err_category,
+      int err_code,
+      const std::wstring &err_msg) {
+    // a connection failing is a disconnect, which schedules it.
+    if (err_code == static_cast<int>(Error::Connection::kOnRemoteFail)) {
+      return;
+    }
+    ScheduleReconnect();
+  }, [this]() {
+    reconnect_backoff_->Reset();
+    if (connect_handler_) {
+      connect_handler_();
+    }
+  });
+}
+
+
+void NcStreamerRemote::ScheduleReconnect() {
+  if (shutting_down_ == true) {
+    return;
+  }
+
+  timer_to_keep_connected_.expires_from_now(
+      Chrono::milliseconds{reconnect_backoff_->NextDelayMs()});
+  timer_to_keep_connected_.async_wait([this](
+      const boost::system::error_code &ec) {
+    if (ec) {
+      return;
+    }
+    KeepConnected();
+  });
+}
+
+
+void NcStreamerRemote::OnNcStreamerAppeared() {
   if (remote_connection_.lock()) {
     return;
   }
+  appeared_us_ = GetSteadyMicroseconds();
+
+  // its server may not listen yet, so retry from the initial delay.
+  reconnect_backoff_->Reset();
+  timer_to_keep_connected_.cancel();
+  KeepConnected();
+}
+
+
+void NcStreamerRemote::KeepHeartbeat() {
+  if (shutting_down_ == true ||
+      heartbeat_policy_->interval_ms == 0 ||
+      !remote_connection_.lock()) {
+    return;
+  }
+
+  // a ping in flight is left to its pong or its pong timeout.
+  if (heartbeat_->ShouldPing() == true) {
+    websocketpp::lib::error_code ec;
+    remote_.ping(
+        remote_connection_, heartbeat_->OnPing(GetSteadyMicroseconds()), ec);
+    if (ec) {
+      LogWarning("ping failed: " + ec.message());
+    }
+  }
+
+  timer_to_ping_.expires_from_now(
+      Chrono::milliseconds{heartbeat_policy_->interval_ms});
+  timer_to_ping_.async_wait([this](
+      const boost::system::error_code &ec) {
+    if (ec) {
+      return;
+    }
+    KeepHeartbeat();
+  });
+}
+
+
+void NcStreamerRemote::SetConnectionState(
+    ConnectionState connection_state) {
+  if (connection_state == connection_state_) {
+    return;
+  }
+  connection_state_ = connection_state;
+  connection_state_ms_ = GetSteadyMilliseconds();
+}
+
+
+void NcStreamerRemote::ReplaySessionIfDue() {
+  if (session_replay_due_ == false ||
+      !remote_connection_.lock() ||
+      control_lane_->busy.exchange(true) == true) {
+    return;
+  }
+  session_replay_due_ = false;
+  session_replay_pending_.clear();
+  session_replay_failed_ = 0;
+
+  // sent back to back, not waiting for each response.
+  session_replay_sending_ = true;
+  const SessionSnapshot &state = session_state_->Get();
+  uint32_t requests{0};
+  if (state.has_quality == true) {
+    SendQualityUpdateRequest(state.quality);
+    ++requests;
+  }
+  if (state.has_webcam == true) {
+    if (state.webcam.on == true) {
+      SendWebcamOnRequest(
+          state.webcam.device_id,
+          state.webcam.normal_width,
+          state.webcam.normal_height,
+          state.webcam.normal_x,
+          state.webcam.normal_y);
+    } else {
+      SendWebcamOffRequest();
+    }
+    ++requests;
+  }
+  if (state.has_chroma_key == true) {
+    if (state.chroma_key.on == true) {
+      SendChromaKeyOnRequest(
+          state.chroma_key.color, state.chroma_key.similarity);
+    } else {
+      SendChromaKeyOffRequest();
+    }
+    ++requests;
+  }
+  if (state.has_mic == true) {
+    if (state.mic.on == true) {
+      SendMicOnRequest(state.mic.device_id, state.mic.volume);
+    } else {
+      SendMicOffRequest();
+    }
+    ++requests;
+  }
+  session_replay_sending_ = false;
+
+  if (requests == 0) {
+    control_lane_->busy = false;
+    return;
+  }
+  session_replay_requests_ = requests;
+  if (session_replay_pending_.empty() == true) {
+    FinishSessionReplay();  // none sent.
+  }
+}
+
+
+void NcStreamerRemote::OnSessionReplaySent(int request_type, bool sent) {
+  if (sent == false) {
+    ++session_replay_failed_;
+    return;
+  }
+  // every response is of the type next to its request.
+  session_replay_pending_.emplace_back(request_type + 1);
+}
+
+
+void NcStreamerRemote::OnSessionReplayResponse(const InboundTree &response) {
+  InboundString error{};
+  try {
+    error = response.get<InboundString>("error");
+  } catch (const std::exception &/*e*/) {
+    error = "session replay response broken";
+  }
+  if (error.empty() == false) {
+    ++session_replay_failed_;
+    LogWarning(std::string{"session replay: "} + error.c_str());
+  }
+
+  if (session_replay_pending_.empty() == false) {
+    return;
+  }
+  FinishSessionReplay();
+}
+
+
+void NcStreamerRemote::FinishSessionReplay() {
+  ++session_replays_;
+  session_replay_failures_ = session_replay_failed_;
+  if (session_replay_failed_ == 0) {
+    const SessionSnapshot &state = session_state_->Get();
+    if (state.has_quality == true) {
+      status_mirror_->OnQuality(state.quality);
+    }
+    if (state.has_webcam == true) {
+      status_mirror_->OnWebcam(state.webcam);
+    }
+    if (state.has_chroma_key == true) {
+      status_mirror_->OnChromaKey(state.chroma_key);
+    }
+    if (state.has_mic == true) {
+      status_mirror_->OnMic(state.mic);
+    }
+  }
+  session_restore_ms_ = static_cast<uint32_t>(
+      GetSteadyMilliseconds() - reconnected_ms_);
+  control_lane_->busy = false;
+}
+
+
+void NcStreamerRemote::PollComments() {
+  if (shutting_down_ == true || comments_poll_->running() == false) {
+    return;
+  }
+
+  // the chat windows slide on even while no comments arrive.
+  chat_analytics_->Advance(GetSteadyMilliseconds());
+
+  comments_poll_->SetPaused(on_air_state_ == OnAirState::kOffAir);
+  if (on_air_state_ != OnAirState::kOffAir && remote_connection_.lock()) {
+    if (BeginPoll(bulk_lane_.get(), comments_poll_.get()) == true) {
+      comments_polled_cursor_ = comment_store_->GetCursor();
+      SendCommentsRequest(comments_polled_cursor_, comments_poll_query_);
+    }
+  }
+
+  timer_to_poll_comments_.expires_from_now(
+      Chrono::milliseconds{comments_poll_->interval_ms()});
+  timer_to_poll_comments_.async_wait([this](
+      const boost::system::error_code &ec) {
+    if (ec) {
+      return;
+    }
+    PollComments();
+  });
+}
+
+
+bool NcStreamerRemote::BeginPoll(RequestLane *lane, PollSchedule *poll) {
+  // never ahead of a request of the caller, which may wait for the poll.
+  if (lane->busy == true ||
+      lane->in_flight == true ||
+      poll_rate_ceiling_->TryAcquire(GetSteadyMilliseconds()) == false) {
+    poll->OnSkip();
+    return false;
+  }
+  poll->OnPoll();
+  lane->in_flight = true;
+  lane->polled = poll;
+  lane->poll_changed = false;
+  lane->type = 0;
+  return true;
+}
+
+
+void NcStreamerRemote::StoreComments(const CommentRecords &comments) {
+  const uint64_t now_ms = GetSteadyMilliseconds();
+  comment_store_->Add(comments, [this, now_ms](const CommentRecord &comment) {
+    chat_analytics_->Add(now_ms, comment);
+  });
+}
+
+
+void NcStreamerRemote::SampleViewers() {
+  if (shutting_down_ == true || viewers_poll_->running() == false) {
+    return;
+  }
+
+  viewers_poll_->SetPaused(on_air_state_ == OnAirState::kOffAir);
+  if (on_air_state_ != OnAirState::kOffAir && remote_connection_.lock()) {
+    if (BeginPoll(control_lane_.get(), viewers_poll_.get()) == true) {
+      SendViewersRequest();
+    }
+  }
+
+  timer_to_sample_viewers_.expires_from_now(
+      Chrono::milliseconds{viewers_poll_->interval_ms()});
+  timer_to_sample_viewers_.async_wait([this](
+      const boost::system::error_code &ec) {
+    if (ec) {
+      return;
+    }
+    SampleViewers();
+  });
+}
+
+
+void NcStreamerRemote::SetOnAirState(OnAirState on_air_state) {
+  if (on_air_state == on_air_state_) {
+    return;
+  }
+  on_air_state_ = on_air_state;
+
+  // going on air is when comments and viewers start to move.
+  if (on_air_state_ == OnAirState::kOnAir) {
+    chat_analytics_->Reset();
+    comments_poll_->OnResponse(true);
+    viewers_poll_->OnResponse(true);
+  }
+}
 
-  Connect([this](
+
+void NcStreamerRemote::Connect(
+    RequestLane *lane,
+    const OpenHandler &open_handler) {
+  // the lane keeps the error handler until the response.
+  Connect(lane->id, [this, lane](
       ErrorCategory err_category,
       int err_code,
       const std::wstring &err_msg) {
-    timer_to_keep_connected_.expires_from_now(Chrono::seconds{1});
-    timer_to_keep_connected_.async_wait([this](
-        const boost::system::error_code &ec) {
-      if (ec) {
-        return;
+    FailRequest(lane, err_category, err_code, err_msg);
+  }, open_handler);
+}
+
+
+void NcStreamerRemote::Connect(
+    uint64_t request_id,
+    Inplace<ErrorHandler> &&error_handler,
+    const OpenHandler &open_handler) {
+  if (ExistsNcStreamer() == false) {
+    HandleError(Error::Connection::kNoNcStreamer, error_handler);
+    return;
+  }
+
+  std::shared_ptr<ConnectRace> race{new ConnectRace{io_service_}};
+  race->started_us = GetSteadyMicroseconds();
+  race->first_uri = preferred_uri_;
+  race->request_id = request_id;
+  race->error_handler = std::move(error_handler);
+  race->open_handler = open_handler;
+
+  SetConnectionState(ConnectionState::kConnecting);
+  if (ConnectTo(race->first_uri, race, race->error_handler) == false) {
+    SetConnectionState(ConnectionState::kDisconnected);
+    return;
+  }
+
+  race->fallback_timer.expires_from_now(
+      Chrono::milliseconds{kConnectFallbackDelay});
+  race->fallback_timer.async_wait([this, race](
+      const boost::system::error_code &ec) {
+    if (ec ||
+        shutting_down_ == true ||
+        race->opened == true ||
+        race->fallback_started == true) {
+      return;
+    }
+    StartConnectFallback(race);
+  });
+}
+
+
+bool NcStreamerRemote::ConnectTo(
+    std::size_t uri_index,
+    const std::shared_ptr<ConnectRace> &race,
+    const Inplace<ErrorHandler> &error_handler) {
+  websocketpp::lib::error_code ec;
+  ScopedMessagePool pool_scope{message_pool_};
+  const auto &uris = std::atomic_load(&remote_uris_);
+  auto connection = remote_.get_connection((*uris)[uri_index], ec);
+  if (ec) {
+    HandleError(Error::Connection::kRemoteConnect, ec, error_handler);
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{connections_mutex_};
+    connections_.emplace_back(connection->get_handle());
+  }
+
+  connection->set_open_handler([this, uri_index, race](
+      websocketpp::connection_hdl connection) {
+    OnConnectOpen(uri_index, race, connection);
+  });
+  connection->set_fail_handler([this, race](
+      websocketpp::connection_hdl connection) {
+    OnConnectionEnded();
+    OnConnectFail(race, connection);
+  });
+  // the loser of a race is closed unnoticed.
+  connection->set_close_handler([this](
+      websocketpp::connection_hdl connection) {
+    OnConnectionEnded();
+    if (IsRemoteConnection(connection) == true) {
+      OnRemoteClose(connection);
+    }
+  });
+
+  ++race->pending;
+  remote_.connect(connection);
+  return true;
+}
+
+
+void NcStreamerRemote::StartConnectFallback(
+    const std::shared_ptr<ConnectRace> &race) {
+  race->fallback_started = true;
+  race->fallback_timer.cancel();
+
+  const std::size_t other_uri =
+      (race->first_uri + 1) % std::atomic_load(&remote_uris_)->size();
+  if (ConnectTo(other_uri, race, race->error_handler) == false &&
+      race->pending == 0) {
+    // reported to the handler of Connect(), as the first attempt failing.
+    SetConnectionState(ConnectionState::kDisconnected);
+  }
+}
+
+
+void NcStreamerRemote::OnConnectOpen(
+    std::size_t uri_index,
+    const std::shared_ptr<ConnectRace> &race,
+    websocketpp::connection_hdl connection) {
+  --race->pending;
+  if (shutting_down_ == true || race->opened == true) {
+    race->fallback_timer.cancel();
+    websocketpp::lib::error_code ec;
+    remote_.close(
+        connection, websocketpp::close::status::going_away, "", ec);
+    return;
+  }
+  race->opened = true;
+  race->fallback_timer.cancel();
+  preferred_uri_ = uri_index;
+  const uint64_t opened_us = GetSteadyMicroseconds();
+  connect_latency_->Record(opened_us - race->started_us);
+  tracer_->Record(
+      TracePhase::kConnect, 0, race->request_id,
+      race->started_us, opened_us);
+  remote_connection_ = connection;
+
+  websocketpp::lib::error_code ec;
+  auto opened = remote_.get_con_from_hdl(connection, ec);
+  if (!ec) {
+    opened->set_pong_timeout(heartbeat_policy_->pong_timeout_ms);
+  }
+  heartbeat_->Reset();
+  if (ever_connected_ == true) {
+    ++reconnects_;
+  }
+  ever_connected_ = true;
+  SetConnectionState(ConnectionState::kConnected);
+  timer_to_ping_.cancel();
+  KeepHeartbeat();
+  bulk_failed_ = false;
+  OpenBulkConnection();
+
+  if (session_replay_due_ == true) {
+    reconnected_ms_ = GetSteadyMilliseconds();
+  }
+  race->open_handler();
+  ReplaySessionIfDue();
+}
+
+
+void NcStreamerRemote::OnConnectFail(
+    const std::shared_ptr<ConnectRace> &race,
+    websocketpp::connection_hdl connection) {
+  --race->pending;
+  if (race->opened == true) {
+    return;
+  }
+  if (race->fallback_started == false && shutting_down_ == false) {
+    StartConnectFallback(race);
+    return;
+  }
+  race->fallback_timer.cancel();
+  if (race->pending == 0) {
+    // NCStreamer is up, as Connect() has checked, but not on this port.
+    port_discovery_due_ = port_discovery_->ports.empty() == false;
+    HandleError(Error::Connection::kOnRemoteFail, race->error_handler);
+    OnRemoteFail(connection);
+  }
+}
+
+
+bool NcStreamerRemote::IsRemoteConnection(
+    websocketpp::connection_hdl connection) const {
+  const auto &current = remote_connection_.lock();
+  return current && current == connection.lock();
+}
+
+
+void NcStreamerRemote::OpenBulkConnection() {
+  if (shutting_down_ == true ||
+      bulk_enabled_ == false ||
+      bulk_opening_ == true ||
+      bulk_failed_ == true ||
+      !remote_connection_.lock()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock{bulk_mutex_};
+    if (bulk_connection_.lock()) {
+      return;
+    }
+  }
+
+  websocketpp::lib::error_code ec;
+  ScopedMessagePool pool_scope{message_pool_};
+  const auto &uris = std::atomic_load(&remote_uris_);
+  auto connection = remote_.get_connection((*uris)[preferred_uri_], ec);
+  if (ec) {
+    LogWarning(ec.message());
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{connections_mutex_};
+    connections_.emplace_back(connection->get_handle());
+  }
+
+  connection->set_open_handler([this](
+      websocketpp::connection_hdl connection) {
+    bulk_opening_ = false;
+    if (shutting_down_ == true ||
+        bulk_enabled_ == false ||
+        !remote_connection_.lock()) {
+      websocketpp::lib::error_code ec;
+      remote_.close(
+          connection, websocketpp::close::status::going_away, "", ec);
+      return;
+    }
+    std::lock_guard<std::mutex> lock{bulk_mutex_};
+    bulk_connection_ = connection;
+  });
+  connection->set_fail_handler([this](
+      websocketpp::connection_hdl /*connection*/) {
+    OnConnectionEnded();
+    bulk_opening_ = false;
+    bulk_failed_ = true;
+    LogWarning("bulk connection failed");
+  });
+  // the first connection alone tells a disconnect.
+  connection->set_close_handler([this](
+      websocketpp::connection_hdl connection) {
+    OnConnectionEnded();
+    {
+      std::lock_guard<std::mutex> lock{bulk_mutex_};
+      if (bulk_connection_.lock() == connection.lock()) {
+        bulk_connection_.reset();
       }
-      KeepConnected();
-    });
-  }, [this]() {
-    if (connect_handler_) {
-      connect_handler_();
+    }
+    // or else the bulk request sent on it waits forever.
+    if (bulk_lane_->in_flight == true &&
+        bulk_lane_->sent_connection.lock() == connection.lock()) {
+      HandleError(bulk_lane_.get(), Error::Connection::kOnRemoteClose);
     }
   });
+
+  bulk_opening_ = true;
+  remote_.connect(connection);
 }
 
 
-void NcStreamerRemote::Connect(
-    const OpenHandler &open_handler) {
-  Connect(current_error_handler_, open_handler);
+void NcStreamerRemote::CloseBulkConnection() {
+  websocketpp::connection_hdl connection;
+  {
+    std::lock_guard<std::mutex> lock{bulk_mutex_};
+    connection.swap(bulk_connection_);
+  }
+  if (connection.lock()) {
+    websocketpp::lib::error_code ec;
+    remote_.close(
+        connection, websocketpp::close::status::going_away, "", ec);
+  }
 }
 
 
-void NcStreamerRemote::Connect(
-    const ErrorHandler &error_handler,
-    const OpenHandler &open_handler) {
-  if (ExistsNcStreamer() == false) {
-    HandleError(Error::Connection::kNoNcStreamer, error_handler);
+void NcStreamerRemote::SetRemotePort(uint16_t remote_port) {
+  remote_port_ = remote_port;
+  std::atomic_store(&remote_uris_, NewLoopbackUris(remote_port));
+}
+
+
+void NcStreamerRemote::DiscoverPort() {
+  port_discovery_due_ = false;
+
+  std::shared_ptr<PortProbe> probe{new PortProbe{io_service_}};
+  const std::string &host =
+      (*std::atomic_load(&remote_uris_))[preferred_uri_]->get_host();
+  for (uint16_t port : port_discovery_->ports) {
+    if (port != remote_port_) {
+      ProbePort(host, port, probe);
+    }
+  }
+  if (probe->pending == 0) {
+    ScheduleReconnect();
     return;
   }
 
+  // a probe connected but not answering is given up as well.
+  probe->timeout_timer.expires_from_now(
+      Chrono::milliseconds{port_discovery_->probe_timeout_ms});
+  probe->timeout_timer.async_wait([this, probe](
+      const boost::system::error_code &ec) {
+    if (ec) {
+      return;
+    }
+    for (const auto &connection : probe->connections) {
+      websocketpp::lib::error_code close_ec;
+      remote_.close(
+          connection, websocketpp::close::status::going_away, "", close_ec);
+    }
+  });
+}
+
+
+void NcStreamerRemote::ProbePort(
+    const std::string &host,
+    uint16_t port,
+    const std::shared_ptr<PortProbe> &probe) {
   websocketpp::lib::error_code ec;
-  auto connection = remote_.get_connection(remote_uri_, ec);
+  ScopedMessagePool pool_scope{message_pool_};
+  auto connection = remote_.get_connection(
+      websocketpp::uri_ptr{new websocketpp::uri{false, host, port, ""}}, ec);
   if (ec) {
-    HandleError(Error::Connection::kRemoteConnect, ec, error_handler);
     return;
   }
 
-  remote_.connect(connection);
-  connection->set_open_handler([this, open_handler](
+  {
+    std::lock_guard<std::mutex> lock{connections_mutex_};
+    connections_.emplace_back(connection->get_handle());
+  }
+  probe->connections.emplace_back(connection->get_handle());
+
+  connection->set_open_handshake_timeout(port_discovery_->probe_timeout_ms);
+  connection->set_open_handler([this](
       websocketpp::connection_hdl connection) {
-    remote_connection_ = connection;
-    open_handler();
+    boost::property_tree::ptree tree;
+    tree.put("type", static_cast<int>(
+        RemoteMessageType::kStreamingStatusRequest));
+    std::ostringstream msg;
+    boost::property_tree::write_json(msg, tree, false);
+
+    websocketpp::lib::error_code ec;
+    remote_.send(
+        connection, msg.str(), websocketpp::frame::opcode::text, ec);
+  });
+  connection->set_message_handler([this, port, probe](
+      websocketpp::connection_hdl connection,
+      websocketpp::connection<AsioClient>::message_ptr msg) {
+    if (probe->found_port == 0 && IsStatusResponse(msg->get_payload())) {
+      probe->found_port = port;
+    }
+    websocketpp::lib::error_code ec;
+    remote_.close(connection, websocketpp::close::status::normal, "", ec);
+  });
+  connection->set_fail_handler([this, probe](
+      websocketpp::connection_hdl /*connection*/) {
+    OnConnectionEnded();
+    OnPortProbeDone(probe);
   });
+  connection->set_close_handler([this, probe](
+      websocketpp::connection_hdl /*connection*/) {
+    OnConnectionEnded();
+    OnPortProbeDone(probe);
+  });
+
+  ++probe->pending;
+  remote_.connect(connection);
 }
 
 
-void NcStreamerRemote::SendStatusRequest() {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::kStreamingStatusRequest));
-    boost::property_tree::write_json(msg, tree, false);
+void NcStreamerRemote::OnPortProbeDone(
+    const std::shared_ptr<PortProbe> &probe) {
+  if (--probe->pending != 0) {
+    return;
   }
+  probe->timeout_timer.cancel();
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
+  if (probe->found_port == 0) {
+    ScheduleReconnect();
+    return;
+  }
+
+  remote_.get_alog().write(
+      websocketpp::log::alevel::app,
+      "ncstreamer found on port: " + std::to_string(probe->found_port));
+  SetRemotePort(probe->found_port);
+  SavePortCache(probe->found_port);
+  reconnect_backoff_->Reset();
+  KeepConnected();
+}
+
+
+void NcStreamerRemote::SavePortCache(uint16_t port) {
+  if (port_discovery_->cache_path.empty() == true) {
     return;
   }
+
+  port_cache_writer_->Save(port_discovery_->cache_path, port);
+}
+
+
+void NcStreamerRemote::SendStatusRequest() {
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::kStreamingStatusRequest));
+
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendStartRequest(const std::wstring &title) {
-  std::stringstream msg;
-  {
-    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
 
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::kStreamingStartRequest));
-    tree.put("title", converter.to_bytes(title));
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::kStreamingStartRequest));
+  tree.put("title", converter.to_bytes(title));
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendStopRequest(const std::wstring &title) {
-  std::stringstream msg;
-  {
-    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
 
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::kStreamingStopRequest));
-    tree.put("title", converter.to_bytes(title));
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::kStreamingStopRequest));
+  tree.put("title", converter.to_bytes(title));
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendQualityUpdateRequest(const std::wstring &quality) {
-  std::stringstream msg;
-  {
-    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
 
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::kSettingsQualityUpdateRequest));
-    tree.put("quality", converter.to_bytes(quality));
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::kSettingsQualityUpdateRequest));
+  tree.put("quality", converter.to_bytes(quality));
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendExitRequest() {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::kNcStreamerExitRequest));
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::kNcStreamerExitRequest));
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
-void NcStreamerRemote::SendCommentsRequest(const std::wstring &created_time) {
-  std::stringstream msg;
-  {
-    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+void NcStreamerRemote::SendCommentsRequest(
+    const std::wstring &created_time,
+    const CommentsQuery &query) {
+  static const std::pair<CommentsQuery::Field, const char *> kFieldNames[] = {
+      {CommentsQuery::kId, "id"},
+      {CommentsQuery::kAuthor, "from"},
+      {CommentsQuery::kText, "message"},
+      {CommentsQuery::kCreatedTime, "created_time"}};
 
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::kStreamingCommentsRequest));
-    tree.put("createdTime", converter.to_bytes(created_time));
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::kStreamingCommentsRequest));
+  tree.put("createdTime", converter.to_bytes(created_time));
+
+  // only what narrows the query is sent, as NCStreamer defaults to all.
+  if (query.max_count != 0) {
+    tree.put("maxCount", query.max_count);
+  }
+  if ((query.fields & CommentsQuery::kAllFields) !=
+      CommentsQuery::kAllFields) {
+    std::string fields{};
+    for (const auto &field_name : kFieldNames) {
+      if ((query.fields & field_name.first) == 0) {
+        continue;
+      }
+      if (fields.empty() == false) {
+        fields += ',';
+      }
+      fields += field_name.second;
+    }
+    tree.put("fields", fields);
+  }
+  if (query.author.empty() == false) {
+    tree.put("author", converter.to_bytes(query.author));
+  }
+  if (query.keyword.empty() == false) {
+    tree.put("keyword", converter.to_bytes(query.keyword));
   }
+
+  Send(tree);
+}
+
+
+void NcStreamerRemote::SendCommentsSubscribeRequest(
+    const std::wstring &created_time) {
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(ncstreamer::RemoteMessage::MessageType::
+      kStreamingCommentsSubscribeRequest));
+  tree.put("createdTime", converter.to_bytes(created_time));
+
+  Send(tree);
+}
+
+
+void NcStreamerRemote::SendCommentsUnsubscribeRequest() {
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(ncstreamer::RemoteMessage::MessageType::
+      kStreamingCommentsUnsubscribeRequest));
+
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendViewersRequest() {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::kStreamingViewersRequest));
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::kStreamingViewersRequest));
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendWebcamSearchRequest() {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::kSettingsWebcamSearchRequest));
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::kSettingsWebcamSearchRequest));
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
@@ -842,254 +2725,231 @@ void NcStreamerRemote::SendWebcamOnRequest(
     const float &normal_height,
     const float &normal_x,
     const float &normal_y) {
-  std::stringstream msg;
-  {
-    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::kSettingsWebcamOnRequest));
-    tree.put("device_id", converter.to_bytes(device_id));
-    tree.put("normal_width", normal_width);
-    tree.put("normal_height", normal_height);
-    tree.put("normal_x", normal_x);
-    tree.put("normal_y", normal_y);
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
 
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::kSettingsWebcamOnRequest));
+  tree.put("device_id", converter.to_bytes(device_id));
+  tree.put("normal_width", normal_width);
+  tree.put("normal_height", normal_height);
+  tree.put("normal_x", normal_x);
+  tree.put("normal_y", normal_y);
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendWebcamOffRequest() {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::kSettingsWebcamOffRequest));
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::kSettingsWebcamOffRequest));
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendWebcamSizeRequest(
     const float &normal_width,
     const float &normal_height) {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::kSettingsWebcamSizeRequest));
-    tree.put("normal_width", normal_width);
-    tree.put("normal_height", normal_height);
-
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::kSettingsWebcamSizeRequest));
+  tree.put("normal_width", normal_width);
+  tree.put("normal_height", normal_height);
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendWebcamPositionRequest(
     const float &normal_x,
     const float &normal_y) {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::
-            kSettingsWebcamPositionRequest));
-    tree.put("normal_x", normal_x);
-    tree.put("normal_y", normal_y);
-
-    boost::property_tree::write_json(msg, tree, false);
-  }
-
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::
+          kSettingsWebcamPositionRequest));
+  tree.put("normal_x", normal_x);
+  tree.put("normal_y", normal_y);
+
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendChromaKeyOnRequest(
     const uint32_t &color,
     const int &similarity) {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::
-            kSettingsChromaKeyOnRequest));
-    tree.put("color", color);
-    tree.put("similarity", similarity);
-
-    boost::property_tree::write_json(msg, tree, false);
-  }
-
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::
+          kSettingsChromaKeyOnRequest));
+  tree.put("color", color);
+  tree.put("similarity", similarity);
+
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendChromaKeyOffRequest() {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::
-            kSettingsChromaKeyOffRequest));
-
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::
+          kSettingsChromaKeyOffRequest));
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendChromaKeyColorRequest(const uint32_t &color) {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::
-            kSettingsChromaKeyColorRequest));
-    tree.put("color", color);
-
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::
+          kSettingsChromaKeyColorRequest));
+  tree.put("color", color);
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendChromaKeySimilarityRequest(const int &similarity) {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::
-            kSettingsChromaKeySimilarityRequest));
-    tree.put("similarity", similarity);
-
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::
+          kSettingsChromaKeySimilarityRequest));
+  tree.put("similarity", similarity);
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendMicSearchRequest() {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::kSettingsMicSearchRequest));
-    boost::property_tree::write_json(msg, tree, false);
-  }
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::kSettingsMicSearchRequest));
 
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
-    return;
-  }
+  Send(tree);
 }
 
 
 void NcStreamerRemote::SendMicOnRequest(
     const std::wstring &device_id,
     const float &volume) {
-  std::stringstream msg;
-  {
-    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::
+          kSettingsMicOnRequest));
+  tree.put("device_id", converter.to_bytes(device_id));
+  tree.put("volume", volume);
+
+  Send(tree);
+}
+
+
+void NcStreamerRemote::SendMicOffRequest() {
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      ncstreamer::RemoteMessage::MessageType::
+          kSettingsMicOffRequest));
+
+  Send(tree);
+}
 
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::
-            kSettingsMicOnRequest));
-    tree.put("device_id", converter.to_bytes(device_id));
-    tree.put("volume", volume);
 
-    boost::property_tree::write_json(msg, tree, false);
+void NcStreamerRemote::Send(const boost::property_tree::ptree &tree) {
+  const int msg_type = tree.get<int>("type", 0);
+  RequestLane *lane = GetRequestLane(msg_type);
+  // polls are not tracked.
+  const bool tracked = lane->in_flight == true && lane->polled == nullptr;
+  if (lane->in_flight == true && lane->type == 0) {
+    const uint64_t now_us = GetSteadyMicroseconds();
+    lane->type = msg_type;
+    lane->sent_us = now_us;
+    if (tracked == true) {
+      request_metrics_->OnSent(msg_type, now_us - lane->begun_us);
+      tracer_->Record(
+          TracePhase::kQueue, msg_type, lane->id,
+          lane->begun_us, now_us);
+    }
+  }
+  const bool tracing = tracer_->enabled();
+  const uint64_t serialize_begun_us = tracing ? GetSteadyMicroseconds() : 0;
+
+  websocketpp::connection_hdl connection = remote_connection_;
+  if (bulk_enabled_ == true &&
+      kBulkRequestTypes.count(msg_type) != 0) {
+    std::lock_guard<std::mutex> lock{bulk_mutex_};
+    if (bulk_connection_.lock()) {
+      connection = bulk_connection_;
+    } else if (bulk_open_posted_.exchange(true) == false) {
+      // this one goes on the first connection,
+      // the ones after on the bulk connection if it gets open again.
+      io_service_.post([this]() {
+        bulk_open_posted_ = false;
+        OpenBulkConnection();
+      });
+    }
   }
 
   websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
+  {
+    std::lock_guard<std::mutex> lock{outbound_mutex_};
+    outbound_payload_.clear();
+    {
+      StringAppendBuffer<ResourceString> buf{&outbound_payload_};
+      std::ostream msg{&buf};
+      boost::property_tree::write_json(msg, tree, false);
+    }
+
+    remote_.send(
+        connection,
+        outbound_payload_.data(),
+        outbound_payload_.size(),
+        websocketpp::frame::opcode::text,
+        ec);
+    if (lane->in_flight == true) {
+      lane->sent_connection = connection;
+    }
+    LogFrameSampled("out", outbound_payload_.size());
+    RecordWireFrame(
+        WireDirection::kOutbound,
+        outbound_payload_.data(),
+        outbound_payload_.size());
+  }
+  if (tracing == true) {
+    tracer_->Record(
+        TracePhase::kSerialize, msg_type, tracked ? lane->id : 0,
+        serialize_begun_us, GetSteadyMicroseconds());
+  }
+
+  if (session_replay_sending_ == true) {
+    // not of the caller, so not reported to its handlers.
+    if (ec) {
+      LogError("session replay send failed: " + ec.message());
+    }
+    OnSessionReplaySent(msg_type, !ec);
+    return;
+  }
+
   if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
+    HandleError(lane, Error::Connection::kRemoteSend, ec);
     return;
   }
 }
 
 
-void NcStreamerRemote::SendMicOffRequest() {
-  std::stringstream msg;
-  {
-    boost::property_tree::ptree tree;
-    tree.put("type", static_cast<int>(
-        ncstreamer::RemoteMessage::MessageType::
-            kSettingsMicOffRequest));
-
-    boost::property_tree::write_json(msg, tree, false);
-  }
-
-  websocketpp::lib::error_code ec;
-  remote_.send(
-      remote_connection_, msg.str(), websocketpp::frame::opcode::text, ec);
-  if (ec) {
-    HandleError(Error::Connection::kRemoteSend, ec);
+void NcStreamerRemote::LogFrameSampled(
+    const char *direction,
+    std::size_t size) {
+  const uint32_t one_in = frame_log_sampling_;
+  if (!remote_log_ || one_in == 0 || ++frames_ % one_in != 0) {
     return;
   }
+  remote_.get_alog().write(
+      websocketpp::log::alevel::app,
+      std::string{"sampled frame "} + direction + ": " +
+          std::to_string(size) + " bytes");
 }
 
 
@@ -1103,123 +2963,216 @@ void NcStreamerRemote::OnRemoteClose(websocketpp::connection_hdl connection) {
 }
 
 
+void NcStreamerRemote::OnRemotePong(
+    websocketpp::connection_hdl connection,
+    std::string payload) {
+  heartbeat_->OnPong(payload, GetSteadyMicroseconds());
+}
+
+
+void NcStreamerRemote::OnRemotePongTimeout(
+    websocketpp::connection_hdl connection,
+    std::string payload) {
+  const uint32_t missed = heartbeat_->OnPongTimeout(payload);
+  LogWarning("pong missed: " + std::to_string(missed));
+  if (missed < heartbeat_policy_->max_missed_pongs) {
+    return;
+  }
+
+  // the close handshake times out against a hung peer,
+  // and then the close handler reconnects.
+  websocketpp::lib::error_code ec;
+  remote_.close(
+      connection, websocketpp::close::status::going_away, "pong timeout", ec);
+  if (ec) {
+    LogError("close on pong timeout failed: " + ec.message());
+  }
+}
+
+
 void NcStreamerRemote::OnRemoteMessage(
     websocketpp::connection_hdl connection,
     websocketpp::connection<AsioClient>::message_ptr msg) {
-  busy_ = false;
+  if (appeared_us_ != 0) {
+    launch_to_response_->Record(GetSteadyMicroseconds() - appeared_us_);
+    appeared_us_ = 0;
+  }
+  const std::string &payload = msg->get_payload();
+  LogFrameSampled("in", payload.size());
+  RecordWireFrame(WireDirection::kInbound, payload.data(), payload.size());
+
+  DispatchInboundPayload(payload.data(), payload.size());
+}
+
+
+void NcStreamerRemote::DispatchInboundPayload(
+    const char *payload,
+    std::size_t size) {
+  {
+    ScopedMemoryResource arena_scope{&inbound_arena_};
+    DispatchRemoteMessage(payload, size);
+  }
+  inbound_arena_.Release();
+}
 
-  boost::property_tree::ptree response;
+
+void NcStreamerRemote::DispatchRemoteMessage(
+    const char *payload,
+    std::size_t size) {
+  const uint64_t received_us = GetSteadyMicroseconds();
+  InboundTree response;
   ncstreamer::RemoteMessage::MessageType msg_type{
       ncstreamer::RemoteMessage::MessageType::kUndefined};
 
-  std::stringstream ss{msg->get_payload()};
+  PayloadReadBuffer payload_buf{payload, size};
+  std::istream ss{&payload_buf};
   try {
     boost::property_tree::read_json(ss, response);
     msg_type = static_cast<ncstreamer::RemoteMessage::MessageType>(
         response.get<int>("type"));
   } catch (const std::exception &/*e*/) {
     msg_type = ncstreamer::RemoteMessage::MessageType::kUndefined;
+    request_metrics_->OnParseFailure();
+  }
+  const bool tracing = tracer_->enabled();
+  const uint64_t parsed_us = tracing ? GetSteadyMicroseconds() : 0;
+
+  // events are pushed at any time, so only a response ends a request,
+  // the one in flight on the lane of its request type.
+  RequestLane *lane{nullptr};
+  if (msg_type != ncstreamer::RemoteMessage::MessageType::
+          kStreamingStartEvent &&
+      msg_type != ncstreamer::RemoteMessage::MessageType::
+          kStreamingStopEvent &&
+      msg_type != ncstreamer::RemoteMessage::MessageType::
+          kStreamingCommentsEvent) {
+    lane = GetRequestLane(static_cast<int>(msg_type) - 1);
+    if (lane == control_lane_.get() &&
+        session_replay_pending_.empty() == false) {
+      // the replay holds the control lane, so no control request
+      // of the caller is in flight, though a viewers sample may be.
+      auto pending = std::find(
+          session_replay_pending_.begin(),
+          session_replay_pending_.end(),
+          static_cast<int>(msg_type));
+      if (pending != session_replay_pending_.end()) {
+        session_replay_pending_.erase(pending);
+        OnSessionReplayResponse(response);
+        return;
+      }
+    }
+    if (lane->in_flight == false ||
+        lane->type + 1 != static_cast<int>(msg_type)) {
+      LogWarning(
+          "unexpected response: " +
+          std::to_string(static_cast<int>(msg_type)));
+      return;
+    }
+  }
+
+  // taken before the handler, which may begin the next request.
+  const bool tracked = lane != nullptr && lane->polled == nullptr;
+  const int request_type = tracked ? lane->type : 0;
+  const uint64_t request_id = tracked ? lane->id : 0;
+  const uint64_t request_begun_us = tracked ? lane->begun_us : 0;
+  const uint64_t request_sent_us = tracked ? lane->sent_us : 0;
+  if (tracing == true) {
+    tracer_->Record(
+        TracePhase::kParse, static_cast<int>(msg_type), request_id,
+        received_us, parsed_us);
   }
 
-  using MessageHandler = std::function<void(
-      const boost::property_tree::ptree &/*response*/)>;
-  static const std::unordered_map<ncstreamer::RemoteMessage::MessageType,
-                                  MessageHandler> kMessageHandlers{
-      {ncstreamer::RemoteMessage::MessageType::kStreamingStartEvent,
-       std::bind(&NcStreamerRemote::OnRemoteStartEvent,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kStreamingStopEvent,
-       std::bind(&NcStreamerRemote::OnRemoteStopEvent,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kStreamingStatusResponse,
-       std::bind(&NcStreamerRemote::OnRemoteStatusResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kStreamingStartResponse,
-       std::bind(&NcStreamerRemote::OnRemoteStartResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kStreamingStopResponse,
-       std::bind(&NcStreamerRemote::OnRemoteStopResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kSettingsQualityUpdateResponse,
-       std::bind(&NcStreamerRemote::OnRemoteQualityUpdateResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kStreamingCommentsResponse,
-       std::bind(&NcStreamerRemote::OnRemoteCommentsResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kStreamingViewersResponse,
-       std::bind(&NcStreamerRemote::OnRemoteViewersResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kSettingsWebcamSearchResponse,
-       std::bind(&NcStreamerRemote::OnRemoteWebcamSearchResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kSettingsWebcamOnResponse,
-       std::bind(&NcStreamerRemote::OnRemoteWebcamOnResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kSettingsWebcamOffResponse,
-       std::bind(&NcStreamerRemote::OnRemoteWebcamOffResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kSettingsWebcamSizeResponse,
-       std::bind(&NcStreamerRemote::OnRemoteWebcamSizeResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kSettingsWebcamPositionResponse,
-       std::bind(&NcStreamerRemote::OnRemoteWebcamPositionResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kSettingsChromaKeyOnResponse,
-       std::bind(&NcStreamerRemote::OnRemoteChromaKeyOnResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kSettingsChromaKeyOffResponse,
-       std::bind(&NcStreamerRemote::OnRemoteChromaKeyOffResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kSettingsChromaKeyColorResponse,
-       std::bind(&NcStreamerRemote::OnRemoteChromaKeyColorResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kSettingsMicSearchResponse,
-       std::bind(&NcStreamerRemote::OnRemoteMicSearchResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kSettingsMicOnResponse,
-       std::bind(&NcStreamerRemote::OnRemoteMicOnResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::kSettingsMicOffResponse,
-       std::bind(&NcStreamerRemote::OnRemoteMicOffResponse,
-           this, std::placeholders::_1)},
-      {ncstreamer::RemoteMessage::MessageType::
-          kSettingsChromaKeySimilarityResponse,
-       std::bind(&NcStreamerRemote::OnRemoteChromaKeySimilarityResponse,
-           this, std::placeholders::_1)}};
-
-  auto i = kMessageHandlers.find(msg_type);
+  // the handler ends the request, before calling the caller's handler.
+  responding_lane_ = lane;
+  auto i = kMessageHandlers.find(static_cast<int>(msg_type));
   if (i == kMessageHandlers.end()) {
     LogWarning(
         "unknown message type: " + std::to_string(static_cast<int>(msg_type)));
-    return;
+  } else {
+    (this->*(i->second))(response);
+  }
+  if (responding_lane_ != nullptr) {
+    // as of a broken response, which reaches no handler.
+    EndRequest(responding_lane_);
+  }
+
+  if (tracked == true) {
+    const uint64_t handled_us = GetSteadyMicroseconds();
+    request_metrics_->OnResponded(
+        request_type,
+        received_us - request_sent_us,
+        handled_us - request_begun_us);
+    if (tracing == true) {
+      tracer_->Record(
+          TracePhase::kHandler, request_type, request_id,
+          parsed_us, handled_us);
+      tracer_->Record(
+          TracePhase::kRemote, request_type, request_id,
+          request_sent_us, received_us);
+      tracer_->Record(
+          TracePhase::kRequest, request_type, request_id,
+          request_begun_us, handled_us);
+    }
+  } else if (tracing == true) {
+    tracer_->Record(
+        TracePhase::kHandler, static_cast<int>(msg_type), 0,
+        parsed_us, GetSteadyMicroseconds());
   }
-  i->second(response);
+
+  // a replay due waits for the request in flight on reconnecting.
+  ReplaySessionIfDue();
 }
 
 
-void NcStreamerRemote::OnRemoteStartEvent(
-    const boost::property_tree::ptree &evt) {
-  if (!start_event_handler_) {
-    return;
+void NcStreamerRemote::RecordWireFrame(
+    WireDirection direction,
+    const char *payload,
+    std::size_t size) {
+  const auto &recorder = std::atomic_load(&wire_recorder_);
+  if (recorder) {
+    recorder->Append(direction, payload, size);
+  }
+}
+
+
+void NcStreamerRemote::ReplayWireFrame(
+    const WireFrame &frame,
+    WireReplayStats *stats) {
+  // read in place from the mapped recording.
+  const uint64_t dispatched_us = GetSteadyMicroseconds();
+  try {
+    DispatchInboundPayload(frame.payload, frame.size);
+  } catch (const std::exception &/*e*/) {
+    inbound_arena_.Release();
+    ++stats->failures;
   }
+  stats->dispatch_us += GetSteadyMicroseconds() - dispatched_us;
+  ++stats->frames;
+  stats->bytes += frame.size;
+}
+
 
-  std::string source{};
-  std::string user_page{};
-  std::string privacy{};
-  std::string description{};
-  std::string mic{};
-  std::string service_provider{};
-  std::string stream_url{};
-  std::string post_url{};
+void NcStreamerRemote::OnRemoteStartEvent(
+    const InboundTree &evt) {
+  SetOnAirState(OnAirState::kOnAir);
+
+  InboundString source{};
+  InboundString user_page{};
+  InboundString privacy{};
+  InboundString description{};
+  InboundString mic{};
+  InboundString service_provider{};
+  InboundString stream_url{};
+  InboundString post_url{};
   try {
-    source = evt.get<std::string>("source");
-    user_page = evt.get<std::string>("userPage");
-    privacy = evt.get<std::string>("privacy");
-    description = evt.get<std::string>("description");
-    mic = evt.get<std::string>("mic");
-    service_provider = evt.get<std::string>("serviceProvider");
-    stream_url = evt.get<std::string>("streamUrl");
-    post_url = evt.get<std::string>("postUrl");
+    source = evt.get<InboundString>("source");
+    user_page = evt.get<InboundString>("userPage");
+    privacy = evt.get<InboundString>("privacy");
+    description = evt.get<InboundString>("description");
+    mic = evt.get<InboundString>("mic");
+    service_provider = evt.get<InboundString>("serviceProvider");
+    stream_url = evt.get<InboundString>("streamUrl");
+    post_url = evt.get<InboundString>("postUrl");
   } catch (const std::exception &/*e*/) {
     source.clear();
     user_page.clear();
@@ -1240,28 +3193,38 @@ void NcStreamerRemote::OnRemoteStartEvent(
   boost::split(tokens, source, boost::is_any_of(":"));
   const std::string &source_title = tokens.at(0);
 
-  static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  status_mirror_->OnStart(
+      converter.from_bytes(source_title.c_str()), GetSteadyMilliseconds());
+
+  if (!start_event_handler_) {
+    return;
+  }
+
   start_event_handler_(
-      converter.from_bytes(source_title),
-      converter.from_bytes(user_page),
-      converter.from_bytes(privacy),
-      converter.from_bytes(description),
-      converter.from_bytes(mic),
-      converter.from_bytes(service_provider),
-      converter.from_bytes(stream_url),
-      converter.from_bytes(post_url));
+      converter.from_bytes(source_title.c_str()),
+      converter.from_bytes(user_page.c_str()),
+      converter.from_bytes(privacy.c_str()),
+      converter.from_bytes(description.c_str()),
+      converter.from_bytes(mic.c_str()),
+      converter.from_bytes(service_provider.c_str()),
+      converter.from_bytes(stream_url.c_str()),
+      converter.from_bytes(post_url.c_str()));
 }
 
 
 void NcStreamerRemote::OnRemoteStopEvent(
-    const boost::property_tree::ptree &evt) {
+    const InboundTree &evt) {
+  SetOnAirState(OnAirState::kOffAir);
+  status_mirror_->OnStop();
+
   if (!stop_event_handler_) {
     return;
   }
 
-  std::string source{};
+  InboundString source{};
   try {
-    source = evt.get<std::string>("source");
+    source = evt.get<InboundString>("source");
   } catch (const std::exception &/*e*/) {
     source.clear();
   }
@@ -1275,23 +3238,56 @@ void NcStreamerRemote::OnRemoteStopEvent(
   boost::algorithm::split(tokens, source, boost::is_any_of(":"));
   const std::string &source_title = tokens.at(0);
 
-  static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
   stop_event_handler_(
-      converter.from_bytes(source_title));
+      converter.from_bytes(source_title.c_str()));
+}
+
+
+void NcStreamerRemote::OnRemoteCommentsEvent(
+    const InboundTree &evt) {
+  InboundString chat_message{};
+  try {
+    chat_message = evt.get<InboundString>("comments");
+  } catch (const std::exception &/*e*/) {
+    LogError("comments event broken");
+    return;
+  }
+
+  // pushed comments always feed the comment store.
+  const auto &filter = std::atomic_load(&comment_filter_);
+  CommentRecords comments;
+  if (CommentDecoder::Decode(
+      chat_message.data(), chat_message.size(),
+      filter.get(), &comments) == false) {
+    LogError("comments event broken");
+    return;
+  }
+  StoreComments(comments);
+
+  if (comment_records_event_handler_) {
+    comment_records_event_handler_(comments);
+  }
+
+  if (comments_event_handler_) {
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    comments_event_handler_(
+        converter.from_bytes(chat_message.c_str()));
+  }
 }
 
 
 void NcStreamerRemote::OnRemoteStatusResponse(
-    const boost::property_tree::ptree &response) {
-  std::string status{};
-  std::string source_title{};
-  std::string user_name{};
-  std::string quality{};
+    const InboundTree &response) {
+  InboundString status{};
+  InboundString source_title{};
+  InboundString user_name{};
+  InboundString quality{};
   try {
-    status = response.get<std::string>("status");
-    source_title = response.get<std::string>("sourceTitle");
-    user_name = response.get<std::string>("userName");
-    quality = response.get<std::string>("quality");
+    status = response.get<InboundString>("status");
+    source_title = response.get<InboundString>("sourceTitle");
+    user_name = response.get<InboundString>("userName");
+    quality = response.get<InboundString>("quality");
   } catch (const std::exception &/*e*/) {
     status.clear();
     source_title.clear();
@@ -1306,26 +3302,45 @@ void NcStreamerRemote::OnRemoteStatusResponse(
     return;
   }
 
+  // "starting" and "stopping" are on their way, leaving the state as is.
+  if (status == "onAir") {
+    SetOnAirState(OnAirState::kOnAir);
+  } else if (status == "standby" || status == "setup") {
+    SetOnAirState(OnAirState::kOffAir);
+  }
+
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  const std::wstring &wide_status = converter.from_bytes(status.c_str());
+  const std::wstring &wide_source_title =
+      converter.from_bytes(source_title.c_str());
+  const std::wstring &wide_user_name = converter.from_bytes(user_name.c_str());
+  const std::wstring &wide_quality = converter.from_bytes(quality.c_str());
+  status_mirror_->OnStatus(
+      wide_status,
+      wide_source_title,
+      wide_user_name,
+      wide_quality,
+      GetSteadyMilliseconds());
+
   if (!current_status_response_handler_) {
     LogError("!current_status_response_handler_");
     return;
   }
 
-  static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-  current_status_response_handler_(
-      converter.from_bytes(status),
-      converter.from_bytes(source_title),
-      converter.from_bytes(user_name),
-      converter.from_bytes(quality));
+  TakeResponseHandler(&current_status_response_handler_)(
+      wide_status,
+      wide_source_title,
+      wide_user_name,
+      wide_quality);
 }
 
 
 void NcStreamerRemote::OnRemoteStartResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    error = response.get<std::string>("error");
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1336,25 +3351,25 @@ void NcStreamerRemote::OnRemoteStartResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToStartError(error);
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToStartError(error.c_str());
 
-    current_error_handler_(
+    ReportError(
         ErrorCategory::kStart,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_start_response_handler_(true);
+    TakeResponseHandler(&current_start_response_handler_)(true);
   }
 }
 
 
 void NcStreamerRemote::OnRemoteStopResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    error = response.get<std::string>("error");
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1365,25 +3380,25 @@ void NcStreamerRemote::OnRemoteStopResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToStopError(error);
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToStopError(error.c_str());
 
-    current_error_handler_(
+    ReportError(
         ErrorCategory::kStop,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_stop_response_handler_(true);
+    TakeResponseHandler(&current_stop_response_handler_)(true);
   }
 }
 
 
 void NcStreamerRemote::OnRemoteQualityUpdateResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    error = response.get<std::string>("error");
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1394,23 +3409,25 @@ void NcStreamerRemote::OnRemoteQualityUpdateResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    current_error_handler_(
-        ErrorCategory::kMisc, 0, converter.from_bytes(error));
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    ReportError(
+        ErrorCategory::kMisc, 0, converter.from_bytes(error.c_str()));
   } else {
-    current_quality_update_response_handler_(true);
+    session_state_->SetQuality(session_requested_->quality);
+    status_mirror_->OnQuality(session_state_->Get().quality);
+    TakeResponseHandler(&current_quality_update_response_handler_)(true);
   }
 }
 
 
 void NcStreamerRemote::OnRemoteCommentsResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
-  std::string chat_message{};
+  InboundString error{};
+  InboundString chat_message{};
   try {
-    error = response.get<std::string>("error");
-    chat_message = response.get<std::string>("comments");
+    error = response.get<InboundString>("error");
+    chat_message = response.get<InboundString>("comments");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1420,27 +3437,104 @@ void NcStreamerRemote::OnRemoteCommentsResponse(
     return;
   }
 
-  static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
   if (error.empty() == false) {
-    const auto &err_info = ErrorConverter::ToCommentsError(error);
-    current_error_handler_(
+    const auto &err_info = ErrorConverter::ToCommentsError(error.c_str());
+    ReportError(
         ErrorCategory::kComments,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
-    } else {
-      current_comments_response_handler_(converter.from_bytes(chat_message));
+  } else if (bulk_lane_->polled != nullptr ||
+             current_comment_records_response_handler_) {
+    // a poll leaves alone the handlers, which a request waiting may own.
+    const auto &filter = std::atomic_load(&comment_filter_);
+    CommentRecords comments;
+    if (CommentDecoder::Decode(
+        chat_message.data(), chat_message.size(),
+        filter.get(), &comments) == false) {
+      LogError("comments response broken");
+      return;
+    }
+    StoreComments(comments);
+    if (bulk_lane_->polled != nullptr) {
+      bulk_lane_->poll_changed =
+          comment_store_->GetCursor() != comments_polled_cursor_;
+      return;
     }
+    TakeResponseHandler(&current_comment_records_response_handler_)(comments);
+  } else {
+    TakeResponseHandler(&current_comments_response_handler_)(
+        converter.from_bytes(chat_message.c_str()));
+  }
+}
+
+
+void NcStreamerRemote::OnRemoteCommentsSubscribeResponse(
+    const InboundTree &response) {
+  bool exception_occurred{false};
+  InboundString error{};
+  try {
+    error = response.get<InboundString>("error");
+  } catch (const std::exception &/*e*/) {
+    exception_occurred = true;
+  }
+
+  if (exception_occurred == true) {
+    LogError("comments subscribe response broken");
+    return;
+  }
+
+  if (error.empty() == false) {
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToCommentsError(error.c_str());
+
+    ReportError(
+        ErrorCategory::kComments,
+        static_cast<int>(err_info.first),
+        converter.from_bytes(err_info.second));
+  } else {
+    TakeResponseHandler(&current_comments_subscribe_response_handler_)(true);
+  }
+}
+
+
+void NcStreamerRemote::OnRemoteCommentsUnsubscribeResponse(
+    const InboundTree &response) {
+  bool exception_occurred{false};
+  InboundString error{};
+  try {
+    error = response.get<InboundString>("error");
+  } catch (const std::exception &/*e*/) {
+    exception_occurred = true;
+  }
+
+  if (exception_occurred == true) {
+    LogError("comments unsubscribe response broken");
+    return;
+  }
+
+  if (error.empty() == false) {
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToCommentsError(error.c_str());
+
+    ReportError(
+        ErrorCategory::kComments,
+        static_cast<int>(err_info.first),
+        converter.from_bytes(err_info.second));
+  } else {
+    TakeResponseHandler(&current_comments_unsubscribe_response_handler_)(true);
+  }
 }
 
 
 void NcStreamerRemote::OnRemoteViewersResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
-  std::string viewers_message{};
+  InboundString error{};
+  InboundString viewers_message{};
   try {
-    error = response.get<std::string>("error");
-    viewers_message = response.get<std::string>("viewers");
+    error = response.get<InboundString>("error");
+    viewers_message = response.get<InboundString>("viewers");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1450,33 +3544,48 @@ void NcStreamerRemote::OnRemoteViewersResponse(
     return;
   }
 
-  static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
   if (error.empty() == false) {
-    const auto &err_info = ErrorConverter::ToViewersError(error);
-    current_error_handler_(
+    const auto &err_info = ErrorConverter::ToViewersError(error.c_str());
+    ReportError(
         ErrorCategory::kViewers,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_viewers_response_handler_(
-        converter.from_bytes(viewers_message));
+    char *viewers_end{nullptr};
+    const unsigned long viewers =  // NOLINT
+        std::strtoul(viewers_message.c_str(), &viewers_end, 10);
+    if (viewers_message.empty() == false && *viewers_end == '\0') {
+      viewer_series_->Add(
+          GetSteadyMilliseconds(), static_cast<uint32_t>(viewers));
+    }
+    if (control_lane_->polled != nullptr) {
+      const std::wstring &sampled =
+          converter.from_bytes(viewers_message.c_str());
+      control_lane_->poll_changed = sampled != last_sampled_viewers_;
+      last_sampled_viewers_ = sampled;
+      return;
+    }
+
+    TakeResponseHandler(&current_viewers_response_handler_)(
+        converter.from_bytes(viewers_message.c_str()));
   }
 }
 
 
 
 void NcStreamerRemote::OnRemoteWebcamSearchResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   std::vector<std::wstring> webcams;
   try {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    error = response.get<std::string>("error");
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    error = response.get<InboundString>("error");
     const auto &webcam_list = response.get_child("webcamList");
     for (const auto &webcam : webcam_list) {
-      const std::string &id = webcam.second.get<std::string>("id");
-      std::wstring device{converter.from_bytes(id)};
+      const InboundString &id = webcam.second.get<InboundString>("id");
+      std::wstring device{converter.from_bytes(id.c_str())};
       webcams.emplace_back(device);
     }
   } catch (const std::exception &/*e*/) {
@@ -1489,25 +3598,25 @@ void NcStreamerRemote::OnRemoteWebcamSearchResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToWebcamError(error);
-    current_error_handler_(
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToWebcamError(error.c_str());
+    ReportError(
         ErrorCategory::kWebcam,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_webcam_search_response_handler_(webcams);
+    TakeResponseHandler(&current_webcam_search_response_handler_)(webcams);
   }
 }
 
 
 void NcStreamerRemote::OnRemoteWebcamOnResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    error = response.get<std::string>("error");
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1518,25 +3627,33 @@ void NcStreamerRemote::OnRemoteWebcamOnResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToWebcamError(error);
-    current_error_handler_(
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToWebcamError(error.c_str());
+    ReportError(
         ErrorCategory::kWebcam,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_webcam_on_response_handler_();
+    const WebcamState &requested = session_requested_->webcam;
+    session_state_->SetWebcamOn(
+        requested.device_id,
+        requested.normal_width,
+        requested.normal_height,
+        requested.normal_x,
+        requested.normal_y);
+    status_mirror_->OnWebcam(session_state_->Get().webcam);
+    TakeResponseHandler(&current_webcam_on_response_handler_)();
   }
 }
 
 
 void NcStreamerRemote::OnRemoteWebcamOffResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    error = response.get<std::string>("error");
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1547,25 +3664,27 @@ void NcStreamerRemote::OnRemoteWebcamOffResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToWebcamError(error);
-    current_error_handler_(
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToWebcamError(error.c_str());
+    ReportError(
         ErrorCategory::kWebcam,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_webcam_off_response_handler_();
+    session_state_->SetWebcamOff();
+    status_mirror_->OnWebcam(session_state_->Get().webcam);
+    TakeResponseHandler(&current_webcam_off_response_handler_)();
   }
 }
 
 
 void NcStreamerRemote::OnRemoteWebcamSizeResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    error = response.get<std::string>("error");
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1576,25 +3695,29 @@ void NcStreamerRemote::OnRemoteWebcamSizeResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToWebcamError(error);
-    current_error_handler_(
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToWebcamError(error.c_str());
+    ReportError(
         ErrorCategory::kWebcam,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_webcam_size_response_handler_();
+    session_state_->SetWebcamSize(
+        session_requested_->webcam.normal_width,
+        session_requested_->webcam.normal_height);
+    status_mirror_->OnWebcam(session_state_->Get().webcam);
+    TakeResponseHandler(&current_webcam_size_response_handler_)();
   }
 }
 
 
 void NcStreamerRemote::OnRemoteWebcamPositionResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    error = response.get<std::string>("error");
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1605,25 +3728,29 @@ void NcStreamerRemote::OnRemoteWebcamPositionResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToWebcamError(error);
-    current_error_handler_(
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToWebcamError(error.c_str());
+    ReportError(
         ErrorCategory::kWebcam,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_webcam_position_response_handler_();
+    session_state_->SetWebcamPosition(
+        session_requested_->webcam.normal_x,
+        session_requested_->webcam.normal_y);
+    status_mirror_->OnWebcam(session_state_->Get().webcam);
+    TakeResponseHandler(&current_webcam_position_response_handler_)();
   }
 }
 
 
 void NcStreamerRemote::OnRemoteChromaKeyOnResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    error = response.get<std::string>("error");
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1634,25 +3761,29 @@ void NcStreamerRemote::OnRemoteChromaKeyOnResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToChromaKeyError(error);
-    current_error_handler_(
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToChromaKeyError(error.c_str());
+    ReportError(
         ErrorCategory::kChromaKey,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_chroma_key_on_response_handler_();
+    session_state_->SetChromaKeyOn(
+        session_requested_->chroma_key.color,
+        session_requested_->chroma_key.similarity);
+    status_mirror_->OnChromaKey(session_state_->Get().chroma_key);
+    TakeResponseHandler(&current_chroma_key_on_response_handler_)();
   }
 }
 
 
 void NcStreamerRemote::OnRemoteChromaKeyOffResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    error = response.get<std::string>("error");
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1663,25 +3794,27 @@ void NcStreamerRemote::OnRemoteChromaKeyOffResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToChromaKeyError(error);
-    current_error_handler_(
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToChromaKeyError(error.c_str());
+    ReportError(
         ErrorCategory::kChromaKey,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_chroma_key_off_response_handler_();
+    session_state_->SetChromaKeyOff();
+    status_mirror_->OnChromaKey(session_state_->Get().chroma_key);
+    TakeResponseHandler(&current_chroma_key_off_response_handler_)();
   }
 }
 
 
 void NcStreamerRemote::OnRemoteChromaKeyColorResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    error = response.get<std::string>("error");
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1692,25 +3825,27 @@ void NcStreamerRemote::OnRemoteChromaKeyColorResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToChromaKeyError(error);
-    current_error_handler_(
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToChromaKeyError(error.c_str());
+    ReportError(
         ErrorCategory::kChromaKey,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_chroma_key_on_response_handler_();
+    session_state_->SetChromaKeyColor(session_requested_->chroma_key.color);
+    status_mirror_->OnChromaKey(session_state_->Get().chroma_key);
+    TakeResponseHandler(&current_chroma_key_color_response_handler_)();
   }
 }
 
 
 void NcStreamerRemote::OnRemoteChromaKeySimilarityResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    error = response.get<std::string>("error");
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1721,32 +3856,36 @@ void NcStreamerRemote::OnRemoteChromaKeySimilarityResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToChromaKeyError(error);
-    current_error_handler_(
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToChromaKeyError(error.c_str());
+    ReportError(
         ErrorCategory::kChromaKey,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_chroma_key_on_response_handler_();
+    session_state_->SetChromaKeySimilarity(
+        session_requested_->chroma_key.similarity);
+    status_mirror_->OnChromaKey(session_state_->Get().chroma_key);
+    TakeResponseHandler(&current_chroma_key_similarity_response_handler_)();
   }
 }
 
 
 void NcStreamerRemote::OnRemoteMicSearchResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   std::vector<std::wstring> mic_devices;
   try {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    error = response.get<std::string>("error");
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    error = response.get<InboundString>("error");
     const auto &mic_list = response.get_child("micList");
     for (const auto &mic : mic_list) {
-      const std::string &id = mic.second.get<std::string>("id");
-      const std::string &name = mic.second.get<std::string>("name");
+      const InboundString &id = mic.second.get<InboundString>("id");
+      const InboundString &name = mic.second.get<InboundString>("name");
       std::wstring device{
-          converter.from_bytes(id) + L":" + converter.from_bytes(name)};
+          converter.from_bytes(id.c_str()) + L":" +
+          converter.from_bytes(name.c_str())};
       mic_devices.emplace_back(device);
     }
   } catch (const std::exception &/*e*/) {
@@ -1759,25 +3898,25 @@ void NcStreamerRemote::OnRemoteMicSearchResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToMicError(error);
-    current_error_handler_(
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToMicError(error.c_str());
+    ReportError(
         ErrorCategory::kMic,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_mic_search_response_handler_(mic_devices);
+    TakeResponseHandler(&current_mic_search_response_handler_)(mic_devices);
   }
 }
 
 
 void NcStreamerRemote::OnRemoteMicOnResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    error = response.get<std::string>("error");
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1788,25 +3927,28 @@ void NcStreamerRemote::OnRemoteMicOnResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToMicError(error);
-    current_error_handler_(
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToMicError(error.c_str());
+    ReportError(
         ErrorCategory::kMic,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_mic_on_response_handler_();
+    session_state_->SetMicOn(
+        session_requested_->mic.device_id, session_requested_->mic.volume);
+    status_mirror_->OnMic(session_state_->Get().mic);
+    TakeResponseHandler(&current_mic_on_response_handler_)();
   }
 }
 
 
 void NcStreamerRemote::OnRemoteMicOffResponse(
-    const boost::property_tree::ptree &response) {
+    const InboundTree &response) {
   bool exception_occurred{false};
-  std::string error{};
+  InboundString error{};
   try {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    error = response.get<std::string>("error");
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    error = response.get<InboundString>("error");
   } catch (const std::exception &/*e*/) {
     exception_occurred = true;
   }
@@ -1817,35 +3959,157 @@ void NcStreamerRemote::OnRemoteMicOffResponse(
   }
 
   if (error.empty() == false) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-    const auto &err_info = ErrorConverter::ToMicError(error);
-    current_error_handler_(
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    const auto &err_info = ErrorConverter::ToMicError(error.c_str());
+    ReportError(
         ErrorCategory::kMic,
         static_cast<int>(err_info.first),
         converter.from_bytes(err_info.second));
   } else {
-    current_mic_off_response_handler_();
+    session_state_->SetMicOff();
+    status_mirror_->OnMic(session_state_->Get().mic);
+    TakeResponseHandler(&current_mic_off_response_handler_)();
+  }
+}
+
+
+bool NcStreamerRemote::BeginRequest(
+    RequestLane *lane,
+    Inplace<ErrorHandler> *error_handler) {
+  if (lane->busy.exchange(true) == true) {
+    HandleConnectionError(Error::Connection::kBusy, *error_handler);
+    return false;
+  }
+  lane->error_handler = std::move(*error_handler);
+  lane->requested_us = GetSteadyMicroseconds();
+  return true;
+}
+
+
+void NcStreamerRemote::PostRequest(RequestLane *lane) {
+  io_service_.post(BindHandlerMemory(&lane->handler_memory, [this, lane]() {
+    RunRequest(lane);
+  }));
+}
+
+
+void NcStreamerRemote::RunRequest(RequestLane *lane) {
+  if (lane->polled != nullptr) {
+    lane->waiting = true;  // until the poll is responded.
+    return;
+  }
+  LaneRequest request{std::move(lane->request)};
+  lane->in_flight = true;
+  lane->type = 0;
+  lane->id = ++request_id_;
+  lane->begun_us = lane->requested_us;
+  request();
+}
+
+
+void NcStreamerRemote::EndRequest(RequestLane *lane) {
+  if (responding_lane_ == lane) {
+    responding_lane_ = nullptr;
+  }
+  lane->in_flight = false;
+  if (lane->polled == nullptr) {
+    lane->busy = false;
+    return;
   }
+
+  PollSchedule *polled = lane->polled;
+  lane->polled = nullptr;
+  polled->OnResponse(lane->poll_changed);
+  if (lane->waiting == true) {
+    lane->waiting = false;
+    PostRequest(lane);
+  }
+}
+
+
+void NcStreamerRemote::FailRequest(
+    RequestLane *lane,
+    ErrorCategory err_category,
+    int err_code,
+    const std::wstring &err_msg) {
+  if (lane->in_flight == false) {
+    return;
+  }
+  if (lane->polled != nullptr) {
+    lane->poll_changed = false;
+    EndRequest(lane);
+    return;
+  }
+  Inplace<ErrorHandler> error_handler{std::move(lane->error_handler)};
+  EndRequest(lane);
+  if (error_handler) {
+    error_handler(err_category, err_code, err_msg);
+  }
+}
+
+
+NcStreamerRemote::RequestLane *NcStreamerRemote::GetRequestLane(
+    int request_type) {
+  return (kBulkRequestTypes.count(request_type) != 0) ?
+      bulk_lane_.get() : control_lane_.get();
+}
+
+
+void NcStreamerRemote::ReportError(
+    ErrorCategory err_category,
+    int err_code,
+    const std::wstring &err_msg) {
+  if (responding_lane_ == nullptr) {
+    return;
+  }
+  request_metrics_->OnError(responding_lane_->type, err_category, err_code);
+  FailRequest(responding_lane_, err_category, err_code, err_msg);
 }
 
 
 void NcStreamerRemote::HandleDisconnect(
     Error::Connection err_code) {
   remote_connection_.reset();
-  busy_ = false;
+  CloseBulkConnection();
+  if (session_replay_sending_ == true ||
+      session_replay_pending_.empty() == false) {
+    control_lane_->busy = false;
+  }
+  // the requests in flight are given up unreported.
+  for (RequestLane *lane : {control_lane_.get(), bulk_lane_.get()}) {
+    if (lane->in_flight == true) {
+      lane->poll_changed = false;
+      lane->error_handler.Reset();
+      EndRequest(lane);
+    }
+  }
+  session_replay_due_ = true;
+  session_replay_sending_ = false;
+  session_replay_pending_.clear();
+  timer_to_ping_.cancel();
+  SetConnectionState(ConnectionState::kDisconnected);
+  status_mirror_->Invalidate();
+  SetOnAirState(OnAirState::kUnknown);
   LogWarning(ErrorConverter::ToConnectionError(err_code));
+  if (shutting_down_ == true) {
+    return;
+  }
 
   if (disconnect_handler_) {
     disconnect_handler_();
   }
 
-  KeepConnected();
+  ScheduleReconnect();
 }
 
 
 void NcStreamerRemote::HandleConnectionError(
     Error::Connection err_code,
-    const ErrorHandler &err_handler) {
+    const Inplace<ErrorHandler> &err_handler) {
+  // of a request not let in, as the one in flight goes on.
+  request_metrics_->OnError(
+      0, ErrorCategory::kConnection, static_cast<int>(err_code));
+
   std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
 
   err_handler(
@@ -1855,17 +4119,10 @@ void NcStreamerRemote::HandleConnectionError(
 }
 
 
-void NcStreamerRemote::HandleError(
-    Error::Connection err_code,
-    const websocketpp::lib::error_code &ec) {
-  HandleError(err_code, ec, current_error_handler_);
-}
-
-
 void NcStreamerRemote::HandleError(
     Error::Connection err_code,
     const websocketpp::lib::error_code &ec,
-    const ErrorHandler &err_handler) {
+    const Inplace<ErrorHandler> &err_handler) {
   const auto &err_msg = ErrorConverter::ToConnectionError(err_code);
   std::stringstream ss;
   ss << err_msg << ": " << ec.message();
@@ -1873,22 +4130,17 @@ void NcStreamerRemote::HandleError(
 }
 
 
-void NcStreamerRemote::HandleError(
-    Error::Connection err_code) {
-  const auto &err_msg = ErrorConverter::ToConnectionError(err_code);
-  HandleError(err_code, err_msg, current_error_handler_);
-}
-
-
 void NcStreamerRemote::HandleError(
     Error::Connection err_code,
     const std::string &err_msg,
-    const ErrorHandler &err_handler) {
-  busy_ = false;
+    const Inplace<ErrorHandler> &err_handler) {
+  // of no request in flight, so not sent.
+  request_metrics_->OnError(
+      0, ErrorCategory::kConnection, static_cast<int>(err_code));
   LogError(err_msg);
 
   if (err_handler) {
-    static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+    std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
     err_handler(
         ErrorCategory::kConnection,
         static_cast<int>(err_code),
@@ -1899,12 +4151,51 @@ void NcStreamerRemote::HandleError(
 
 void NcStreamerRemote::HandleError(
     Error::Connection err_code,
-    const ErrorHandler &err_handler) {
+    const Inplace<ErrorHandler> &err_handler) {
   const auto &err_msg = ErrorConverter::ToConnectionError(err_code);
   HandleError(err_code, err_msg, err_handler);
 }
 
 
+void NcStreamerRemote::HandleError(
+    RequestLane *lane,
+    Error::Connection err_code,
+    const websocketpp::lib::error_code &ec) {
+  const auto &err_msg = ErrorConverter::ToConnectionError(err_code);
+  std::stringstream ss;
+  ss << err_msg << ": " << ec.message();
+  HandleError(lane, err_code, ss.str());
+}
+
+
+void NcStreamerRemote::HandleError(
+    RequestLane *lane,
+    Error::Connection err_code,
+    const std::string &err_msg) {
+  LogError(err_msg);
+  if (lane->in_flight == false) {
+    return;
+  }
+  request_metrics_->OnError(
+      lane->type, ErrorCategory::kConnection, static_cast<int>(err_code));
+
+  std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+  FailRequest(
+      lane,
+      ErrorCategory::kConnection,
+      static_cast<int>(err_code),
+      converter.from_bytes(err_msg));
+}
+
+
+void NcStreamerRemote::HandleError(
+    RequestLane *lane,
+    Error::Connection err_code) {
+  const auto &err_msg = ErrorConverter::ToConnectionError(err_code);
+  HandleError(lane, err_code, err_msg);
+}
+
+
 void NcStreamerRemote::LogWarning(const std::string &warn_msg) {
   remote_.get_elog().write(websocketpp::log::elevel::warn, warn_msg);
 }
@@ -1916,4 +4207,55 @@ void NcStreamerRemote::LogError(const std::string &err_msg) {
 
 
 NcStreamerRemote *NcStreamerRemote::static_instance{nullptr};
+MemoryResource *NcStreamerRemote::static_previous_resource{nullptr};
+
+
+const std::unordered_map<int, NcStreamerRemote::MessageHandler>
+    NcStreamerRemote::kMessageHandlers{
+    {static_cast<int>(RemoteMessageType::kStreamingStartEvent),
+     &NcStreamerRemote::OnRemoteStartEvent},
+    {static_cast<int>(RemoteMessageType::kStreamingStopEvent),
+     &NcStreamerRemote::OnRemoteStopEvent},
+    {static_cast<int>(RemoteMessageType::kStreamingCommentsEvent),
+     &NcStreamerRemote::OnRemoteCommentsEvent},
+    {static_cast<int>(RemoteMessageType::kStreamingStatusResponse),
+     &NcStreamerRemote::OnRemoteStatusResponse},
+    {static_cast<int>(RemoteMessageType::kStreamingStartResponse),
+     &NcStreamerRemote::OnRemoteStartResponse},
+    {static_cast<int>(RemoteMessageType::kStreamingStopResponse),
+     &NcStreamerRemote::OnRemoteStopResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsQualityUpdateResponse),
+     &NcStreamerRemote::OnRemoteQualityUpdateResponse},
+    {static_cast<int>(RemoteMessageType::kStreamingCommentsResponse),
+     &NcStreamerRemote::OnRemoteCommentsResponse},
+    {static_cast<int>(RemoteMessageType::kStreamingCommentsSubscribeResponse),
+     &NcStreamerRemote::OnRemoteCommentsSubscribeResponse},
+    {static_cast<int>(RemoteMessageType::kStreamingCommentsUnsubscribeResponse),
+     &NcStreamerRemote::OnRemoteCommentsUnsubscribeResponse},
+    {static_cast<int>(RemoteMessageType::kStreamingViewersResponse),
+     &NcStreamerRemote::OnRemoteViewersResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsWebcamSearchResponse),
+     &NcStreamerRemote::OnRemoteWebcamSearchResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsWebcamOnResponse),
+     &NcStreamerRemote::OnRemoteWebcamOnResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsWebcamOffResponse),
+     &NcStreamerRemote::OnRemoteWebcamOffResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsWebcamSizeResponse),
+     &NcStreamerRemote::OnRemoteWebcamSizeResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsWebcamPositionResponse),
+     &NcStreamerRemote::OnRemoteWebcamPositionResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsChromaKeyOnResponse),
+     &NcStreamerRemote::OnRemoteChromaKeyOnResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsChromaKeyOffResponse),
+     &NcStreamerRemote::OnRemoteChromaKeyOffResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsChromaKeyColorResponse),
+     &NcStreamerRemote::OnRemoteChromaKeyColorResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsMicSearchResponse),
+     &NcStreamerRemote::OnRemoteMicSearchResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsMicOnResponse),
+     &NcStreamerRemote::OnRemoteMicOnResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsMicOffResponse),
+     &NcStreamerRemote::OnRemoteMicOffResponse},
+    {static_cast<int>(RemoteMessageType::kSettingsChromaKeySimilarityResponse),
+     &NcStreamerRemote::OnRemoteChromaKeySimilarityResponse}};
 }  // namespace ncstreamer_remote
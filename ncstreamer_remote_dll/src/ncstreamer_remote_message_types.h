@@ -27,6 +27,11 @@ class RemoteMessage {
     kSettingsQualityUpdateResponse,
     kStreamingCommentsRequest = 401,
     kStreamingCommentsResponse,
+    kStreamingCommentsSubscribeRequest = 411,
+    kStreamingCommentsSubscribeResponse,
+    kStreamingCommentsEvent,
+    kStreamingCommentsUnsubscribeRequest = 421,
+    kStreamingCommentsUnsubscribeResponse,
     kSettingsWebcamSearchRequest = 501,
     kSettingsWebcamSearchResponse,
     kSettingsWebcamOnRequest = 511,
@@ -0,0 +1,123 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/poll/poll_schedule.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace ncstreamer_remote {
+PollSchedule::PollSchedule()
+    : policy_(),
+      running_{false},
+      interval_ms_{0},
+      polls_{0},
+      skips_{0},
+      paused_{false} {
+}
+
+
+PollSchedule::~PollSchedule() {
+}
+
+
+void PollSchedule::Start(const PollPolicy &policy) {
+  assert(policy.min_interval_ms > 0);
+  assert(policy.min_interval_ms <= policy.max_interval_ms);
+  assert(policy.backoff >= 1.0);
+
+  policy_ = policy;
+  interval_ms_ = policy_.min_interval_ms;
+  running_ = true;
+}
+
+
+void PollSchedule::Stop() {
+  running_ = false;
+  interval_ms_ = 0;
+}
+
+
+void PollSchedule::OnResponse(bool active) {
+  if (running_ == false) {
+    return;
+  }
+
+  if (active == true) {
+    interval_ms_ = policy_.min_interval_ms;
+    return;
+  }
+
+  const double backed_off{interval_ms_ * policy_.backoff};
+  interval_ms_ = static_cast<uint32_t>(std::min(
+      backed_off, static_cast<double>(policy_.max_interval_ms)));
+}
+
+
+void PollSchedule::OnPoll() {
+  ++polls_;
+}
+
+
+void PollSchedule::OnSkip() {
+  ++skips_;
+}
+
+
+void PollSchedule::SetPaused(bool paused) {
+  paused_ = paused;
+}
+
+
+PollMetrics PollSchedule::GetMetrics() const {
+  PollMetrics metrics;
+  metrics.interval_ms = interval_ms_;
+  metrics.polls = polls_;
+  metrics.skips = skips_;
+  metrics.paused = paused_;
+  return metrics;
+}
+
+
+PollRateCeiling::PollRateCeiling()
+    : requests_per_ms_{0.0},
+      burst_{0.0},
+      tokens_{0.0},
+      last_ms_{0} {
+}
+
+
+PollRateCeiling::~PollRateCeiling() {
+}
+
+
+void PollRateCeiling::Set(double requests_per_second) {
+  assert(requests_per_second >= 0.0);
+  requests_per_ms_ = requests_per_second / 1000.0;
+  burst_ = std::max(1.0, requests_per_second);
+  tokens_ = burst_;
+  last_ms_ = 0;
+}
+
+
+bool PollRateCeiling::TryAcquire(uint64_t now_ms) {
+  if (requests_per_ms_ == 0.0) {
+    return true;
+  }
+
+  if (last_ms_ != 0 && now_ms > last_ms_) {
+    tokens_ = std::min(
+        burst_, tokens_ + (now_ms - last_ms_) * requests_per_ms_);
+  }
+  last_ms_ = now_ms;
+
+  if (tokens_ < 1.0) {
+    return false;
+  }
+  tokens_ -= 1.0;
+  return true;
+}
+}  // namespace ncstreamer_remote
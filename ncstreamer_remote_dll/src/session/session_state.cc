@@ -0,0 +1,127 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/session/session_state.h"
+
+
+namespace ncstreamer_remote {
+SessionState::SessionState()
+    : mutex_{},
+      snapshot_() {
+  Clear();
+}
+
+
+SessionState::~SessionState() {
+}
+
+
+void SessionState::SetQuality(const std::wstring &quality) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  snapshot_.has_quality = true;
+  snapshot_.quality = quality;
+}
+
+
+void SessionState::SetWebcamOn(
+    const std::wstring &device_id,
+    float normal_width,
+    float normal_height,
+    float normal_x,
+    float normal_y) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  snapshot_.has_webcam = true;
+  snapshot_.webcam.on = true;
+  snapshot_.webcam.device_id = device_id;
+  snapshot_.webcam.normal_width = normal_width;
+  snapshot_.webcam.normal_height = normal_height;
+  snapshot_.webcam.normal_x = normal_x;
+  snapshot_.webcam.normal_y = normal_y;
+}
+
+
+void SessionState::SetWebcamOff() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  snapshot_.has_webcam = true;
+  snapshot_.webcam.on = false;
+}
+
+
+void SessionState::SetWebcamSize(float normal_width, float normal_height) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  snapshot_.webcam.normal_width = normal_width;
+  snapshot_.webcam.normal_height = normal_height;
+}
+
+
+void SessionState::SetWebcamPosition(float normal_x, float normal_y) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  snapshot_.webcam.normal_x = normal_x;
+  snapshot_.webcam.normal_y = normal_y;
+}
+
+
+void SessionState::SetChromaKeyOn(uint32_t color, int similarity) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  snapshot_.has_chroma_key = true;
+  snapshot_.chroma_key.on = true;
+  snapshot_.chroma_key.color = color;
+  snapshot_.chroma_key.similarity = similarity;
+}
+
+
+void SessionState::SetChromaKeyOff() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  snapshot_.has_chroma_key = true;
+  snapshot_.chroma_key.on = false;
+}
+
+
+void SessionState::SetChromaKeyColor(uint32_t color) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  snapshot_.chroma_key.color = color;
+}
+
+
+void SessionState::SetChromaKeySimilarity(int similarity) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  snapshot_.chroma_key.similarity = similarity;
+}
+
+
+void SessionState::SetMicOn(const std::wstring &device_id, float volume) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  snapshot_.has_mic = true;
+  snapshot_.mic.on = true;
+  snapshot_.mic.device_id = device_id;
+  snapshot_.mic.volume = volume;
+}
+
+
+void SessionState::SetMicOff() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  snapshot_.has_mic = true;
+  snapshot_.mic.on = false;
+}
+
+
+void SessionState::Clear() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  snapshot_.has_quality = false;
+  snapshot_.quality.clear();
+  snapshot_.has_webcam = false;
+  snapshot_.webcam = WebcamState{false, L"", 0.0f, 0.0f, 0.0f, 0.0f};
+  snapshot_.has_chroma_key = false;
+  snapshot_.chroma_key = ChromaKeyState{false, 0, 0};
+  snapshot_.has_mic = false;
+  snapshot_.mic = MicState{false, L"", 0.0f};
+}
+
+
+SessionSnapshot SessionState::Get() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return snapshot_;
+}
+}  // namespace ncstreamer_remote
@@ -0,0 +1,136 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/status/status_mirror.h"
+
+
+namespace ncstreamer_remote {
+StatusMirror::StatusMirror(uint32_t max_age_ms)
+    : snapshot_{},
+      max_age_ms_{max_age_ms},
+      confirmed_ms_{0},
+      invalidated_{true} {
+}
+
+
+StatusMirror::~StatusMirror() {
+}
+
+
+void StatusMirror::SetMaxAge(uint32_t max_age_ms) {
+  max_age_ms_ = max_age_ms;
+}
+
+
+void StatusMirror::OnStatus(
+    const std::wstring &status,
+    const std::wstring &source_title,
+    const std::wstring &user_name,
+    const std::wstring &quality,
+    uint64_t now_ms) {
+  Update([&](StatusSnapshot *next) {
+    next->on_air = (status == L"onAir");
+    next->status = status;
+    next->source_title = source_title;
+    next->user_name = user_name;
+    next->quality = quality;
+  });
+  confirmed_ms_ = now_ms;
+  invalidated_ = false;
+}
+
+
+void StatusMirror::OnStart(const std::wstring &source_title, uint64_t now_ms) {
+  Update([&](StatusSnapshot *next) {
+    next->on_air = true;
+    next->status = L"onAir";
+    next->source_title = source_title;
+  });
+  confirmed_ms_ = now_ms;
+  invalidated_ = false;
+}
+
+
+void StatusMirror::OnStop() {
+  Update([](StatusSnapshot *next) {
+    next->on_air = false;
+  });
+  invalidated_ = true;
+}
+
+
+void StatusMirror::OnQuality(const std::wstring &quality) {
+  Update([&](StatusSnapshot *next) {
+    next->quality = quality;
+  });
+}
+
+
+void StatusMirror::OnWebcam(const WebcamState &webcam) {
+  Update([&](StatusSnapshot *next) {
+    next->has_webcam = true;
+    next->webcam = webcam;
+  });
+}
+
+
+void StatusMirror::OnChromaKey(const ChromaKeyState &chroma_key) {
+  Update([&](StatusSnapshot *next) {
+    next->has_chroma_key = true;
+    next->chroma_key = chroma_key;
+  });
+}
+
+
+void StatusMirror::OnMic(const MicState &mic) {
+  Update([&](StatusSnapshot *next) {
+    next->has_mic = true;
+    next->mic = mic;
+  });
+}
+
+
+void StatusMirror::Invalidate() {
+  invalidated_ = true;
+}
+
+
+CachedStatus StatusMirror::Get(uint64_t now_ms) const {
+  CachedStatus cached;
+  cached.snapshot = std::atomic_load(&snapshot_);
+
+  const uint64_t confirmed_ms = confirmed_ms_;
+  cached.age_ms = (now_ms > confirmed_ms) ? now_ms - confirmed_ms : 0;
+  cached.stale = !cached.snapshot ||
+                 invalidated_ == true ||
+                 cached.age_ms > max_age_ms_;
+  return cached;
+}
+
+
+void StatusMirror::Update(
+    const std::function<void(StatusSnapshot *next)> &modify) {
+  const auto &current = std::atomic_load(&snapshot_);
+
+  std::shared_ptr<StatusSnapshot> next{new StatusSnapshot()};
+  if (current) {
+    *next = *current;
+  } else {
+    next->version = 0;
+    next->on_air = false;
+    next->has_webcam = false;
+    next->webcam = WebcamState{false, L"", 0.0f, 0.0f, 0.0f, 0.0f};
+    next->has_chroma_key = false;
+    next->chroma_key = ChromaKeyState{false, 0, 0};
+    next->has_mic = false;
+    next->mic = MicState{false, L"", 0.0f};
+  }
+  modify(next.get());
+  ++next->version;
+
+  std::atomic_store(
+      &snapshot_, std::shared_ptr<const StatusSnapshot>{std::move(next)});
+}
+}  // namespace ncstreamer_remote
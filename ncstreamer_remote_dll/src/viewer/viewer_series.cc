@@ -0,0 +1,228 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/viewer/viewer_series.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+
+namespace ncstreamer_remote {
+ViewerSeries::ViewerSeries()
+    : mutex_{},
+      seconds_{1000, 300},
+      minutes_{60 * 1000, 180},
+      ten_minutes_{10 * 60 * 1000, 144},
+      peak_{0} {
+}
+
+
+ViewerSeries::~ViewerSeries() {
+}
+
+
+void ViewerSeries::Add(uint64_t time_ms, uint32_t viewers) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  seconds_.Add(time_ms, viewers);
+  minutes_.Add(time_ms, viewers);
+  ten_minutes_.Add(time_ms, viewers);
+  peak_ = std::max(peak_, viewers);
+}
+
+
+void ViewerSeries::Clear() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  seconds_.Clear();
+  minutes_.Clear();
+  ten_minutes_.Clear();
+  peak_ = 0;
+}
+
+
+ViewerStats ViewerSeries::GetStats(ViewerResolution resolution) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  ViewerStats stats = GetLevel(resolution).GetStats();
+  stats.peak = peak_;
+  return stats;
+}
+
+
+std::vector<ViewerPoint> ViewerSeries::GetPoints(
+    ViewerResolution resolution) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return GetLevel(resolution).GetPoints();
+}
+
+
+const ViewerSeries::Level &ViewerSeries::GetLevel(
+    ViewerResolution resolution) const {
+  switch (resolution) {
+    case ViewerResolution::kSecond:
+      return seconds_;
+    case ViewerResolution::kMinute:
+      return minutes_;
+    case ViewerResolution::kTenMinutes:
+      return ten_minutes_;
+  }
+  assert(false);
+  return seconds_;
+}
+
+
+ViewerSeries::Level::Level(uint64_t period_ms, std::size_t size)
+    : period_ms_{period_ms},
+      size_{size},
+      closed_{},
+      opened_{false},
+      open_(),
+      window_count_{0},
+      window_sum_{0},
+      window_minima_{},
+      window_maxima_{} {
+  assert(period_ms_ > 0);
+  assert(size_ > 0);
+}
+
+
+ViewerSeries::Level::~Level() {
+}
+
+
+void ViewerSeries::Level::Add(uint64_t time_ms, uint32_t viewers) {
+  const uint64_t index{time_ms / period_ms_};
+  if (opened_ == false) {
+    Open(index);
+  } else if (index > open_.index) {
+    Close();
+    Open(index);
+  }
+  // a late sample is just folded into the open bucket.
+
+  ++open_.count;
+  open_.sum += viewers;
+  open_.min = std::min(open_.min, viewers);
+  open_.max = std::max(open_.max, viewers);
+}
+
+
+void ViewerSeries::Level::Clear() {
+  closed_.clear();
+  opened_ = false;
+  window_count_ = 0;
+  window_sum_ = 0;
+  window_minima_.clear();
+  window_maxima_.clear();
+}
+
+
+ViewerStats ViewerSeries::Level::GetStats() const {
+  ViewerStats stats{};
+  stats.samples = window_count_;
+  uint64_t sum{window_sum_};
+  uint32_t min{std::numeric_limits<uint32_t>::max()};
+  uint32_t max{0};
+
+  if (window_minima_.empty() == false) {
+    min = window_minima_.front().value;
+    max = window_maxima_.front().value;
+  }
+  if (opened_ == true) {
+    stats.samples += open_.count;
+    sum += open_.sum;
+    min = std::min(min, open_.min);
+    max = std::max(max, open_.max);
+  }
+
+  if (stats.samples == 0) {
+    return stats;
+  }
+  stats.min = min;
+  stats.max = max;
+  stats.average =
+      static_cast<double>(sum) / static_cast<double>(stats.samples);
+  return stats;
+}
+
+
+std::vector<ViewerPoint> ViewerSeries::Level::GetPoints() const {
+  std::vector<ViewerPoint> points;
+  points.reserve(closed_.size() + 1);
+
+  auto to_point = [this](const Bucket &bucket) {
+    ViewerPoint point;
+    point.time_ms = bucket.index * period_ms_;
+    point.min = bucket.min;
+    point.max = bucket.max;
+    point.average =
+        static_cast<double>(bucket.sum) / static_cast<double>(bucket.count);
+    return point;
+  };
+
+  for (const Bucket &bucket : closed_) {
+    points.emplace_back(to_point(bucket));
+  }
+  if (opened_ == true) {
+    points.emplace_back(to_point(open_));
+  }
+  return points;
+}
+
+
+void ViewerSeries::Level::Open(uint64_t index) {
+  Evict(index);
+
+  open_.index = index;
+  open_.count = 0;
+  open_.sum = 0;
+  open_.min = std::numeric_limits<uint32_t>::max();
+  open_.max = 0;
+  opened_ = true;
+}
+
+
+void ViewerSeries::Level::Close() {
+  closed_.emplace_back(open_);
+  window_count_ += open_.count;
+  window_sum_ += open_.sum;
+
+  // both keep only the buckets that may become the extreme later,
+  // so the front is always the extreme of the window.
+  while (window_minima_.empty() == false &&
+         window_minima_.back().value >= open_.min) {
+    window_minima_.pop_back();
+  }
+  window_minima_.push_back(Extreme{open_.index, open_.min});
+
+  while (window_maxima_.empty() == false &&
+         window_maxima_.back().value <= open_.max) {
+    window_maxima_.pop_back();
+  }
+  window_maxima_.push_back(Extreme{open_.index, open_.max});
+
+  opened_ = false;
+}
+
+
+void ViewerSeries::Level::Evict(uint64_t newest_index) {
+  auto expired = [this, newest_index](uint64_t index) {
+    return index + size_ <= newest_index;
+  };
+
+  while (closed_.empty() == false && expired(closed_.front().index)) {
+    window_count_ -= closed_.front().count;
+    window_sum_ -= closed_.front().sum;
+    closed_.pop_front();
+  }
+  while (window_minima_.empty() == false &&
+         expired(window_minima_.front().index)) {
+    window_minima_.pop_front();
+  }
+  while (window_maxima_.empty() == false &&
+         expired(window_maxima_.front().index)) {
+    window_maxima_.pop_front();
+  }
+}
+}  // namespace ncstreamer_remote
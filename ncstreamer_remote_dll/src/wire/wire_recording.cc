@@ -0,0 +1,163 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/wire/wire_recording.h"
+
+#include <cstring>
+
+#include "Windows.h"  // NOLINT
+
+#if _MSC_VER >= 1900
+#include <chrono>  // NOLINT
+namespace Chrono = std::chrono;
+#else
+#include "boost/chrono/include.hpp"
+namespace Chrono = boost::chrono;
+#endif  // _MSC_VER >= 1900
+
+
+namespace {
+const char kMagic[] = "NCSWIRE1";
+const std::size_t kMagicSize{8};
+const std::size_t kFileHeaderSize{16};
+const std::size_t kFrameHeaderSize{16};
+const std::size_t kAlignment{8};
+
+
+uint64_t GetSteadyMicroseconds() {
+  const auto &now = Chrono::duration_cast<Chrono::microseconds>(
+      Chrono::steady_clock::now().time_since_epoch());
+  return static_cast<uint64_t>(now.count());
+}
+
+
+std::size_t ToPadding(std::size_t size) {
+  return (kAlignment - size % kAlignment) % kAlignment;
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote {
+WireRecorder::WireRecorder(const std::string &path)
+    : mutex_{},
+      file_{path, std::ios::binary | std::ios::trunc},
+      opened_{false},
+      started_us_{GetSteadyMicroseconds()},
+      frames_{0} {
+  char header[kFileHeaderSize]{};
+  std::memcpy(header, kMagic, kMagicSize);
+  file_.write(header, kFileHeaderSize);
+  opened_ = file_.good();
+}
+
+
+WireRecorder::~WireRecorder() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  file_.flush();
+}
+
+
+void WireRecorder::Append(
+    WireDirection direction,
+    const char *payload,
+    std::size_t size) {
+  if (opened_ == false) {
+    return;
+  }
+
+  const uint64_t timestamp_us = GetSteadyMicroseconds() - started_us_;
+  const uint32_t payload_size = static_cast<uint32_t>(size);
+  char header[kFrameHeaderSize]{};
+  std::memcpy(header, &timestamp_us, sizeof(timestamp_us));
+  std::memcpy(header + 8, &payload_size, sizeof(payload_size));
+  header[12] = static_cast<char>(direction);
+  static const char kZeros[kAlignment]{};
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  file_.write(header, kFrameHeaderSize);
+  file_.write(payload, size);
+  file_.write(kZeros, ToPadding(size));
+  ++frames_;
+}
+
+
+WireReader::WireReader(const std::string &path)
+    : file_{INVALID_HANDLE_VALUE},
+      mapping_{NULL},
+      view_{nullptr},
+      size_{0},
+      offset_{kFileHeaderSize} {
+  file_ = ::CreateFileA(
+      path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file_ == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  LARGE_INTEGER file_size{};
+  if (::GetFileSizeEx(file_, &file_size) == FALSE ||
+      static_cast<uint64_t>(file_size.QuadPart) < kFileHeaderSize) {
+    Close();
+    return;
+  }
+  mapping_ = ::CreateFileMappingA(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping_ == NULL) {
+    Close();
+    return;
+  }
+  view_ = static_cast<const char *>(
+      ::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+  size_ = static_cast<std::size_t>(file_size.QuadPart);
+  if (view_ == nullptr || std::memcmp(view_, kMagic, kMagicSize) != 0) {
+    Close();
+    return;
+  }
+}
+
+
+WireReader::~WireReader() {
+  Close();
+}
+
+
+bool WireReader::Next(WireFrame *frame) {
+  if (view_ == nullptr || size_ - offset_ < kFrameHeaderSize) {
+    return false;
+  }
+
+  const char *header = view_ + offset_;
+  uint32_t payload_size{0};
+  std::memcpy(&frame->timestamp_us, header, sizeof(frame->timestamp_us));
+  std::memcpy(&payload_size, header + 8, sizeof(payload_size));
+  frame->direction = static_cast<WireDirection>(header[12]);
+  if (size_ - offset_ - kFrameHeaderSize < payload_size) {
+    return false;  // cut short.
+  }
+  frame->payload = header + kFrameHeaderSize;
+  frame->size = payload_size;
+
+  offset_ += kFrameHeaderSize + payload_size + ToPadding(payload_size);
+  if (offset_ > size_) {
+    offset_ = size_;
+  }
+  return true;
+}
+
+
+void WireReader::Close() {
+  if (view_ != nullptr) {
+    ::UnmapViewOfFile(view_);
+    view_ = nullptr;
+  }
+  if (mapping_ != NULL) {
+    ::CloseHandle(mapping_);
+    mapping_ = NULL;
+  }
+  if (file_ != INVALID_HANDLE_VALUE) {
+    ::CloseHandle(file_);
+    file_ = INVALID_HANDLE_VALUE;
+  }
+  size_ = 0;
+}
+}  // namespace ncstreamer_remote
@@ -0,0 +1,252 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/chat_analytics.h"
+#include "ncstreamer_remote_test/src/test_check.h"
+#include "ncstreamer_remote_test/src/test_suites.h"
+
+
+namespace {
+using ncstreamer_remote::ChatAnalytics;
+using ncstreamer_remote::ChatStats;
+using ncstreamer_remote::CommentRecord;
+
+
+/// A steady clock well past zero, as on a running machine.
+const uint64_t kUptimeMs{3 * 24 * 60 * 60 * 1000ULL};
+
+
+/// Feeds the analytics as NcStreamerRemote does on each comment,
+/// on a clock advanced by hand instead of waited on.
+class SimulatedChat {
+ public:
+  explicit SimulatedChat(uint64_t start_ms)
+      : analytics_{},
+        now_ms_{start_ms},
+        author_{L"viewer"} {}
+
+  /// `count` comments spread over the current second, then the next one.
+  void RunSecond(uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+      Add(now_ms_ + i * 1000 / count);
+    }
+    now_ms_ += 1000;
+    analytics_.Advance(now_ms_);
+  }
+
+  void RunSeconds(uint32_t seconds, uint32_t count_per_second) {
+    for (uint32_t i = 0; i < seconds; ++i) {
+      RunSecond(count_per_second);
+    }
+  }
+
+  void Add(uint64_t at_ms) {
+    const CommentRecord record{
+        L"id", author_.c_str(), L"text", L"created_time", 0};
+    analytics_.Add(at_ms, record);
+  }
+
+  void AdvanceTo(uint64_t now_ms) {
+    now_ms_ = now_ms;
+    analytics_.Advance(now_ms_);
+  }
+
+  void Reset() {
+    analytics_.Reset();
+  }
+
+  ChatStats stats() const { return analytics_.GetStats(); }
+  uint64_t now_ms() const { return now_ms_; }
+
+ private:
+  ChatAnalytics analytics_;
+  uint64_t now_ms_;
+  std::wstring author_;
+};
+
+
+void TestSlidingWindows() {
+  SimulatedChat chat{kUptimeMs};
+  chat.Add(kUptimeMs);
+  chat.Add(kUptimeMs + 500);
+  chat.Add(kUptimeMs + 999);
+
+  chat.AdvanceTo(kUptimeMs + 9 * 1000 + 999);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().comments_last_10_seconds == 3);
+
+  chat.AdvanceTo(kUptimeMs + 10 * 1000);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().comments_last_10_seconds == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().comments_last_minute == 3);
+
+  chat.AdvanceTo(kUptimeMs + 60 * 1000);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().comments_last_minute == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().comments_last_5_minutes == 3);
+
+  chat.AdvanceTo(kUptimeMs + 300 * 1000);
+  const ChatStats &stats = chat.stats();
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.comments_last_5_minutes == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.comments_total == 3);
+}
+
+
+void TestSteadyRate() {
+  SimulatedChat chat{kUptimeMs};
+  for (uint32_t second = 0; second < 400; ++second) {
+    chat.RunSecond(2);
+    // the second just closed is still in every window.
+    const uint32_t seen = second + 1;
+    const ChatStats &stats = chat.stats();
+    NCSTREAMER_REMOTE_TEST_CHECK(
+        stats.comments_last_10_seconds == 2 * (seen < 10 ? seen : 9));
+    NCSTREAMER_REMOTE_TEST_CHECK(
+        stats.comments_last_minute == 2 * (seen < 60 ? seen : 59));
+    NCSTREAMER_REMOTE_TEST_CHECK(
+        stats.comments_last_5_minutes == 2 * (seen < 300 ? seen : 299));
+  }
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().comments_total == 800);
+}
+
+
+void TestClockFromZero() {
+  // a clock started near zero, of which no window goes back before zero.
+  SimulatedChat chat{0};
+  for (uint32_t second = 0; second < 400; ++second) {
+    chat.RunSecond(second % 7);
+  }
+  // the last 299, 59 and 9 closed seconds, as the current one is empty.
+  uint32_t last_5_minutes{0};
+  uint32_t last_minute{0};
+  uint32_t last_10_seconds{0};
+  for (uint32_t second = 400 - 299; second < 400; ++second) {
+    last_5_minutes += second % 7;
+    last_minute += (second >= 400 - 59) ? second % 7 : 0;
+    last_10_seconds += (second >= 400 - 9) ? second % 7 : 0;
+  }
+  const ChatStats &stats = chat.stats();
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      stats.comments_last_5_minutes == last_5_minutes);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.comments_last_minute == last_minute);
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      stats.comments_last_10_seconds == last_10_seconds);
+}
+
+
+void TestLongSilenceClears() {
+  SimulatedChat chat{kUptimeMs};
+  chat.RunSeconds(30, 5);
+  chat.AdvanceTo(chat.now_ms() + 301 * 1000);
+  const ChatStats &stats = chat.stats();
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.comments_last_10_seconds == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.comments_last_minute == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.comments_last_5_minutes == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.comments_total == 150);
+}
+
+
+void TestNoBurstWhileWarmingUp() {
+  SimulatedChat chat{kUptimeMs};
+  chat.RunSeconds(20, 30);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().bursting == false);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().bursts == 0);
+}
+
+
+void TestBurstHysteresis() {
+  SimulatedChat chat{kUptimeMs};
+  chat.RunSeconds(120, 1);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().bursting == false);
+
+  chat.RunSeconds(10, 10);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().bursting == true);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().bursts == 1);
+
+  // below the start ratio and above the end one, the burst goes on.
+  chat.RunSeconds(10, 3);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().bursting == true);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().bursts == 1);
+
+  chat.RunSeconds(10, 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().bursting == false);
+
+  chat.RunSeconds(10, 20);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().bursting == true);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().bursts == 2);
+}
+
+
+/// @return The estimate of `authors` distinct authors, each twice.
+uint64_t EstimateAuthors(uint32_t authors) {
+  ChatAnalytics analytics;
+  for (int pass = 0; pass < 2; ++pass) {
+    for (uint32_t i = 0; i < authors; ++i) {
+      const std::wstring &author = L"viewer" + std::to_wstring(i);
+      const CommentRecord record{
+          L"id", author.c_str(), L"text", L"created_time", 0};
+      analytics.Add(kUptimeMs, record);
+    }
+  }
+  return analytics.GetStats().unique_authors;
+}
+
+
+bool IsWithin(uint64_t estimate, uint32_t actual, double error) {
+  const double diff = std::abs(static_cast<double>(estimate) - actual);
+  return diff <= actual * error + 1.0;
+}
+
+
+void TestUniqueAuthors() {
+  NCSTREAMER_REMOTE_TEST_CHECK(EstimateAuthors(0) == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(EstimateAuthors(1) == 1);
+
+  // by linear counting, while many registers are empty.
+  NCSTREAMER_REMOTE_TEST_CHECK(IsWithin(EstimateAuthors(10), 10, 0.0));
+  NCSTREAMER_REMOTE_TEST_CHECK(IsWithin(EstimateAuthors(100), 100, 0.03));
+  NCSTREAMER_REMOTE_TEST_CHECK(IsWithin(EstimateAuthors(1000), 1000, 0.05));
+
+  // around the switch to the raw estimate, at 2.5 times the registers.
+  NCSTREAMER_REMOTE_TEST_CHECK(IsWithin(EstimateAuthors(2400), 2400, 0.1));
+  NCSTREAMER_REMOTE_TEST_CHECK(IsWithin(EstimateAuthors(2600), 2600, 0.1));
+  NCSTREAMER_REMOTE_TEST_CHECK(IsWithin(EstimateAuthors(3000), 3000, 0.1));
+
+  // by the raw estimate, about 3% off with 1024 registers.
+  NCSTREAMER_REMOTE_TEST_CHECK(IsWithin(EstimateAuthors(20000), 20000, 0.1));
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      IsWithin(EstimateAuthors(100000), 100000, 0.1));
+}
+
+
+void TestReset() {
+  SimulatedChat chat{kUptimeMs};
+  chat.RunSeconds(120, 1);
+  chat.RunSeconds(10, 10);
+  NCSTREAMER_REMOTE_TEST_CHECK(chat.stats().bursts == 1);
+  chat.Reset();
+  const ChatStats &stats = chat.stats();
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.comments_last_10_seconds == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.comments_total == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.unique_authors == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.bursting == false);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.bursts == 0);
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_test {
+void TestChatAnalytics() {
+  TestSlidingWindows();
+  TestSteadyRate();
+  TestClockFromZero();
+  TestLongSilenceClears();
+  TestNoBurstWhileWarmingUp();
+  TestBurstHysteresis();
+  TestUniqueAuthors();
+  TestReset();
+}
+}  // namespace ncstreamer_remote_test
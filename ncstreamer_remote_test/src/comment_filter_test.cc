@@ -0,0 +1,162 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/comment/comment_filter.h"
+#include "ncstreamer_remote_test/src/test_check.h"
+#include "ncstreamer_remote_test/src/test_suites.h"
+
+
+namespace {
+using ncstreamer_remote::CommentFilter;
+using ncstreamer_remote::CommentFilterRule;
+
+
+CommentFilter::Match Scan(
+    const CommentFilter &filter,
+    const std::string &text) {
+  return filter.Scan(text.c_str(), text.size());
+}
+
+
+CommentFilterRule Tag(const std::wstring &pattern, uint32_t tags) {
+  return CommentFilterRule{pattern, false, tags};
+}
+
+
+CommentFilterRule Drop(const std::wstring &pattern) {
+  return CommentFilterRule{pattern, true, 0};
+}
+
+
+void TestNoRules() {
+  const CommentFilter filter{{}, false};
+  const CommentFilter::Match &match = Scan(filter, "anything at all");
+  NCSTREAMER_REMOTE_TEST_CHECK(match.drop == false);
+  NCSTREAMER_REMOTE_TEST_CHECK(match.tags == 0);
+
+  // an empty pattern matches nothing.
+  const CommentFilter empty{{Tag(L"", 1)}, false};
+  NCSTREAMER_REMOTE_TEST_CHECK(Scan(empty, "anything").tags == 0);
+}
+
+
+void TestOverlappingPatterns() {
+  const CommentFilter filter{{
+      Tag(L"he", 1 << 0),
+      Tag(L"she", 1 << 1),
+      Tag(L"his", 1 << 2),
+      Tag(L"hers", 1 << 3)}, false};
+
+  // "she", "he" and "hers" overlap in "ushers", and "his" isn't there.
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      Scan(filter, "ushers").tags == ((1 << 0) | (1 << 1) | (1 << 3)));
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      Scan(filter, "this").tags == (1 << 2));
+  NCSTREAMER_REMOTE_TEST_CHECK(Scan(filter, "h e s").tags == 0);
+
+  // the same pattern twice has both tags.
+  const CommentFilter twice{{Tag(L"gg", 1 << 0), Tag(L"gg", 1 << 4)}, false};
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      Scan(twice, "ggwp").tags == ((1 << 0) | (1 << 4)));
+}
+
+
+void TestFailureLinkOutputs() {
+  const CommentFilter filter{{
+      Tag(L"abcd", 1 << 0),
+      Tag(L"bc", 1 << 1),
+      Tag(L"c", 1 << 2)}, false};
+
+  // deep in "abcd", the state for "abc" reports "bc" and "c"
+  // through its failure links, though "abcd" never completes.
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      Scan(filter, "abcx").tags == ((1 << 1) | (1 << 2)));
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      Scan(filter, "abcd").tags == ((1 << 0) | (1 << 1) | (1 << 2)));
+  // a mismatch falls back to "bc" and goes on from there.
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      Scan(filter, "abbcd").tags == ((1 << 1) | (1 << 2)));
+}
+
+
+void TestDropAndTags() {
+  const CommentFilter filter{{
+      CommentFilterRule{L"spam", true, 1 << 5},
+      Tag(L"sp", 1 << 0),
+      Tag(L"hello", 1 << 1)}, false};
+
+  // a drop rule adds no tags of its own.
+  const CommentFilter::Match &dropped = Scan(filter, "spam");
+  NCSTREAMER_REMOTE_TEST_CHECK(dropped.drop == true);
+  NCSTREAMER_REMOTE_TEST_CHECK(dropped.tags == (1 << 0));
+
+  // the tags of the rest are still told, and the decoder drops first.
+  const CommentFilter::Match &both = Scan(filter, "hello spam");
+  NCSTREAMER_REMOTE_TEST_CHECK(both.drop == true);
+  NCSTREAMER_REMOTE_TEST_CHECK(both.tags == ((1 << 0) | (1 << 1)));
+
+  const CommentFilter::Match &kept = Scan(filter, "hello spa");
+  NCSTREAMER_REMOTE_TEST_CHECK(kept.drop == false);
+  NCSTREAMER_REMOTE_TEST_CHECK(kept.tags == ((1 << 0) | (1 << 1)));
+
+  // a pattern both dropped and tagged is dropped.
+  const CommentFilter same{{Tag(L"ad", 1 << 0), Drop(L"ad")}, false};
+  NCSTREAMER_REMOTE_TEST_CHECK(Scan(same, "an ad").drop == true);
+}
+
+
+void TestCaseFolding() {
+  const std::vector<CommentFilterRule> rules{Tag(L"HeLLo", 1 << 0)};
+  const CommentFilter exact{rules, false};
+  NCSTREAMER_REMOTE_TEST_CHECK(Scan(exact, "HeLLo there").tags == (1 << 0));
+  NCSTREAMER_REMOTE_TEST_CHECK(Scan(exact, "hello there").tags == 0);
+
+  const CommentFilter folded{rules, true};
+  NCSTREAMER_REMOTE_TEST_CHECK(Scan(folded, "hello there").tags == (1 << 0));
+  NCSTREAMER_REMOTE_TEST_CHECK(Scan(folded, "HELLO THERE").tags == (1 << 0));
+  NCSTREAMER_REMOTE_TEST_CHECK(Scan(folded, "hellp").tags == 0);
+
+  // only ASCII letters fold: E with an acute accent stays apart.
+  const CommentFilter accented{{Tag(L"caf\u00C9", 1 << 1)}, true};
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      Scan(accented, "CAF\xC3\x89").tags == (1 << 1));
+  NCSTREAMER_REMOTE_TEST_CHECK(Scan(accented, "caf\xC3\xA9").tags == 0);
+}
+
+
+void TestMultibyteUtf8() {
+  // "annyeong" in Hangul, of three bytes a syllable.
+  const CommentFilter filter{{
+      Tag(L"\uC548\uB155", 1 << 0),
+      Drop(L"\uC2A4\uD338")}, true};
+
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      Scan(filter, "hi \xEC\x95\x88\xEB\x85\x95!").tags == (1 << 0));
+  // a syllable sharing the first two bytes doesn't match.
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      Scan(filter, "\xEC\x95\x94\xEB\x85\x95").tags == 0);
+  // nor the bytes split across other characters.
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      Scan(filter, "\xEC\x95 \x88\xEB\x85\x95").tags == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      Scan(filter, "\xEC\x8A\xA4\xED\x8C\xB8").drop == true);
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_test {
+void TestCommentFilter() {
+  TestNoRules();
+  TestOverlappingPatterns();
+  TestFailureLinkOutputs();
+  TestDropAndTags();
+  TestCaseFolding();
+  TestMultibyteUtf8();
+}
+}  // namespace ncstreamer_remote_test
@@ -0,0 +1,170 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <chrono>  // NOLINT
+#include <future>  // NOLINT
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/ncstreamer_remote.h"
+#include "ncstreamer_remote_test/src/stand_in_server.h"
+#include "ncstreamer_remote_test/src/test_check.h"
+#include "ncstreamer_remote_test/src/test_memory_resource.h"
+#include "ncstreamer_remote_test/src/test_suites.h"
+
+
+namespace {
+using ncstreamer_remote::CommentRecords;
+using ncstreamer_remote::CommentsQuery;
+using ncstreamer_remote::ErrorCategory;
+using ncstreamer_remote::NcStreamerRemote;
+using ncstreamer_remote_test::StandInComment;
+using ncstreamer_remote_test::StandInServer;
+using ncstreamer_remote_test::TestMemoryResource;
+
+
+const uint16_t kStandInPort{9104};
+const std::chrono::seconds kTimeout{5};
+
+
+/// Copied out of the records, which live only during the handler.
+struct ReceivedComment {
+  std::wstring id;
+  std::wstring author;
+  std::wstring text;
+  std::wstring created_time;
+};
+
+
+/// @return Empty on an error or without a response in time.
+std::vector<ReceivedComment> RequestComments(
+    NcStreamerRemote *remote,
+    const CommentsQuery &query) {
+  using Received = std::vector<ReceivedComment>;
+  auto received = std::make_shared<std::promise<Received>>();
+  remote->RequestCommentRecords(L"", query, [received](
+      ErrorCategory /*err_category*/,
+      int /*err_code*/,
+      const std::wstring &/*err_msg*/) {
+    received->set_value(Received{});
+  }, [received](const CommentRecords &comments) {
+    Received copied;
+    for (const auto &comment : comments) {
+      copied.emplace_back(ReceivedComment{
+          comment.id, comment.author, comment.text, comment.created_time});
+    }
+    received->set_value(copied);
+  });
+
+  auto future = received->get_future();
+  if (future.wait_for(kTimeout) != std::future_status::ready) {
+    return Received{};
+  }
+  return future.get();
+}
+
+
+void AddComments(StandInServer *server) {
+  const char *const authors[] = {"alice", "bob", "alice", "carol", "bob"};
+  const char *const messages[] = {
+      "gg", "nice shot", "what a shot", "hello", "gg wp"};
+  for (int i = 0; i < 5; ++i) {
+    const std::string &number = std::to_string(i);
+    server->AddComment(StandInComment{
+        "comment-" + number,
+        authors[i],
+        messages[i],
+        "2017-06-01T12:00:0" + number + "+0000"});
+  }
+}
+
+
+void TestNotNarrowed(NcStreamerRemote *remote) {
+  const auto &comments = RequestComments(remote, CommentsQuery{});
+  NCSTREAMER_REMOTE_TEST_CHECK(comments.size() == 5);
+}
+
+
+void TestMaxCount(NcStreamerRemote *remote) {
+  CommentsQuery query;
+  query.max_count = 2;
+  const auto &comments = RequestComments(remote, query);
+  NCSTREAMER_REMOTE_TEST_CHECK(comments.size() == 2);
+  if (comments.size() == 2) {
+    NCSTREAMER_REMOTE_TEST_CHECK(comments[0].id == L"comment-0");
+    NCSTREAMER_REMOTE_TEST_CHECK(comments[1].id == L"comment-1");
+  }
+}
+
+
+void TestFields(NcStreamerRemote *remote, StandInServer *server) {
+  const uint64_t all_fields_begun = server->bytes_sent();
+  RequestComments(remote, CommentsQuery{});
+  const uint64_t all_fields_bytes = server->bytes_sent() - all_fields_begun;
+
+  CommentsQuery query;
+  query.fields = CommentsQuery::kId | CommentsQuery::kCreatedTime;
+  const uint64_t projected_begun = server->bytes_sent();
+  const auto &comments = RequestComments(remote, query);
+  const uint64_t projected_bytes = server->bytes_sent() - projected_begun;
+
+  NCSTREAMER_REMOTE_TEST_CHECK(comments.size() == 5);
+  for (const auto &comment : comments) {
+    NCSTREAMER_REMOTE_TEST_CHECK(comment.id.empty() == false);
+    NCSTREAMER_REMOTE_TEST_CHECK(comment.created_time.empty() == false);
+    NCSTREAMER_REMOTE_TEST_CHECK(comment.author.empty() == true);
+    NCSTREAMER_REMOTE_TEST_CHECK(comment.text.empty() == true);
+  }
+  NCSTREAMER_REMOTE_TEST_CHECK(projected_bytes < all_fields_bytes);
+}
+
+
+void TestAuthor(NcStreamerRemote *remote) {
+  CommentsQuery query;
+  query.author = L"alice";
+  const auto &comments = RequestComments(remote, query);
+  NCSTREAMER_REMOTE_TEST_CHECK(comments.size() == 2);
+  for (const auto &comment : comments) {
+    NCSTREAMER_REMOTE_TEST_CHECK(comment.author == L"alice");
+  }
+}
+
+
+void TestKeyword(NcStreamerRemote *remote) {
+  CommentsQuery query;
+  query.keyword = L"shot";
+  query.max_count = 1;
+  const auto &comments = RequestComments(remote, query);
+  NCSTREAMER_REMOTE_TEST_CHECK(comments.size() == 1);
+  if (comments.size() == 1) {
+    NCSTREAMER_REMOTE_TEST_CHECK(comments[0].text == L"nice shot");
+  }
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_test {
+void TestCommentsQuery() {
+  StandInServer server{kStandInPort};
+  NCSTREAMER_REMOTE_TEST_CHECK(server.is_listening() == true);
+  if (server.is_listening() == false) {
+    return;
+  }
+  AddComments(&server);
+
+  TestMemoryResource memory_resource;
+  NcStreamerRemote *remote = NcStreamerRemote::Create(
+      kStandInPort, &memory_resource, nullptr, "");
+
+  TestNotNarrowed(remote);
+  TestMaxCount(remote);
+  TestFields(remote, &server);
+  TestAuthor(remote);
+  TestKeyword(remote);
+
+  NcStreamerRemote::Destroy(remote);
+}
+}  // namespace ncstreamer_remote_test
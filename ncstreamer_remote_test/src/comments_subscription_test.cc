@@ -0,0 +1,171 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <future>  // NOLINT
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/ncstreamer_remote.h"
+#include "ncstreamer_remote_test/src/stand_in_server.h"
+#include "ncstreamer_remote_test/src/test_check.h"
+#include "ncstreamer_remote_test/src/test_memory_resource.h"
+#include "ncstreamer_remote_test/src/test_suites.h"
+
+
+namespace {
+using ncstreamer_remote::CommentRecords;
+using ncstreamer_remote::ErrorCategory;
+using ncstreamer_remote::NcStreamerRemote;
+using ncstreamer_remote_test::StandInComment;
+using ncstreamer_remote_test::StandInServer;
+using ncstreamer_remote_test::TestMemoryResource;
+
+
+const uint16_t kStandInPort{9103};
+const std::chrono::seconds kTimeout{5};
+
+
+/// The comments pushed to a client, waited on from the test thread.
+class PushedComments {
+ public:
+  PushedComments()
+      : mutex_{},
+        arrived_{},
+        ids_{} {}
+
+  void Add(const CommentRecords &comments) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (const auto &comment : comments) {
+      ids_.emplace_back(comment.id);
+    }
+    arrived_.notify_all();
+  }
+
+  bool WaitFor(std::size_t count) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    return arrived_.wait_for(lock, kTimeout, [this, count]() {
+      return ids_.size() >= count;
+    });
+  }
+
+  std::vector<std::wstring> ids() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return ids_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable arrived_;
+  std::vector<std::wstring> ids_;
+};
+
+
+/// @return False on an error or without a response in time.
+template <typename RequestFn>
+bool WaitForSuccess(RequestFn request) {
+  auto succeeded = std::make_shared<std::promise<bool>>();
+  request([succeeded](ErrorCategory /*err_category*/,
+                      int /*err_code*/,
+                      const std::wstring &/*err_msg*/) {
+    succeeded->set_value(false);
+  }, [succeeded](bool success) {
+    succeeded->set_value(success);
+  });
+  auto future = succeeded->get_future();
+  return future.wait_for(kTimeout) == std::future_status::ready &&
+         future.get() == true;
+}
+
+
+StandInComment NewComment(int index) {
+  const std::string &number = std::to_string(index);
+  return StandInComment{
+      "comment-" + number,
+      "viewer",
+      "hello " + number,
+      "2017-06-01T12:00:0" + number + "+0000"};
+}
+
+
+void TestPushedInOrder(
+    NcStreamerRemote *remote,
+    StandInServer *server,
+    PushedComments *pushed) {
+  server->AddComment(NewComment(1));
+
+  NCSTREAMER_REMOTE_TEST_CHECK(WaitForSuccess([remote](
+      NcStreamerRemote::ErrorHandler error_handler,
+      NcStreamerRemote::SuccessHandler response_handler) {
+    remote->RequestCommentsSubscribe(L"", error_handler, response_handler);
+  }));
+  // the backlog comes first, as one event.
+  NCSTREAMER_REMOTE_TEST_CHECK(pushed->WaitFor(1));
+  NCSTREAMER_REMOTE_TEST_CHECK(server->subscriptions() == 1);
+
+  server->AddComment(NewComment(2));
+  server->AddComment(NewComment(3));
+  NCSTREAMER_REMOTE_TEST_CHECK(pushed->WaitFor(3));
+
+  const std::vector<std::wstring> &ids = pushed->ids();
+  NCSTREAMER_REMOTE_TEST_CHECK(ids.size() == 3);
+  if (ids.size() == 3) {
+    NCSTREAMER_REMOTE_TEST_CHECK(ids[0] == L"comment-1");
+    NCSTREAMER_REMOTE_TEST_CHECK(ids[1] == L"comment-2");
+    NCSTREAMER_REMOTE_TEST_CHECK(ids[2] == L"comment-3");
+  }
+  // each comment once, and no polls.
+  NCSTREAMER_REMOTE_TEST_CHECK(server->comments_sent() == 3);
+  NCSTREAMER_REMOTE_TEST_CHECK(server->comments_requests() == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(remote->GetCommentsCursor() ==
+                               L"2017-06-01T12:00:03+0000");
+}
+
+
+void TestNothingAfterUnsubscribe(
+    NcStreamerRemote *remote,
+    StandInServer *server,
+    PushedComments *pushed) {
+  NCSTREAMER_REMOTE_TEST_CHECK(WaitForSuccess([remote](
+      NcStreamerRemote::ErrorHandler error_handler,
+      NcStreamerRemote::SuccessHandler response_handler) {
+    remote->RequestCommentsUnsubscribe(error_handler, response_handler);
+  }));
+  NCSTREAMER_REMOTE_TEST_CHECK(server->subscriptions() == 0);
+
+  const std::size_t before = pushed->ids().size();
+  server->AddComment(NewComment(4));
+  std::this_thread::sleep_for(std::chrono::milliseconds{200});
+  NCSTREAMER_REMOTE_TEST_CHECK(pushed->ids().size() == before);
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_test {
+void TestCommentsSubscription() {
+  StandInServer server{kStandInPort};
+  NCSTREAMER_REMOTE_TEST_CHECK(server.is_listening() == true);
+  if (server.is_listening() == false) {
+    return;
+  }
+
+  TestMemoryResource memory_resource;
+  NcStreamerRemote *remote = NcStreamerRemote::Create(
+      kStandInPort, &memory_resource, nullptr, "");
+  PushedComments pushed;
+  remote->RegisterCommentRecordsEventHandler(
+      [&pushed](const CommentRecords &comments) {
+    pushed.Add(comments);
+  });
+
+  TestPushedInOrder(remote, &server, &pushed);
+  TestNothingAfterUnsubscribe(remote, &server, &pushed);
+
+  NcStreamerRemote::Destroy(remote);
+}
+}  // namespace ncstreamer_remote_test
@@ -0,0 +1,31 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <iostream>
+
+#include "ncstreamer_remote_test/src/test_check.h"
+#include "ncstreamer_remote_test/src/test_suites.h"
+
+
+int main(int /*argc*/, char * /*argv*/[]) {
+  ncstreamer_remote_test::TestReconnectBackoff();
+  ncstreamer_remote_test::TestChatAnalytics();
+  ncstreamer_remote_test::TestCommentFilter();
+  ncstreamer_remote_test::TestViewerSeries();
+  ncstreamer_remote_test::TestPollSchedule();
+  ncstreamer_remote_test::TestRequestMetrics();
+  ncstreamer_remote_test::TestCommentsSubscription();
+  ncstreamer_remote_test::TestCommentsQuery();
+  ncstreamer_remote_test::TestRequestAllocations();
+  ncstreamer_remote_test::TestWireReplay();
+
+  const int failures = ncstreamer_remote_test::GetFailures();
+  if (failures != 0) {
+    std::cerr << failures << " check(s) failed." << std::endl;
+    return 1;
+  }
+  std::cout << "All checks passed." << std::endl;
+  return 0;
+}
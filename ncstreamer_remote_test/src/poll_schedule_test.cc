@@ -0,0 +1,222 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <cstdint>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/poll/poll_schedule.h"
+#include "ncstreamer_remote_test/src/test_check.h"
+#include "ncstreamer_remote_test/src/test_suites.h"
+
+
+namespace {
+using ncstreamer_remote::PollMetrics;
+using ncstreamer_remote::PollPolicy;
+using ncstreamer_remote::PollRateCeiling;
+using ncstreamer_remote::PollSchedule;
+
+
+const PollPolicy kPolicy{1000, 30 * 1000, 2.0};
+const uint64_t kHourMs{60 * 60 * 1000};
+
+
+/// Polls as NcStreamerRemote does on its timer, on a clock advanced
+/// by hand, against a chat active over [active_from_ms, active_to_ms).
+class SimulatedPolling {
+ public:
+  SimulatedPolling(uint64_t active_from_ms, uint64_t active_to_ms)
+      : schedule_{},
+        active_from_ms_{active_from_ms},
+        active_to_ms_{active_to_ms},
+        now_ms_{0} {
+    schedule_.Start(kPolicy);
+  }
+
+  /// @return The polls sent up to `until_ms`.
+  uint64_t RunUntil(uint64_t until_ms) {
+    while (now_ms_ + schedule_.interval_ms() <= until_ms) {
+      now_ms_ += schedule_.interval_ms();
+      schedule_.OnPoll();
+      schedule_.OnResponse(
+          now_ms_ >= active_from_ms_ && now_ms_ < active_to_ms_);
+    }
+    return schedule_.GetMetrics().polls;
+  }
+
+  uint32_t interval_ms() const { return schedule_.interval_ms(); }
+
+ private:
+  PollSchedule schedule_;
+  const uint64_t active_from_ms_;
+  const uint64_t active_to_ms_;
+  uint64_t now_ms_;
+};
+
+
+void TestBackoffWhileIdle() {
+  PollSchedule schedule;
+  NCSTREAMER_REMOTE_TEST_CHECK(schedule.running() == false);
+  NCSTREAMER_REMOTE_TEST_CHECK(schedule.interval_ms() == 0);
+
+  schedule.Start(kPolicy);
+  NCSTREAMER_REMOTE_TEST_CHECK(schedule.interval_ms() == 1000);
+  const uint32_t expected[] = {
+      2000, 4000, 8000, 16000, 30000, 30000};
+  for (const uint32_t interval_ms : expected) {
+    schedule.OnResponse(false);
+    NCSTREAMER_REMOTE_TEST_CHECK(schedule.interval_ms() == interval_ms);
+  }
+}
+
+
+void TestSpeedUpOnActivity() {
+  PollSchedule schedule;
+  schedule.Start(kPolicy);
+  for (int i = 0; i < 10; ++i) {
+    schedule.OnResponse(false);
+  }
+  NCSTREAMER_REMOTE_TEST_CHECK(schedule.interval_ms() == 30000);
+
+  // straight back to the minimum, not stepping down.
+  schedule.OnResponse(true);
+  NCSTREAMER_REMOTE_TEST_CHECK(schedule.interval_ms() == 1000);
+  schedule.OnResponse(true);
+  NCSTREAMER_REMOTE_TEST_CHECK(schedule.interval_ms() == 1000);
+  schedule.OnResponse(false);
+  NCSTREAMER_REMOTE_TEST_CHECK(schedule.interval_ms() == 2000);
+}
+
+
+void TestFractionalBackoff() {
+  PollSchedule schedule;
+  schedule.Start(PollPolicy{1000, 5000, 1.5});
+  const uint32_t expected[] = {1500, 2250, 3375, 5000};
+  for (const uint32_t interval_ms : expected) {
+    schedule.OnResponse(false);
+    NCSTREAMER_REMOTE_TEST_CHECK(schedule.interval_ms() == interval_ms);
+  }
+
+  // no backoff polls at a fixed interval.
+  schedule.Start(PollPolicy{2000, 2000, 1.0});
+  schedule.OnResponse(false);
+  NCSTREAMER_REMOTE_TEST_CHECK(schedule.interval_ms() == 2000);
+}
+
+
+void TestStopAndRestart() {
+  PollSchedule schedule;
+  schedule.Start(kPolicy);
+  schedule.OnResponse(false);
+  schedule.Stop();
+  NCSTREAMER_REMOTE_TEST_CHECK(schedule.running() == false);
+  NCSTREAMER_REMOTE_TEST_CHECK(schedule.interval_ms() == 0);
+
+  // a response arriving after Stop() doesn't bring it back.
+  schedule.OnResponse(true);
+  NCSTREAMER_REMOTE_TEST_CHECK(schedule.interval_ms() == 0);
+
+  schedule.Start(kPolicy);
+  NCSTREAMER_REMOTE_TEST_CHECK(schedule.interval_ms() == 1000);
+}
+
+
+void TestMetrics() {
+  PollSchedule schedule;
+  schedule.Start(kPolicy);
+  schedule.OnPoll();
+  schedule.OnPoll();
+  schedule.OnSkip();
+  schedule.SetPaused(true);
+
+  const PollMetrics &metrics = schedule.GetMetrics();
+  NCSTREAMER_REMOTE_TEST_CHECK(metrics.interval_ms == 1000);
+  NCSTREAMER_REMOTE_TEST_CHECK(metrics.polls == 2);
+  NCSTREAMER_REMOTE_TEST_CHECK(metrics.skips == 1);
+  NCSTREAMER_REMOTE_TEST_CHECK(metrics.paused == true);
+}
+
+
+void TestIdleHour() {
+  // polling every second took 3600 polls an hour.
+  SimulatedPolling polling{kHourMs, kHourMs};
+  const uint64_t polls = polling.RunUntil(kHourMs);
+  NCSTREAMER_REMOTE_TEST_CHECK(polls < 200);
+  NCSTREAMER_REMOTE_TEST_CHECK(polls >= kHourMs / kPolicy.max_interval_ms);
+  NCSTREAMER_REMOTE_TEST_CHECK(polling.interval_ms() == 30000);
+}
+
+
+void TestChatPickingUp() {
+  // idle for 10 minutes, then chatting for 5.
+  const uint64_t active_from_ms{10 * 60 * 1000};
+  SimulatedPolling polling{active_from_ms, active_from_ms + 5 * 60 * 1000};
+  const uint64_t idle_polls = polling.RunUntil(active_from_ms);
+  NCSTREAMER_REMOTE_TEST_CHECK(polling.interval_ms() == 30000);
+
+  // noticed within one long interval, then polled at the minimum.
+  const uint64_t polls = polling.RunUntil(
+      active_from_ms + kPolicy.max_interval_ms);
+  NCSTREAMER_REMOTE_TEST_CHECK(polls > idle_polls);
+  NCSTREAMER_REMOTE_TEST_CHECK(polling.interval_ms() == 1000);
+
+  // a poll a second for the rest of the 5 minutes.
+  const uint64_t active_polls =
+      polling.RunUntil(active_from_ms + 5 * 60 * 1000) - polls;
+  NCSTREAMER_REMOTE_TEST_CHECK(active_polls >= 5 * 60 - 30 - 1);
+  NCSTREAMER_REMOTE_TEST_CHECK(active_polls <= 5 * 60 - 30);
+}
+
+
+void TestRateCeiling() {
+  PollRateCeiling unlimited;
+  for (int i = 0; i < 100; ++i) {
+    NCSTREAMER_REMOTE_TEST_CHECK(unlimited.TryAcquire(1000) == true);
+  }
+
+  PollRateCeiling ceiling;
+  ceiling.Set(2.0);
+  // a burst of the rate, then one per half a second.
+  const uint64_t start_ms{kHourMs};
+  NCSTREAMER_REMOTE_TEST_CHECK(ceiling.TryAcquire(start_ms) == true);
+  NCSTREAMER_REMOTE_TEST_CHECK(ceiling.TryAcquire(start_ms) == true);
+  NCSTREAMER_REMOTE_TEST_CHECK(ceiling.TryAcquire(start_ms) == false);
+  NCSTREAMER_REMOTE_TEST_CHECK(ceiling.TryAcquire(start_ms + 400) == false);
+  NCSTREAMER_REMOTE_TEST_CHECK(ceiling.TryAcquire(start_ms + 500) == true);
+  NCSTREAMER_REMOTE_TEST_CHECK(ceiling.TryAcquire(start_ms + 500) == false);
+
+  // tokens don't pile up beyond the burst while idle.
+  const uint64_t later_ms{start_ms + kHourMs};
+  NCSTREAMER_REMOTE_TEST_CHECK(ceiling.TryAcquire(later_ms) == true);
+  NCSTREAMER_REMOTE_TEST_CHECK(ceiling.TryAcquire(later_ms) == true);
+  NCSTREAMER_REMOTE_TEST_CHECK(ceiling.TryAcquire(later_ms) == false);
+
+  // every 100 ms for 10 seconds, the burst and the rate get through.
+  ceiling.Set(4.0);
+  uint32_t acquired{0};
+  for (uint64_t ms = 0; ms < 10 * 1000; ms += 100) {
+    acquired += ceiling.TryAcquire(later_ms + ms) ? 1 : 0;
+  }
+  NCSTREAMER_REMOTE_TEST_CHECK(acquired >= 4 + 4 * 10 - 1);
+  NCSTREAMER_REMOTE_TEST_CHECK(acquired <= 4 + 4 * 10);
+
+  // and 0 lifts the ceiling.
+  ceiling.Set(0.0);
+  NCSTREAMER_REMOTE_TEST_CHECK(ceiling.TryAcquire(later_ms) == true);
+  NCSTREAMER_REMOTE_TEST_CHECK(ceiling.TryAcquire(later_ms) == true);
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_test {
+void TestPollSchedule() {
+  TestBackoffWhileIdle();
+  TestSpeedUpOnActivity();
+  TestFractionalBackoff();
+  TestStopAndRestart();
+  TestMetrics();
+  TestIdleHour();
+  TestChatPickingUp();
+  TestRateCeiling();
+}
+}  // namespace ncstreamer_remote_test
@@ -0,0 +1,215 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <cstdint>
+#include <limits>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/connect/reconnect_backoff.h"
+#include "ncstreamer_remote_test/src/test_check.h"
+#include "ncstreamer_remote_test/src/test_suites.h"
+
+
+namespace {
+using ncstreamer_remote::ReconnectBackoff;
+using ncstreamer_remote::ReconnectPolicy;
+
+
+const ReconnectPolicy kPolicy{500, 2.0, 30 * 1000, 0.2};
+const ReconnectPolicy kNoJitterPolicy{500, 2.0, 30 * 1000, 0.0};
+const uint32_t kSeed{42};
+const uint64_t kHourMs{60 * 60 * 1000};
+
+
+/// Drives the backoff as NcStreamerRemote does on its timer,
+/// on a clock advanced by hand instead of waited on.
+class SimulatedReconnection {
+ public:
+  SimulatedReconnection(
+      const ReconnectPolicy &policy,
+      uint64_t server_up_ms)
+      : backoff_{policy, kSeed},
+        server_up_ms_{server_up_ms},
+        now_ms_{0},
+        next_attempt_ms_{0},
+        attempts_{0},
+        connected_ms_{0} {}
+
+  /// Runs up to `until_ms`, or until connected.
+  void RunUntil(uint64_t until_ms) {
+    while (connected_ms_ == 0 && next_attempt_ms_ <= until_ms) {
+      now_ms_ = next_attempt_ms_;
+      Attempt();
+    }
+    if (connected_ms_ == 0) {
+      now_ms_ = until_ms;
+    }
+  }
+
+  /// As the server watcher fires on NCStreamer showing up.
+  void OnNcStreamerAppeared() {
+    if (connected_ms_ != 0) {
+      return;
+    }
+    backoff_.Reset();
+    Attempt();
+  }
+
+  uint32_t attempts() const { return attempts_; }
+  uint64_t connected_ms() const { return connected_ms_; }
+
+ private:
+  void Attempt() {
+    ++attempts_;
+    if (now_ms_ >= server_up_ms_) {
+      connected_ms_ = now_ms_;
+      backoff_.Reset();
+      return;
+    }
+    next_attempt_ms_ = now_ms_ + backoff_.NextDelayMs();
+  }
+
+  ReconnectBackoff backoff_;
+  const uint64_t server_up_ms_;
+  uint64_t now_ms_;
+  uint64_t next_attempt_ms_;
+  uint32_t attempts_;
+  uint64_t connected_ms_;
+};
+
+
+void TestGrowthWithoutJitter() {
+  ReconnectBackoff backoff{kNoJitterPolicy, kSeed};
+  const uint32_t expected[] = {
+      500, 1000, 2000, 4000, 8000, 16000, 30000, 30000};
+  for (const uint32_t delay_ms : expected) {
+    NCSTREAMER_REMOTE_TEST_CHECK(backoff.NextDelayMs() == delay_ms);
+  }
+  NCSTREAMER_REMOTE_TEST_CHECK(backoff.attempts() == 8);
+}
+
+
+void TestJitterBounds() {
+  ReconnectBackoff backoff{kPolicy, kSeed};
+  uint32_t base_ms{kPolicy.initial_delay_ms};
+  bool jittered{false};
+  for (int i = 0; i < 100; ++i) {
+    const uint32_t delay_ms = backoff.NextDelayMs();
+    NCSTREAMER_REMOTE_TEST_CHECK(delay_ms <= base_ms);
+    const double floor_ms = base_ms * (1.0 - kPolicy.jitter);
+    NCSTREAMER_REMOTE_TEST_CHECK(delay_ms + 1 >= floor_ms);
+    jittered = jittered || (delay_ms != base_ms);
+
+    base_ms = (base_ms * 2 < kPolicy.max_delay_ms) ?
+        base_ms * 2 : kPolicy.max_delay_ms;
+  }
+  NCSTREAMER_REMOTE_TEST_CHECK(jittered == true);
+}
+
+
+void TestSeedReproduces() {
+  ReconnectBackoff first{kPolicy, kSeed};
+  ReconnectBackoff second{kPolicy, kSeed};
+  for (int i = 0; i < 20; ++i) {
+    NCSTREAMER_REMOTE_TEST_CHECK(first.NextDelayMs() == second.NextDelayMs());
+  }
+}
+
+
+void TestReset() {
+  ReconnectBackoff backoff{kNoJitterPolicy, kSeed};
+  for (int i = 0; i < 10; ++i) {
+    backoff.NextDelayMs();
+  }
+  backoff.Reset();
+  NCSTREAMER_REMOTE_TEST_CHECK(backoff.attempts() == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      backoff.NextDelayMs() == kNoJitterPolicy.initial_delay_ms);
+}
+
+
+void TestSetPolicyClampsDelay() {
+  ReconnectBackoff backoff{kNoJitterPolicy, kSeed};
+  for (int i = 0; i < 10; ++i) {
+    backoff.NextDelayMs();
+  }
+  const ReconnectPolicy lower_cap{500, 2.0, 5 * 1000, 0.0};
+  backoff.SetPolicy(lower_cap);
+  NCSTREAMER_REMOTE_TEST_CHECK(backoff.NextDelayMs() == lower_cap.max_delay_ms);
+}
+
+
+void TestZeroInitialDelayGrows() {
+  const ReconnectPolicy zero{0, 2.0, 30 * 1000, 0.0};
+  ReconnectBackoff backoff{zero, kSeed};
+  NCSTREAMER_REMOTE_TEST_CHECK(backoff.NextDelayMs() == 1);
+  NCSTREAMER_REMOTE_TEST_CHECK(backoff.NextDelayMs() == 2);
+}
+
+
+void TestHourOfAbsence() {
+  // a retry every second took 3600 attempts an hour.
+  SimulatedReconnection reconnection{
+      kPolicy, std::numeric_limits<uint64_t>::max()};
+  reconnection.RunUntil(kHourMs);
+  NCSTREAMER_REMOTE_TEST_CHECK(reconnection.connected_ms() == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(reconnection.attempts() < 200);
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      reconnection.attempts() >= kHourMs / kPolicy.max_delay_ms);
+}
+
+
+void TestServerUpWithoutSignal() {
+  const uint64_t server_up_ms{10 * 60 * 1000};
+  SimulatedReconnection reconnection{kPolicy, server_up_ms};
+  reconnection.RunUntil(kHourMs);
+  NCSTREAMER_REMOTE_TEST_CHECK(reconnection.connected_ms() >= server_up_ms);
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      reconnection.connected_ms() <= server_up_ms + kPolicy.max_delay_ms);
+}
+
+
+void TestServerUpWithSignal() {
+  const uint64_t server_up_ms{10 * 60 * 1000};
+  SimulatedReconnection reconnection{kPolicy, server_up_ms};
+  reconnection.RunUntil(server_up_ms);
+  const uint32_t attempts = reconnection.attempts();
+  if (reconnection.connected_ms() == 0) {
+    reconnection.OnNcStreamerAppeared();
+  }
+  NCSTREAMER_REMOTE_TEST_CHECK(reconnection.connected_ms() == server_up_ms);
+  NCSTREAMER_REMOTE_TEST_CHECK(reconnection.attempts() <= attempts + 1);
+}
+
+
+void TestServerListeningLate() {
+  // the window shows up before the server listens.
+  const uint64_t appeared_ms{10 * 60 * 1000};
+  const uint64_t server_up_ms{appeared_ms + 700};
+  SimulatedReconnection reconnection{kPolicy, server_up_ms};
+  reconnection.RunUntil(appeared_ms);
+  reconnection.OnNcStreamerAppeared();
+  NCSTREAMER_REMOTE_TEST_CHECK(reconnection.connected_ms() == 0);
+  reconnection.RunUntil(kHourMs);
+  // back from the initial delay, not from the cap.
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      reconnection.connected_ms() <= server_up_ms + 2 * 1000);
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_test {
+void TestReconnectBackoff() {
+  TestGrowthWithoutJitter();
+  TestJitterBounds();
+  TestSeedReproduces();
+  TestReset();
+  TestSetPolicyClampsDelay();
+  TestZeroInitialDelayGrows();
+  TestHourOfAbsence();
+  TestServerUpWithoutSignal();
+  TestServerUpWithSignal();
+  TestServerListeningLate();
+}
+}  // namespace ncstreamer_remote_test
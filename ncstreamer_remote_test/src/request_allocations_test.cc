@@ -0,0 +1,290 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <functional>
+#include <future>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/ncstreamer_remote.h"
+#include "ncstreamer_remote_test/src/stand_in_server.h"
+#include "ncstreamer_remote_test/src/test_check.h"
+#include "ncstreamer_remote_test/src/test_memory_resource.h"
+#include "ncstreamer_remote_test/src/test_suites.h"
+
+
+namespace {
+using ncstreamer_remote::CommentsQuery;
+using ncstreamer_remote::ErrorCategory;
+using ncstreamer_remote::NcStreamerRemote;
+using ncstreamer_remote_test::StandInComment;
+using ncstreamer_remote_test::StandInServer;
+using ncstreamer_remote_test::TestMemoryResource;
+
+template <typename Handler>
+using Inplace = NcStreamerRemote::Inplace<Handler>;
+using Responded = std::shared_ptr<std::promise<bool>>;
+
+
+const uint16_t kStandInPort{9111};
+const std::chrono::seconds kTimeout{5};
+/// Of each path before counting, for the message pool to fill up
+/// and the inbound arena to grow to the responses.
+const int kWarmUpRequests{5};
+const int kCountedRequests{20};
+
+
+/// Of any response handler, telling the response came.
+struct SetResponded {
+  template <typename... Args>
+  void operator()(Args &&... /*args*/) const {
+    responded->set_value(true);
+  }
+
+  Responded responded;
+};
+
+
+Inplace<NcStreamerRemote::ErrorHandler> OnError(const Responded &responded) {
+  return Inplace<NcStreamerRemote::ErrorHandler>{[responded](
+      ErrorCategory /*err_category*/,
+      int /*err_code*/,
+      const std::wstring &/*err_msg*/) {
+    responded->set_value(false);
+  }};
+}
+
+
+/// A request of the library, through the overload taking inline handlers,
+/// so that the caller allocates nothing for the handlers either.
+struct RequestPath {
+  const char *name;
+  std::function<void(NcStreamerRemote *remote, const Responded &responded)>
+      request;
+};
+
+
+std::vector<RequestPath> NewRequestPaths() {
+  using Remote = NcStreamerRemote;
+  return std::vector<RequestPath>{
+      {"status", [](Remote *remote, const Responded &responded) {
+        remote->RequestStatus(
+            OnError(responded),
+            Inplace<Remote::StatusResponseHandler>{
+                SetResponded{responded}});
+      }},
+      {"cached status", [](Remote *remote, const Responded &responded) {
+        remote->RequestCachedStatus(
+            OnError(responded),
+            Inplace<Remote::StatusResponseHandler>{
+                SetResponded{responded}});
+      }},
+      {"start", [](Remote *remote, const Responded &responded) {
+        remote->RequestStart(
+            L"title",
+            OnError(responded),
+            Inplace<Remote::StartResponseHandler>{SetResponded{responded}});
+      }},
+      {"stop", [](Remote *remote, const Responded &responded) {
+        remote->RequestStop(
+            L"title",
+            OnError(responded),
+            Inplace<Remote::StopResponseHandler>{SetResponded{responded}});
+      }},
+      {"quality update", [](Remote *remote, const Responded &responded) {
+        remote->RequestQualityUpdate(
+            L"high",
+            OnError(responded),
+            Inplace<Remote::SuccessHandler>{SetResponded{responded}});
+      }},
+      {"comments", [](Remote *remote, const Responded &responded) {
+        remote->RequstComments(
+            L"",
+            OnError(responded),
+            Inplace<Remote::CommentsResponseHandler>{
+                SetResponded{responded}});
+      }},
+      {"comment records", [](Remote *remote, const Responded &responded) {
+        CommentsQuery query;
+        query.max_count = 3;
+        remote->RequestCommentRecords(
+            L"",
+            query,
+            OnError(responded),
+            Inplace<Remote::CommentRecordsHandler>{
+                SetResponded{responded}});
+      }},
+      {"comments subscribe", [](Remote *remote, const Responded &responded) {
+        remote->RequestCommentsSubscribe(
+            L"",
+            OnError(responded),
+            Inplace<Remote::SuccessHandler>{SetResponded{responded}});
+      }},
+      {"comments unsubscribe", [](
+          Remote *remote, const Responded &responded) {
+        remote->RequestCommentsUnsubscribe(
+            OnError(responded),
+            Inplace<Remote::SuccessHandler>{SetResponded{responded}});
+      }},
+      {"viewers", [](Remote *remote, const Responded &responded) {
+        remote->RequestViewers(
+            OnError(responded),
+            Inplace<Remote::ViewersResponseHandler>{
+                SetResponded{responded}});
+      }},
+      {"webcam search", [](Remote *remote, const Responded &responded) {
+        remote->RequestWebcamSearch(
+            OnError(responded),
+            Inplace<Remote::WebcamSearchResponseHandler>{
+                SetResponded{responded}});
+      }},
+      {"webcam on", [](Remote *remote, const Responded &responded) {
+        remote->RequestWebcamOn(
+            L"stand-in-webcam", 0.25f, 0.25f, 0.5f, 0.5f,
+            OnError(responded),
+            Inplace<Remote::WebcamResponseHandler>{SetResponded{responded}});
+      }},
+      {"webcam size", [](Remote *remote, const Responded &responded) {
+        remote->RequestWebcamSize(
+            0.5f, 0.5f,
+            OnError(responded),
+            Inplace<Remote::WebcamResponseHandler>{SetResponded{responded}});
+      }},
+      {"webcam position", [](Remote *remote, const Responded &responded) {
+        remote->RequestWebcamPosition(
+            0.25f, 0.25f,
+            OnError(responded),
+            Inplace<Remote::WebcamResponseHandler>{SetResponded{responded}});
+      }},
+      {"webcam off", [](Remote *remote, const Responded &responded) {
+        remote->RequestWebcamOff(
+            OnError(responded),
+            Inplace<Remote::WebcamResponseHandler>{SetResponded{responded}});
+      }},
+      {"chroma key on", [](Remote *remote, const Responded &responded) {
+        remote->RequestChromaKeyOn(
+            0x00FF00, 50,
+            OnError(responded),
+            Inplace<Remote::ChromaKeyResponseHandler>{
+                SetResponded{responded}});
+      }},
+      {"chroma key color", [](Remote *remote, const Responded &responded) {
+        remote->RequestChromaKeyColor(
+            0x0000FF,
+            OnError(responded),
+            Inplace<Remote::ChromaKeyResponseHandler>{
+                SetResponded{responded}});
+      }},
+      {"chroma key similarity", [](
+          Remote *remote, const Responded &responded) {
+        remote->RequestChromaKeySimilarity(
+            40,
+            OnError(responded),
+            Inplace<Remote::ChromaKeyResponseHandler>{
+                SetResponded{responded}});
+      }},
+      {"chroma key off", [](Remote *remote, const Responded &responded) {
+        remote->RequestChromaKeyOff(
+            OnError(responded),
+            Inplace<Remote::ChromaKeyResponseHandler>{
+                SetResponded{responded}});
+      }},
+      {"mic search", [](Remote *remote, const Responded &responded) {
+        remote->RequestMicSearch(
+            OnError(responded),
+            Inplace<Remote::MicSearchResponseHandler>{
+                SetResponded{responded}});
+      }},
+      {"mic on", [](Remote *remote, const Responded &responded) {
+        remote->RequestMicOn(
+            L"stand-in-mic", 0.5f,
+            OnError(responded),
+            Inplace<Remote::MicResponseHandler>{SetResponded{responded}});
+      }},
+      {"mic off", [](Remote *remote, const Responded &responded) {
+        remote->RequestMicOff(
+            OnError(responded),
+            Inplace<Remote::MicResponseHandler>{SetResponded{responded}});
+      }},
+  };
+}
+
+
+/// @return False on an error or without a response in time.
+bool RunRequest(NcStreamerRemote *remote, const RequestPath &path) {
+  auto responded = std::make_shared<std::promise<bool>>();
+  auto future = responded->get_future();
+  path.request(remote, responded);
+  if (future.wait_for(kTimeout) != std::future_status::ready) {
+    return false;
+  }
+  return future.get();
+}
+
+
+/// Drawing nothing from the resource of the caller in steady state,
+/// nor missing the message pool.
+void TestRequestPath(
+    NcStreamerRemote *remote,
+    const TestMemoryResource &memory_resource,
+    const RequestPath &path) {
+  for (int i = 0; i < kWarmUpRequests; ++i) {
+    RunRequest(remote, path);
+  }
+
+  const uint64_t allocations_begun = memory_resource.allocations();
+  const uint64_t misses_begun = remote->GetMessagePoolStats().misses;
+  int responded{0};
+  for (int i = 0; i < kCountedRequests; ++i) {
+    responded += RunRequest(remote, path) ? 1 : 0;
+  }
+  const uint64_t allocations =
+      memory_resource.allocations() - allocations_begun;
+  const uint64_t misses = remote->GetMessagePoolStats().misses - misses_begun;
+
+  NCSTREAMER_REMOTE_TEST_CHECK(responded == kCountedRequests);
+  NCSTREAMER_REMOTE_TEST_CHECK(allocations == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(misses == 0);
+  if (responded != kCountedRequests || allocations != 0 || misses != 0) {
+    std::cerr << "  of the " << path.name << " request: "
+              << responded << " responded, "
+              << allocations << " allocations, "
+              << misses << " pool misses" << std::endl;
+  }
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_test {
+void TestRequestAllocations() {
+  StandInServer server{kStandInPort};
+  NCSTREAMER_REMOTE_TEST_CHECK(server.is_listening() == true);
+  if (server.is_listening() == false) {
+    return;
+  }
+  for (int i = 0; i < 5; ++i) {
+    const std::string &number = std::to_string(i);
+    server.AddComment(StandInComment{
+        "comment-" + number,
+        "author-" + number,
+        "a comment of some ordinary length, number " + number,
+        "2017-06-01T12:00:0" + number + "+0000"});
+  }
+
+  TestMemoryResource memory_resource;
+  NcStreamerRemote *remote = NcStreamerRemote::Create(
+      kStandInPort, &memory_resource, nullptr, "");
+
+  for (const auto &path : NewRequestPaths()) {
+    TestRequestPath(remote, memory_resource, path);
+  }
+
+  NcStreamerRemote::Destroy(remote);
+}
+}  // namespace ncstreamer_remote_test
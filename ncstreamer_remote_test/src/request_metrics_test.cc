@@ -0,0 +1,285 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/error/error_types.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/metric/latency_histogram.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/metric/request_metrics.h"
+#include "ncstreamer_remote_test/src/test_check.h"
+#include "ncstreamer_remote_test/src/test_suites.h"
+
+
+namespace {
+using ncstreamer_remote::Error;
+using ncstreamer_remote::ErrorCategory;
+using ncstreamer_remote::ErrorCount;
+using ncstreamer_remote::LatencyHistogram;
+using ncstreamer_remote::LatencyStats;
+using ncstreamer_remote::RequestMetrics;
+using ncstreamer_remote::RequestMetricsSnapshot;
+using ncstreamer_remote::RequestTypeMetrics;
+
+
+const int kStatusRequest{101};
+const int kCommentsRequest{107};
+
+
+/// @return The bucket `latency_us` is counted in, by recording it alone.
+std::size_t FindBucket(LatencyHistogram *histogram, uint64_t latency_us) {
+  histogram->Clear();
+  histogram->Record(latency_us);
+  for (std::size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+    if (histogram->GetBucketCount(i) != 0) {
+      return i;
+    }
+  }
+  return LatencyHistogram::kBucketCount;
+}
+
+
+void TestBucketBounds() {
+  // contiguous and growing, up to the largest latency.
+  NCSTREAMER_REMOTE_TEST_CHECK(LatencyHistogram::GetBucketUpperBound(0) == 0);
+  for (std::size_t i = 1; i < LatencyHistogram::kBucketCount; ++i) {
+    const uint64_t lower = LatencyHistogram::GetBucketUpperBound(i - 1) + 1;
+    const uint64_t upper = LatencyHistogram::GetBucketUpperBound(i);
+    NCSTREAMER_REMOTE_TEST_CHECK(upper >= lower);
+    if (i >= 16) {
+      // 4 per power of 2, so no wider than a quarter of the lower bound.
+      NCSTREAMER_REMOTE_TEST_CHECK(upper - lower + 1 <= lower / 4);
+    } else {
+      NCSTREAMER_REMOTE_TEST_CHECK(upper == lower);
+    }
+  }
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      LatencyHistogram::GetBucketUpperBound(
+          LatencyHistogram::kBucketCount - 1) ==
+      std::numeric_limits<uint64_t>::max());
+}
+
+
+void TestLatenciesInTheirBuckets() {
+  std::vector<uint64_t> latencies;
+  for (uint64_t us = 0; us < 2048; ++us) {
+    latencies.emplace_back(us);
+  }
+  for (int shift = 11; shift < 64; ++shift) {
+    const uint64_t power = 1ULL << shift;
+    latencies.emplace_back(power - 1);
+    latencies.emplace_back(power);
+    latencies.emplace_back(power + power / 4 - 1);
+    latencies.emplace_back(power + power / 4);
+  }
+  latencies.emplace_back(std::numeric_limits<uint64_t>::max());
+
+  LatencyHistogram histogram;
+  for (const uint64_t latency_us : latencies) {
+    const std::size_t bucket = FindBucket(&histogram, latency_us);
+    NCSTREAMER_REMOTE_TEST_CHECK(bucket < LatencyHistogram::kBucketCount);
+    if (bucket >= LatencyHistogram::kBucketCount) {
+      continue;
+    }
+    NCSTREAMER_REMOTE_TEST_CHECK(
+        latency_us <= LatencyHistogram::GetBucketUpperBound(bucket));
+    NCSTREAMER_REMOTE_TEST_CHECK(
+        bucket == 0 ||
+        latency_us > LatencyHistogram::GetBucketUpperBound(bucket - 1));
+  }
+}
+
+
+void TestLatencyStats() {
+  LatencyHistogram histogram;
+  const LatencyStats &empty = histogram.GetStats();
+  NCSTREAMER_REMOTE_TEST_CHECK(empty.count == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(empty.min_us == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(empty.p99_us == 0);
+
+  for (uint64_t us = 1; us <= 1000; ++us) {
+    histogram.Record(us);
+  }
+  const LatencyStats &stats = histogram.GetStats();
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.count == 1000);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.min_us == 1);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.max_us == 1000);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.mean_us == 500);
+  // the upper bounds of 448..511 and of 896..1023, capped by the max.
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.p50_us == 511);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.p90_us == 1000);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.p99_us == 1000);
+
+  // a single latency is every percentile.
+  histogram.Clear();
+  histogram.Record(5000);
+  const LatencyStats &single = histogram.GetStats();
+  NCSTREAMER_REMOTE_TEST_CHECK(single.p50_us == 5000);
+  NCSTREAMER_REMOTE_TEST_CHECK(single.p99_us == 5000);
+
+  // the percentiles are within 25% of the exact ones.
+  histogram.Clear();
+  for (uint64_t us = 1; us <= 100000; ++us) {
+    histogram.Record(us * 37);
+  }
+  const LatencyStats &spread = histogram.GetStats();
+  NCSTREAMER_REMOTE_TEST_CHECK(spread.p50_us >= 50000 * 37);
+  NCSTREAMER_REMOTE_TEST_CHECK(spread.p50_us <= 50000 * 37 * 5 / 4);
+  NCSTREAMER_REMOTE_TEST_CHECK(spread.p90_us >= 90000 * 37);
+  NCSTREAMER_REMOTE_TEST_CHECK(spread.p90_us <= 90000 * 37 * 5 / 4);
+}
+
+
+const RequestTypeMetrics *FindType(
+    const RequestMetricsSnapshot &snapshot,
+    int message_type) {
+  for (const auto &metrics : snapshot.requests) {
+    if (metrics.message_type == message_type) {
+      return &metrics;
+    }
+  }
+  return nullptr;
+}
+
+
+void TestRequestCounters() {
+  RequestMetrics metrics{{kStatusRequest, kCommentsRequest}};
+  metrics.OnSent(kStatusRequest, 10);
+  metrics.OnResponded(kStatusRequest, 300, 320);
+  metrics.OnSent(kStatusRequest, 20);
+  metrics.OnResponded(kStatusRequest, 500, 530);
+  metrics.OnSent(kCommentsRequest, 0);
+  // not a type asked for, so not counted.
+  metrics.OnSent(kStatusRequest + 2, 0);
+  metrics.OnSent(-1, 0);
+  metrics.OnParseFailure();
+
+  const RequestMetricsSnapshot &snapshot = metrics.GetSnapshot();
+  NCSTREAMER_REMOTE_TEST_CHECK(snapshot.requests.size() == 2);
+  NCSTREAMER_REMOTE_TEST_CHECK(snapshot.parse_failures == 1);
+
+  const RequestTypeMetrics *status = FindType(snapshot, kStatusRequest);
+  NCSTREAMER_REMOTE_TEST_CHECK(status != nullptr);
+  if (status) {
+    NCSTREAMER_REMOTE_TEST_CHECK(status->requests == 2);
+    NCSTREAMER_REMOTE_TEST_CHECK(status->errors == 0);
+    NCSTREAMER_REMOTE_TEST_CHECK(status->queue_wait.max_us == 20);
+    NCSTREAMER_REMOTE_TEST_CHECK(status->wire_rtt.count == 2);
+    NCSTREAMER_REMOTE_TEST_CHECK(status->wire_rtt.min_us == 300);
+    NCSTREAMER_REMOTE_TEST_CHECK(status->latency.max_us == 530);
+  }
+  const RequestTypeMetrics *comments = FindType(snapshot, kCommentsRequest);
+  NCSTREAMER_REMOTE_TEST_CHECK(comments != nullptr);
+  if (comments) {
+    NCSTREAMER_REMOTE_TEST_CHECK(comments->requests == 1);
+    NCSTREAMER_REMOTE_TEST_CHECK(comments->latency.count == 0);
+  }
+}
+
+
+uint64_t CountError(
+    const RequestMetricsSnapshot &snapshot,
+    int message_type,
+    ErrorCategory category,
+    int code) {
+  for (const ErrorCount &error : snapshot.errors) {
+    if (error.message_type == message_type &&
+        error.category == category &&
+        error.code == code) {
+      return error.count;
+    }
+  }
+  return 0;
+}
+
+
+void TestErrorCounts() {
+  RequestMetrics metrics{{kStatusRequest, kCommentsRequest}};
+  const int busy = static_cast<int>(Error::Connection::kBusy);
+  const int closed = static_cast<int>(Error::Connection::kOnRemoteClose);
+  metrics.OnError(kStatusRequest, ErrorCategory::kConnection, closed);
+  metrics.OnError(kStatusRequest, ErrorCategory::kConnection, closed);
+  metrics.OnError(kCommentsRequest, ErrorCategory::kConnection, closed);
+  metrics.OnError(kCommentsRequest, ErrorCategory::kComments, 101);
+  // rejected busy, before a type was sent.
+  metrics.OnError(0, ErrorCategory::kConnection, busy);
+
+  const RequestMetricsSnapshot &snapshot = metrics.GetSnapshot();
+  NCSTREAMER_REMOTE_TEST_CHECK(snapshot.errors.size() == 4);
+  NCSTREAMER_REMOTE_TEST_CHECK(CountError(
+      snapshot, kStatusRequest, ErrorCategory::kConnection, closed) == 2);
+  NCSTREAMER_REMOTE_TEST_CHECK(CountError(
+      snapshot, kCommentsRequest, ErrorCategory::kConnection, closed) == 1);
+  NCSTREAMER_REMOTE_TEST_CHECK(CountError(
+      snapshot, kCommentsRequest, ErrorCategory::kComments, 101) == 1);
+  NCSTREAMER_REMOTE_TEST_CHECK(CountError(
+      snapshot, 0, ErrorCategory::kConnection, busy) == 1);
+
+  const RequestTypeMetrics *status = FindType(snapshot, kStatusRequest);
+  NCSTREAMER_REMOTE_TEST_CHECK(status != nullptr && status->errors == 2);
+}
+
+
+void TestErrorSlotsFull() {
+  RequestMetrics metrics{{kStatusRequest}};
+  for (int code = 0; code < 300; ++code) {
+    metrics.OnError(kStatusRequest, ErrorCategory::kMisc, code);
+  }
+  // the distinct errors beyond the slots are left out, not looped on.
+  const RequestMetricsSnapshot &snapshot = metrics.GetSnapshot();
+  NCSTREAMER_REMOTE_TEST_CHECK(snapshot.errors.size() == 256);
+  NCSTREAMER_REMOTE_TEST_CHECK(snapshot.requests[0].errors == 300);
+}
+
+
+bool Contains(const std::string &text, const std::string &line) {
+  return text.find(line + "\n") != std::string::npos;
+}
+
+
+void TestOpenMetrics() {
+  RequestMetrics metrics{{kStatusRequest}};
+  metrics.OnSent(kStatusRequest, 3);
+  metrics.OnResponded(kStatusRequest, 400, 511);
+  metrics.OnError(kStatusRequest, ErrorCategory::kConnection, 107);
+
+  const std::string &text = metrics.ToOpenMetrics();
+  NCSTREAMER_REMOTE_TEST_CHECK(Contains(
+      text, "ncstreamer_remote_requests_total{type=\"101\"} 1"));
+  NCSTREAMER_REMOTE_TEST_CHECK(Contains(
+      text, "ncstreamer_remote_request_errors_total"
+            "{type=\"101\",category=\"101\",code=\"107\"} 1"));
+  NCSTREAMER_REMOTE_TEST_CHECK(Contains(
+      text, "ncstreamer_remote_parse_failures_total 0"));
+  NCSTREAMER_REMOTE_TEST_CHECK(Contains(
+      text, "ncstreamer_remote_request_latency_seconds"
+            "{type=\"101\",quantile=\"0.5\"} 0.000511"));
+  NCSTREAMER_REMOTE_TEST_CHECK(Contains(
+      text, "ncstreamer_remote_request_latency_seconds_count"
+            "{type=\"101\"} 1"));
+  NCSTREAMER_REMOTE_TEST_CHECK(Contains(
+      text, "# UNIT ncstreamer_remote_request_wire_rtt_seconds seconds"));
+  const std::string kEof{"# EOF\n"};
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      text.size() >= kEof.size() &&
+      text.compare(text.size() - kEof.size(), kEof.size(), kEof) == 0);
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_test {
+void TestRequestMetrics() {
+  TestBucketBounds();
+  TestLatenciesInTheirBuckets();
+  TestLatencyStats();
+  TestRequestCounters();
+  TestErrorCounts();
+  TestErrorSlotsFull();
+  TestOpenMetrics();
+}
+}  // namespace ncstreamer_remote_test
@@ -0,0 +1,348 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_test/src/stand_in_server.h"
+
+#include <sstream>
+#include <utility>
+
+#include "boost/asio/ip/address_v4.hpp"
+#include "boost/property_tree/json_parser.hpp"
+
+#include "ncstreamer_remote_dll/src/ncstreamer_remote_message_types.h"
+
+
+namespace {
+using MessageType = ncstreamer::RemoteMessage::MessageType;
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_test {
+StandInServer::StandInServer(uint16_t port)
+    : io_service_{},
+      server_{},
+      thread_{},
+      window_{NULL},
+      listening_{false},
+      comments_{},
+      connections_map_{},
+      connections_{0},
+      subscriptions_{0},
+      comments_requests_{0},
+      comments_sent_{0},
+      bytes_sent_{0} {
+  server_.clear_access_channels(websocketpp::log::alevel::all);
+  server_.clear_error_channels(websocketpp::log::elevel::all);
+
+  websocketpp::lib::error_code ec;
+  server_.init_asio(&io_service_, ec);
+  if (ec) {
+    return;
+  }
+  server_.set_reuse_addr(true);
+
+  server_.set_open_handler([this](websocketpp::connection_hdl connection) {
+    connections_map_.emplace(connection, std::string{});
+    ++connections_;
+  });
+  server_.set_close_handler([this](websocketpp::connection_hdl connection) {
+    connections_map_.erase(connection);
+    --connections_;
+  });
+  server_.set_message_handler([this](
+      websocketpp::connection_hdl connection,
+      Server::message_ptr msg) {
+    OnMessage(connection, msg);
+  });
+
+  server_.listen(boost::asio::ip::tcp::endpoint{
+      boost::asio::ip::address_v4::loopback(), port}, ec);
+  if (ec) {
+    return;
+  }
+  server_.start_accept(ec);
+  if (ec) {
+    return;
+  }
+  listening_ = true;
+
+  window_ = ::CreateWindowW(
+      L"STATIC", ncstreamer::kNcStreamerWindowTitle, WS_OVERLAPPED,
+      0, 0, 0, 0, NULL, NULL, ::GetModuleHandle(NULL), NULL);
+
+  thread_ = std::thread{[this]() {
+    io_service_.run();
+  }};
+}
+
+
+StandInServer::~StandInServer() {
+  if (window_ != NULL) {
+    ::DestroyWindow(window_);
+  }
+
+  io_service_.post([this]() {
+    websocketpp::lib::error_code ec;
+    server_.stop_listening(ec);
+    for (const auto &connection : connections_map_) {
+      server_.close(
+          connection.first, websocketpp::close::status::going_away, "", ec);
+    }
+  });
+  if (thread_.joinable() == true) {
+    thread_.join();
+  }
+}
+
+
+void StandInServer::AddComment(const StandInComment &comment) {
+  io_service_.post([this, comment]() {
+    comments_.emplace_back(comment);
+    for (auto &connection : connections_map_) {
+      std::string *cursor = &connection.second;
+      if (cursor->empty() == false) {
+        PushComments(connection.first, cursor);
+      }
+    }
+  });
+}
+
+
+void StandInServer::OnMessage(
+    websocketpp::connection_hdl connection,
+    Server::message_ptr msg) {
+  boost::property_tree::ptree request;
+  std::istringstream ss{msg->get_payload()};
+  int request_type{0};
+  try {
+    boost::property_tree::read_json(ss, request);
+    request_type = request.get<int>("type");
+  } catch (const std::exception &/*e*/) {
+    return;
+  }
+
+  switch (static_cast<MessageType>(request_type)) {
+    case MessageType::kStreamingStatusRequest:
+      OnStatusRequest(connection);
+      break;
+    case MessageType::kStreamingCommentsRequest:
+      OnCommentsRequest(connection, request);
+      break;
+    case MessageType::kStreamingCommentsSubscribeRequest:
+      OnCommentsSubscribeRequest(connection, request);
+      break;
+    case MessageType::kStreamingCommentsUnsubscribeRequest:
+      OnCommentsUnsubscribeRequest(connection);
+      break;
+    case MessageType::kStreamingViewersRequest:
+      OnViewersRequest(connection);
+      break;
+    default:
+      OnOtherRequest(connection, request_type);
+      break;
+  }
+}
+
+
+void StandInServer::OnStatusRequest(
+    websocketpp::connection_hdl connection) {
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(MessageType::kStreamingStatusResponse));
+  tree.put("status", "onAir");
+  tree.put("sourceTitle", "Stand-In");
+  tree.put("userName", "stand-in");
+  tree.put("quality", "high");
+  Send(connection, tree);
+}
+
+
+void StandInServer::OnCommentsRequest(
+    websocketpp::connection_hdl connection,
+    const boost::property_tree::ptree &request) {
+  ++comments_requests_;
+  const std::string &created_time =
+      request.get<std::string>("createdTime", "");
+  const std::size_t max_count = request.get<std::size_t>("maxCount", 0);
+  const std::string &author = request.get<std::string>("author", "");
+  const std::string &keyword = request.get<std::string>("keyword", "");
+
+  std::vector<const StandInComment *> comments;
+  for (const auto &comment : comments_) {
+    if (max_count != 0 && comments.size() == max_count) {
+      break;
+    }
+    if (comment.created_time <= created_time ||
+        (author.empty() == false && comment.author != author) ||
+        (keyword.empty() == false &&
+         comment.message.find(keyword) == std::string::npos)) {
+      continue;
+    }
+    comments.emplace_back(&comment);
+  }
+
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(MessageType::kStreamingCommentsResponse));
+  tree.put("error", "");
+  tree.put("comments", ToCommentsMessage(
+      comments, request.get<std::string>("fields", "")));
+  Send(connection, tree);
+}
+
+
+void StandInServer::OnCommentsSubscribeRequest(
+    websocketpp::connection_hdl connection,
+    const boost::property_tree::ptree &request) {
+  auto i = connections_map_.find(connection);
+  if (i == connections_map_.end()) {
+    return;
+  }
+  std::string *cursor = &i->second;
+  if (cursor->empty() == true) {
+    ++subscriptions_;
+  }
+  // a cursor of a space, below any time, for everything.
+  *cursor = request.get<std::string>("createdTime", "");
+  if (cursor->empty() == true) {
+    *cursor = " ";
+  }
+
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      MessageType::kStreamingCommentsSubscribeResponse));
+  tree.put("error", "");
+  Send(connection, tree);
+
+  PushComments(connection, cursor);
+}
+
+
+void StandInServer::OnCommentsUnsubscribeRequest(
+    websocketpp::connection_hdl connection) {
+  auto i = connections_map_.find(connection);
+  if (i != connections_map_.end() && i->second.empty() == false) {
+    i->second.clear();
+    --subscriptions_;
+  }
+
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(
+      MessageType::kStreamingCommentsUnsubscribeResponse));
+  tree.put("error", "");
+  Send(connection, tree);
+}
+
+
+void StandInServer::OnViewersRequest(
+    websocketpp::connection_hdl connection) {
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(MessageType::kStreamingViewersResponse));
+  tree.put("error", "");
+  tree.put("viewers", std::to_string(comments_.size()));
+  Send(connection, tree);
+}
+
+
+void StandInServer::OnOtherRequest(
+    websocketpp::connection_hdl connection,
+    int request_type) {
+  // every other request succeeds, answered by the type next to it.
+  boost::property_tree::ptree tree;
+  tree.put("type", request_type + 1);
+  tree.put("error", "");
+
+  // and the searches find a device each.
+  boost::property_tree::ptree device;
+  switch (static_cast<MessageType>(request_type)) {
+    case MessageType::kSettingsWebcamSearchRequest:
+      device.put("id", "stand-in-webcam");
+      tree.add_child("webcamList", boost::property_tree::ptree{})
+          .push_back(std::make_pair("", device));
+      break;
+    case MessageType::kSettingsMicSearchRequest:
+      device.put("id", "stand-in-mic");
+      device.put("name", "Stand-In Mic");
+      tree.add_child("micList", boost::property_tree::ptree{})
+          .push_back(std::make_pair("", device));
+      break;
+    default:
+      break;
+  }
+  Send(connection, tree);
+}
+
+
+void StandInServer::PushComments(
+    websocketpp::connection_hdl connection,
+    std::string *cursor) {
+  std::vector<const StandInComment *> comments;
+  for (const auto &comment : comments_) {
+    if (comment.created_time > *cursor) {
+      comments.emplace_back(&comment);
+      *cursor = comment.created_time;
+    }
+  }
+  if (comments.empty() == true) {
+    return;
+  }
+
+  boost::property_tree::ptree tree;
+  tree.put("type", static_cast<int>(MessageType::kStreamingCommentsEvent));
+  tree.put("comments", ToCommentsMessage(comments, ""));
+  Send(connection, tree);
+}
+
+
+std::string StandInServer::ToCommentsMessage(
+    const std::vector<const StandInComment *> &comments,
+    const std::string &fields) {
+  const std::string &listed = "," + fields + ",";
+  auto is_asked = [&fields, &listed](const char *field) {
+    return fields.empty() == true ||
+           listed.find(std::string{","} + field + ",") != std::string::npos;
+  };
+  const bool id_asked = is_asked("id");
+  const bool created_time_asked = is_asked("created_time");
+  const bool message_asked = is_asked("message");
+  const bool from_asked = is_asked("from");
+
+  boost::property_tree::ptree data;
+  for (const StandInComment *comment : comments) {
+    boost::property_tree::ptree item;
+    if (id_asked == true) {
+      item.put("id", comment->id);
+    }
+    if (created_time_asked == true) {
+      item.put("created_time", comment->created_time);
+    }
+    if (message_asked == true) {
+      item.put("message", comment->message);
+    }
+    if (from_asked == true) {
+      item.put("from.name", comment->author);
+    }
+    data.push_back(std::make_pair("", item));
+  }
+  comments_sent_ += static_cast<uint32_t>(comments.size());
+
+  boost::property_tree::ptree tree;
+  tree.add_child("data", data);
+  std::ostringstream ss;
+  boost::property_tree::write_json(ss, tree, false);
+  return ss.str();
+}
+
+
+void StandInServer::Send(
+    websocketpp::connection_hdl connection,
+    const boost::property_tree::ptree &tree) {
+  std::ostringstream ss;
+  boost::property_tree::write_json(ss, tree, false);
+  const std::string &msg = ss.str();
+  bytes_sent_ += msg.size();
+
+  websocketpp::lib::error_code ec;
+  server_.send(connection, msg, websocketpp::frame::opcode::text, ec);
+}
+}  // namespace ncstreamer_remote_test
@@ -0,0 +1,137 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_TEST_SRC_STAND_IN_SERVER_H_
+#define NCSTREAMER_REMOTE_TEST_SRC_STAND_IN_SERVER_H_
+
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "boost/asio/io_service.hpp"
+#include "boost/property_tree/ptree.hpp"
+
+#ifdef _MSC_VER
+#pragma warning(disable: 4267)
+#endif
+#include "websocketpp/config/asio_no_tls.hpp"
+#include "websocketpp/server.hpp"
+#ifdef _MSC_VER
+#pragma warning(default: 4267)
+#endif
+
+#include "Windows.h"  // NOLINT
+
+
+namespace ncstreamer_remote_test {
+struct StandInComment {
+  std::string id;
+  std::string author;
+  std::string message;
+  /// ISO 8601, which orders as a string.
+  std::string created_time;
+};
+
+
+/// A stand-in of NCStreamer on the loopback, on air with the comments
+/// added to it, which it answers and pushes to the subscribed clients.
+/// The webcam and mic searches find one device each.
+/// A comments request is narrowed as NCStreamer does by its "maxCount",
+/// taking the oldest ones after the cursor, "fields", "author"
+/// and "keyword".
+/// It shows a hidden window of the title of NCStreamer,
+/// which the clients look for before connecting.
+/// It runs on a thread of its own.
+class StandInServer {
+ public:
+  explicit StandInServer(uint16_t port);
+  /// Closes every connection.
+  virtual ~StandInServer();
+
+  /// False if the port is taken.
+  bool is_listening() const { return listening_; }
+
+  /// Pushed to every subscribed client on its way in.
+  void AddComment(const StandInComment &comment);
+
+  uint32_t connections() const { return connections_; }
+  uint32_t subscriptions() const { return subscriptions_; }
+  /// Comments requests, as of polling.
+  uint32_t comments_requests() const { return comments_requests_; }
+  /// Comments sent in responses and events.
+  uint32_t comments_sent() const { return comments_sent_; }
+  /// Of the responses and events.
+  uint64_t bytes_sent() const { return bytes_sent_; }
+
+ private:
+  using Server = websocketpp::server<websocketpp::config::asio>;
+  using Connections = std::map<
+      websocketpp::connection_hdl,
+      std::string,  // cursor of the subscription, if any.
+      std::owner_less<websocketpp::connection_hdl>>;
+
+  StandInServer(const StandInServer &) = delete;
+  StandInServer &operator=(const StandInServer &) = delete;
+
+  void OnMessage(
+      websocketpp::connection_hdl connection,
+      Server::message_ptr msg);
+
+  void OnStatusRequest(
+      websocketpp::connection_hdl connection);
+  void OnCommentsRequest(
+      websocketpp::connection_hdl connection,
+      const boost::property_tree::ptree &request);
+  void OnCommentsSubscribeRequest(
+      websocketpp::connection_hdl connection,
+      const boost::property_tree::ptree &request);
+  void OnCommentsUnsubscribeRequest(
+      websocketpp::connection_hdl connection);
+  void OnViewersRequest(
+      websocketpp::connection_hdl connection);
+  void OnOtherRequest(
+      websocketpp::connection_hdl connection,
+      int request_type);
+
+  /// Pushes the comments newer than the cursor of a subscription.
+  void PushComments(
+      websocketpp::connection_hdl connection,
+      std::string *cursor);
+
+  /// JSON of the comments, as NCStreamer passes them through.
+  /// @param fields Comma-separated names of the fields, empty for all.
+  std::string ToCommentsMessage(
+      const std::vector<const StandInComment *> &comments,
+      const std::string &fields);
+
+  void Send(
+      websocketpp::connection_hdl connection,
+      const boost::property_tree::ptree &tree);
+
+  boost::asio::io_service io_service_;
+  Server server_;
+  std::thread thread_;
+  HWND window_;
+  bool listening_;
+
+  /// On the thread of the server only.
+  std::vector<StandInComment> comments_;
+  Connections connections_map_;
+
+  std::atomic_uint connections_;
+  std::atomic_uint subscriptions_;
+  std::atomic_uint comments_requests_;
+  std::atomic_uint comments_sent_;
+  std::atomic<uint64_t> bytes_sent_;
+};
+}  // namespace ncstreamer_remote_test
+
+
+#endif  // NCSTREAMER_REMOTE_TEST_SRC_STAND_IN_SERVER_H_
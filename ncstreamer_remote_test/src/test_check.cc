@@ -0,0 +1,35 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include "ncstreamer_remote_test/src/test_check.h"
+
+#include <atomic>
+#include <iostream>
+
+
+namespace {
+std::atomic_int static_failures{0};
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_test {
+bool Check(
+    bool condition,
+    const char *expression,
+    const char *file,
+    int line) {
+  if (condition == false) {
+    ++static_failures;
+    std::cerr << file << "(" << line << "): check failed: "
+              << expression << std::endl;
+  }
+  return condition;
+}
+
+
+int GetFailures() {
+  return static_failures;
+}
+}  // namespace ncstreamer_remote_test
@@ -0,0 +1,27 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_TEST_SRC_TEST_CHECK_H_
+#define NCSTREAMER_REMOTE_TEST_SRC_TEST_CHECK_H_
+
+
+/// Reports a failed check and goes on with the rest of the test.
+#define NCSTREAMER_REMOTE_TEST_CHECK(condition) \
+    ::ncstreamer_remote_test::Check( \
+        (condition), #condition, __FILE__, __LINE__)
+
+
+namespace ncstreamer_remote_test {
+bool Check(
+    bool condition,
+    const char *expression,
+    const char *file,
+    int line);
+
+int GetFailures();
+}  // namespace ncstreamer_remote_test
+
+
+#endif  // NCSTREAMER_REMOTE_TEST_SRC_TEST_CHECK_H_
@@ -0,0 +1,51 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_TEST_SRC_TEST_MEMORY_RESOURCE_H_
+#define NCSTREAMER_REMOTE_TEST_SRC_TEST_MEMORY_RESOURCE_H_
+
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/memory/memory_resource.h"
+
+
+namespace ncstreamer_remote_test {
+/// Of the clients under test, as a game would hand over its own,
+/// counting what the library draws from it.
+class TestMemoryResource : public ncstreamer_remote::MemoryResource {
+ public:
+  TestMemoryResource()
+      : allocations_{0} {}
+  virtual ~TestMemoryResource() {}
+
+  uint64_t allocations() const { return allocations_; }
+
+ private:
+  TestMemoryResource(const TestMemoryResource &) = delete;
+  TestMemoryResource &operator=(const TestMemoryResource &) = delete;
+
+  void *DoAllocate(std::size_t bytes, std::size_t /*alignment*/) override {
+    ++allocations_;
+    return ::operator new(bytes);
+  }
+
+  void DoDeallocate(
+      void *p, std::size_t /*bytes*/, std::size_t /*alignment*/) override {
+    ::operator delete(p);
+  }
+
+  bool DoIsEqual(const MemoryResource &other) const override {
+    return this == &other;
+  }
+
+  std::atomic<uint64_t> allocations_;
+};
+}  // namespace ncstreamer_remote_test
+
+
+#endif  // NCSTREAMER_REMOTE_TEST_SRC_TEST_MEMORY_RESOURCE_H_
@@ -0,0 +1,27 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#ifndef NCSTREAMER_REMOTE_TEST_SRC_TEST_SUITES_H_
+#define NCSTREAMER_REMOTE_TEST_SRC_TEST_SUITES_H_
+
+
+namespace ncstreamer_remote_test {
+void TestReconnectBackoff();
+void TestChatAnalytics();
+void TestCommentFilter();
+void TestViewerSeries();
+void TestPollSchedule();
+void TestRequestMetrics();
+
+/// Against a stand-in server on the loopback.
+void TestCommentsSubscription();
+void TestCommentsQuery();
+void TestRequestAllocations();
+/// Recorded against a stand-in server, and replayed offline.
+void TestWireReplay();
+}  // namespace ncstreamer_remote_test
+
+
+#endif  // NCSTREAMER_REMOTE_TEST_SRC_TEST_SUITES_H_
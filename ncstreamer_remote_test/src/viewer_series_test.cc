@@ -0,0 +1,204 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <cstdint>
+#include <vector>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/viewer/viewer_series.h"
+#include "ncstreamer_remote_test/src/test_check.h"
+#include "ncstreamer_remote_test/src/test_suites.h"
+
+
+namespace {
+using ncstreamer_remote::ViewerPoint;
+using ncstreamer_remote::ViewerResolution;
+using ncstreamer_remote::ViewerSeries;
+using ncstreamer_remote::ViewerStats;
+
+
+/// On a boundary of every resolution.
+const uint64_t kStartMs{1000 * 10 * 60 * 1000ULL};
+const uint64_t kSecondMs{1000};
+const uint64_t kMinuteMs{60 * 1000};
+
+
+void TestEmpty() {
+  ViewerSeries series;
+  const ViewerStats &stats = series.GetStats(ViewerResolution::kSecond);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.samples == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.min == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.max == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.peak == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      series.GetPoints(ViewerResolution::kMinute).empty() == true);
+}
+
+
+void TestBucketAggregates() {
+  ViewerSeries series;
+  series.Add(kStartMs, 10);
+  series.Add(kStartMs + 300, 30);
+  series.Add(kStartMs + 999, 20);
+  series.Add(kStartMs + kSecondMs, 40);
+
+  const std::vector<ViewerPoint> &points =
+      series.GetPoints(ViewerResolution::kSecond);
+  NCSTREAMER_REMOTE_TEST_CHECK(points.size() == 2);
+  if (points.size() == 2) {
+    NCSTREAMER_REMOTE_TEST_CHECK(points[0].time_ms == kStartMs);
+    NCSTREAMER_REMOTE_TEST_CHECK(points[0].min == 10);
+    NCSTREAMER_REMOTE_TEST_CHECK(points[0].max == 30);
+    NCSTREAMER_REMOTE_TEST_CHECK(points[0].average == 20.0);
+    // the open bucket is a point too.
+    NCSTREAMER_REMOTE_TEST_CHECK(points[1].time_ms == kStartMs + kSecondMs);
+    NCSTREAMER_REMOTE_TEST_CHECK(points[1].average == 40.0);
+  }
+
+  // the same samples fall in one bucket of a coarser resolution.
+  const std::vector<ViewerPoint> &minutes =
+      series.GetPoints(ViewerResolution::kMinute);
+  NCSTREAMER_REMOTE_TEST_CHECK(minutes.size() == 1);
+  if (minutes.size() == 1) {
+    NCSTREAMER_REMOTE_TEST_CHECK(minutes[0].min == 10);
+    NCSTREAMER_REMOTE_TEST_CHECK(minutes[0].max == 40);
+    NCSTREAMER_REMOTE_TEST_CHECK(minutes[0].average == 25.0);
+  }
+}
+
+
+void TestMinuteDownsampling() {
+  ViewerSeries series;
+  // a sample a second for 3 minutes, of the minute times 100 plus 0..59.
+  for (uint64_t second = 0; second < 3 * 60; ++second) {
+    const uint32_t viewers =
+        static_cast<uint32_t>((second / 60) * 100 + second % 60);
+    series.Add(kStartMs + second * kSecondMs, viewers);
+  }
+
+  const std::vector<ViewerPoint> &points =
+      series.GetPoints(ViewerResolution::kMinute);
+  NCSTREAMER_REMOTE_TEST_CHECK(points.size() == 3);
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    NCSTREAMER_REMOTE_TEST_CHECK(points[i].time_ms == kStartMs + i * kMinuteMs);
+    NCSTREAMER_REMOTE_TEST_CHECK(points[i].min == i * 100);
+    NCSTREAMER_REMOTE_TEST_CHECK(points[i].max == i * 100 + 59);
+    NCSTREAMER_REMOTE_TEST_CHECK(points[i].average == i * 100 + 29.5);
+  }
+
+  const ViewerStats &stats = series.GetStats(ViewerResolution::kTenMinutes);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.samples == 180);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.min == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.max == 259);
+}
+
+
+void TestWindowEviction() {
+  ViewerSeries series;
+  // an early peak, then a sample a second of the second, for 400 seconds.
+  series.Add(kStartMs, 5000);
+  for (uint64_t second = 1; second < 400; ++second) {
+    series.Add(kStartMs + second * kSecondMs, static_cast<uint32_t>(second));
+  }
+
+  // the window of 300 seconds ends at the latest sample.
+  const std::vector<ViewerPoint> &points =
+      series.GetPoints(ViewerResolution::kSecond);
+  NCSTREAMER_REMOTE_TEST_CHECK(points.size() == 300);
+  if (points.empty() == false) {
+    NCSTREAMER_REMOTE_TEST_CHECK(
+        points.front().time_ms == kStartMs + 100 * kSecondMs);
+    NCSTREAMER_REMOTE_TEST_CHECK(
+        points.back().time_ms == kStartMs + 399 * kSecondMs);
+  }
+
+  const ViewerStats &stats = series.GetStats(ViewerResolution::kSecond);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.samples == 300);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.min == 100);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.max == 399);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.average == (100 + 399) / 2.0);
+  // the peak outlives the window.
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.peak == 5000);
+
+  // and the coarser windows still hold it.
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      series.GetStats(ViewerResolution::kMinute).max == 5000);
+}
+
+
+void TestExtremesAfterEviction() {
+  ViewerSeries series;
+  // down from 300, then up again, a bucket a second.
+  for (uint64_t second = 0; second < 600; ++second) {
+    const uint32_t viewers = static_cast<uint32_t>(
+        (second < 300) ? 300 - second : second - 300);
+    series.Add(kStartMs + second * kSecondMs, viewers);
+
+    if (second >= 300) {
+      // seconds second-299 to second: the minimum is ever 0 at 300.
+      const ViewerStats &stats = series.GetStats(ViewerResolution::kSecond);
+      NCSTREAMER_REMOTE_TEST_CHECK(stats.min == 0);
+      const uint32_t oldest = 300 - static_cast<uint32_t>(second - 299);
+      const uint32_t newest = viewers;
+      NCSTREAMER_REMOTE_TEST_CHECK(
+          stats.max == ((oldest > newest) ? oldest : newest));
+    }
+  }
+}
+
+
+void TestGapAndLateSample() {
+  ViewerSeries series;
+  series.Add(kStartMs, 10);
+  series.Add(kStartMs + 10 * kSecondMs, 20);
+  // late, so folded into the open bucket.
+  series.Add(kStartMs + 5 * kSecondMs, 60);
+
+  const std::vector<ViewerPoint> &points =
+      series.GetPoints(ViewerResolution::kSecond);
+  NCSTREAMER_REMOTE_TEST_CHECK(points.size() == 2);
+  if (points.size() == 2) {
+    NCSTREAMER_REMOTE_TEST_CHECK(
+        points[1].time_ms == kStartMs + 10 * kSecondMs);
+    NCSTREAMER_REMOTE_TEST_CHECK(points[1].max == 60);
+    NCSTREAMER_REMOTE_TEST_CHECK(points[1].average == 40.0);
+  }
+
+  // a gap past the window leaves the new bucket only.
+  series.Add(kStartMs + 1000 * kSecondMs, 1);
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      series.GetPoints(ViewerResolution::kSecond).size() == 1);
+  const ViewerStats &stats = series.GetStats(ViewerResolution::kSecond);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.samples == 1);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.max == 1);
+}
+
+
+void TestClear() {
+  ViewerSeries series;
+  for (uint64_t second = 0; second < 100; ++second) {
+    series.Add(kStartMs + second * kSecondMs, 7);
+  }
+  series.Clear();
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      series.GetStats(ViewerResolution::kTenMinutes).samples == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      series.GetStats(ViewerResolution::kSecond).peak == 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(
+      series.GetPoints(ViewerResolution::kSecond).empty() == true);
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_test {
+void TestViewerSeries() {
+  TestEmpty();
+  TestBucketAggregates();
+  TestMinuteDownsampling();
+  TestWindowEviction();
+  TestExtremesAfterEviction();
+  TestGapAndLateSample();
+  TestClear();
+}
+}  // namespace ncstreamer_remote_test
@@ -0,0 +1,174 @@
+/**
+ * Copyright (C) 2017 NCSOFT Corporation
+ */
+
+
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdio>
+#include <future>  // NOLINT
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/ncstreamer_remote.h"
+#include "ncstreamer_remote_dll/include/ncstreamer_remote/wire/wire_recording.h"
+#include "ncstreamer_remote_test/src/stand_in_server.h"
+#include "ncstreamer_remote_test/src/test_check.h"
+#include "ncstreamer_remote_test/src/test_memory_resource.h"
+#include "ncstreamer_remote_test/src/test_suites.h"
+
+
+namespace {
+using ncstreamer_remote::CommentRecords;
+using ncstreamer_remote::ErrorCategory;
+using ncstreamer_remote::NcStreamerRemote;
+using ncstreamer_remote::WireReplayStats;
+using ncstreamer_remote_test::StandInComment;
+using ncstreamer_remote_test::StandInServer;
+using ncstreamer_remote_test::TestMemoryResource;
+
+
+const uint16_t kStandInPort{9110};
+const std::chrono::seconds kTimeout{5};
+const char *const kRecordingPath{"ncstreamer_remote_test.ncswire"};
+
+
+/// The ids of the comments reaching a handler, from any thread.
+class ReceivedComments {
+ public:
+  ReceivedComments()
+      : mutex_{},
+        arrived_{},
+        ids_{} {}
+
+  void Add(const CommentRecords &comments) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    for (const auto &comment : comments) {
+      ids_.emplace_back(comment.id);
+    }
+    arrived_.notify_all();
+  }
+
+  bool WaitFor(std::size_t count) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    return arrived_.wait_for(lock, kTimeout, [this, count]() {
+      return ids_.size() >= count;
+    });
+  }
+
+  std::vector<std::wstring> ids() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return ids_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable arrived_;
+  std::vector<std::wstring> ids_;
+};
+
+
+bool Subscribe(NcStreamerRemote *remote) {
+  auto succeeded = std::make_shared<std::promise<bool>>();
+  remote->RequestCommentsSubscribe(L"", [succeeded](
+      ErrorCategory /*err_category*/,
+      int /*err_code*/,
+      const std::wstring &/*err_msg*/) {
+    succeeded->set_value(false);
+  }, [succeeded](bool success) {
+    succeeded->set_value(success);
+  });
+  auto future = succeeded->get_future();
+  return future.wait_for(kTimeout) == std::future_status::ready &&
+         future.get() == true;
+}
+
+
+StandInComment NewComment(int index) {
+  const std::string &number = std::to_string(index);
+  return StandInComment{
+      "comment-" + number,
+      "viewer",
+      "hello " + number,
+      "2017-06-01T12:00:0" + number + "+0000"};
+}
+
+
+/// Records the comments pushed live, into `live`.
+/// @return The comments cursor of the live client.
+std::wstring RecordLive(
+    StandInServer *server,
+    TestMemoryResource *memory_resource,
+    ReceivedComments *live) {
+  NcStreamerRemote *remote = NcStreamerRemote::Create(
+      kStandInPort, memory_resource, nullptr, "");
+  remote->RegisterCommentRecordsEventHandler(
+      [live](const CommentRecords &comments) {
+    live->Add(comments);
+  });
+  NCSTREAMER_REMOTE_TEST_CHECK(remote->StartWireRecording(kRecordingPath));
+
+  NCSTREAMER_REMOTE_TEST_CHECK(Subscribe(remote));
+  server->AddComment(NewComment(1));
+  server->AddComment(NewComment(2));
+  server->AddComment(NewComment(3));
+  NCSTREAMER_REMOTE_TEST_CHECK(live->WaitFor(3));
+  remote->StopWireRecording();
+
+  // a connecting client is left alone.
+  const WireReplayStats &refused =
+      remote->ReplayWireRecording(kRecordingPath, false);
+  NCSTREAMER_REMOTE_TEST_CHECK(refused.frames == 0);
+
+  const std::wstring &cursor = remote->GetCommentsCursor();
+  NcStreamerRemote::Destroy(remote);
+  return cursor;
+}
+
+
+void TestReplayedToHandlers(
+    TestMemoryResource *memory_resource,
+    ReceivedComments *live,
+    const std::wstring &live_cursor) {
+  NcStreamerRemote *offline =
+      NcStreamerRemote::CreateOffline(memory_resource, nullptr);
+  ReceivedComments replayed;
+  offline->RegisterCommentRecordsEventHandler(
+      [&replayed](const CommentRecords &comments) {
+    replayed.Add(comments);
+  });
+
+  const WireReplayStats &stats =
+      offline->ReplayWireRecording(kRecordingPath, false);
+  // the subscribe response and at least an event.
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.frames >= 2);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.bytes != 0);
+  NCSTREAMER_REMOTE_TEST_CHECK(stats.failures == 0);
+
+  // dispatched already, as the replay blocks until done.
+  NCSTREAMER_REMOTE_TEST_CHECK(replayed.ids() == live->ids());
+  NCSTREAMER_REMOTE_TEST_CHECK(offline->GetCommentsCursor() == live_cursor);
+
+  NcStreamerRemote::Destroy(offline);
+}
+}  // unnamed namespace
+
+
+namespace ncstreamer_remote_test {
+void TestWireReplay() {
+  StandInServer server{kStandInPort};
+  NCSTREAMER_REMOTE_TEST_CHECK(server.is_listening() == true);
+  if (server.is_listening() == false) {
+    return;
+  }
+
+  TestMemoryResource memory_resource;
+  ReceivedComments live;
+  const std::wstring &live_cursor =
+      RecordLive(&server, &memory_resource, &live);
+  TestReplayedToHandlers(&memory_resource, &live, live_cursor);
+
+  std::remove(kRecordingPath);
+}
+}  // namespace ncstreamer_remote_test